@@ -134,6 +134,28 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  #include <stddef.h>
+  #include "pyro_core_config.h"
+  #if PYRO_STATIC_ALLOC_EN || PYRO_MEM_TRACE_EN
+    /* Heap lock and allocation trace (pyro_heap_guard.c); the return address
+       is the caller of pvPortMalloc, since the macro expands inside it */
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+    void vPortHeapOnMalloc( void *pv, size_t xSize, void *pvCaller );
+    void vPortHeapOnFree( void *pv, size_t xSize );
+    #ifdef __cplusplus
+    }
+    #endif
+    #define traceMALLOC( pvAddress, uiSize ) vPortHeapOnMalloc( pvAddress, uiSize, __builtin_return_address( 0 ) )
+    #define traceFREE( pvAddress, uiSize ) vPortHeapOnFree( pvAddress, uiSize )
+  #endif
+  #if PYRO_MEM_TRACE_EN
+    /* uxTaskGetSystemState() for the per-task stack report */
+    #define configUSE_TRACE_FACILITY 1
+  #endif
+#endif
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -28,6 +28,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "pyro_core_config.h"
 
 /* USER CODE END Includes */
 
@@ -72,6 +73,11 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+#if PYRO_DCACHE_EN
+  /* DMA buffers are kept coherent by pyro::dma_buffer_t */
+  SCB_EnableICache();
+  SCB_EnableDCache();
+#endif
 
   /* USER CODE END 1 */
 
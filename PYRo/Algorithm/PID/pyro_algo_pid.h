@@ -16,6 +16,8 @@
 #define __PYRO_ALGO_PID_H__
 
 #include "pyro_algo_ols.h" // For pyro::ols_t
+#include "pyro_core_config.h"
+#include "pyro_pool.h" // For pyro::pool_new_t
 #include <cstdint>
 
 namespace pyro
@@ -26,9 +28,10 @@ namespace pyro
  *
  * Encapsulates PID logic, state, and optional improvements.
  * Automatically uses `dwt_drv_t` for time delta and `ols_t` for
- * derivative calculation if specified.
+ * derivative calculation if specified. Instances created with `new` come
+ * from a fixed pool of PYRO_POOL_PID_NUM slots (see `pool_new_t`).
  */
-class pid_t
+class pid_t : public pool_new_t<pid_t, PYRO_POOL_PID_NUM>
 {
   public:
     /**
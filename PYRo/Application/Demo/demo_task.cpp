@@ -9,6 +9,7 @@
  */
 #include "cmsis_os.h"
 #include "pyro_core_config.h"
+#include "pyro_static_alloc.h"
 #include "task.h"
 
 
@@ -27,36 +28,44 @@ extern "C"
 #if DEMO_MODE
 
 #if RC_DEMO_EN
-        xTaskCreate(pyro_rc_demo, "pyro_rc_demo", 128, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<128> rc_demo_storage;
+        rc_demo_storage.create(pyro_rc_demo, "pyro_rc_demo", nullptr,
+                               configMAX_PRIORITIES - 2);
 #endif
 #if MOTOR_DEMO_EN
-        xTaskCreate(pyro_motor_demo, "pyro_motor_demo", 512, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<512> motor_demo_storage;
+        motor_demo_storage.create(pyro_motor_demo, "pyro_motor_demo", nullptr,
+                                  configMAX_PRIORITIES - 2);
 #endif
 #if CONTROL_DEMO_EN
-        xTaskCreate(pyro_control_demo, "pyro_control_demo", 512, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<512> control_demo_storage;
+        control_demo_storage.create(pyro_control_demo, "pyro_control_demo",
+                                    nullptr, configMAX_PRIORITIES - 2);
 #endif
 
 
 #if CONTROLLER_DEMO_EN
-        xTaskCreate(pyro_controller_demo, "pyro_controller_demo", 512, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<512> controller_demo_storage;
+        controller_demo_storage.create(pyro_controller_demo,
+                                       "pyro_controller_demo", nullptr,
+                                       configMAX_PRIORITIES - 2);
 #endif
 
 #if SHOOT_DEMO_EN
-        xTaskCreate(pyro_shoot_demo, "pyro_shoot_demo", 512, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<512> shoot_demo_storage;
+        shoot_demo_storage.create(pyro_shoot_demo, "pyro_shoot_demo", nullptr,
+                                  configMAX_PRIORITIES - 2);
 #endif
 #if IMU_DEMO_EN
-        xTaskCreate(IMU_task, "IMU_task", 512, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<512> imu_task_storage;
+        imu_task_storage.create(IMU_task, "IMU_task", nullptr,
+                                configMAX_PRIORITIES - 2);
 #endif
 
 #if REFEREE_DEMO_EN
-        xTaskCreate(referee_task, "referee_task", 512, nullptr,
-                    configMAX_PRIORITIES - 2, nullptr);
+        static pyro::task_storage_t<512> referee_task_storage;
+        referee_task_storage.create(referee_task, "referee_task", nullptr,
+                                    configMAX_PRIORITIES - 2);
 #endif
 
 #endif
@@ -50,98 +50,123 @@ extern "C"
 
     void pyro_control_demo(void *arg)
     {
-        speed_pid_1 = new pyro::pid_ctrl_t(24.0f, 0.1f, 0.00f);
-        speed_pid_2 = new pyro::pid_ctrl_t(24.0f, 0.1f, 0.00f);
-        speed_pid_3 = new pyro::pid_ctrl_t(20.0f, 0.1f, 0.00f);
-        speed_pid_4 = new pyro::pid_ctrl_t(20.0f, 0.1f, 0.00f);
+        static pyro::pid_ctrl_t speed_pid_1_obj(24.0f, 0.1f, 0.00f);
+        speed_pid_1 = &speed_pid_1_obj;
+        static pyro::pid_ctrl_t speed_pid_2_obj(24.0f, 0.1f, 0.00f);
+        speed_pid_2 = &speed_pid_2_obj;
+        static pyro::pid_ctrl_t speed_pid_3_obj(20.0f, 0.1f, 0.00f);
+        speed_pid_3 = &speed_pid_3_obj;
+        static pyro::pid_ctrl_t speed_pid_4_obj(20.0f, 0.1f, 0.00f);
+        speed_pid_4 = &speed_pid_4_obj;
 
         speed_pid_1->set_output_limits(100.0f);
         speed_pid_2->set_output_limits(100.0f);
         speed_pid_3->set_output_limits(100.0f);
         speed_pid_4->set_output_limits(100.0f);
 
-        rudder_position_pid_1 = new pyro::pid_ctrl_t(20.0f, 0.0f, 0.00f);
-        rudder_position_pid_2 = new pyro::pid_ctrl_t(20.0f, 0.0f, 0.00f);
-        rudder_rotate_pid_1 = new pyro::pid_ctrl_t(0.3f, 0.0f, 0.00f);
-        rudder_rotate_pid_2 = new pyro::pid_ctrl_t(0.3f, 0.0f, 0.00f);
+        static pyro::pid_ctrl_t rudder_position_pid_1_obj(20.0f, 0.0f, 0.00f);
+        rudder_position_pid_1 = &rudder_position_pid_1_obj;
+        static pyro::pid_ctrl_t rudder_position_pid_2_obj(20.0f, 0.0f, 0.00f);
+        rudder_position_pid_2 = &rudder_position_pid_2_obj;
+        static pyro::pid_ctrl_t rudder_rotate_pid_1_obj(0.3f, 0.0f, 0.00f);
+        rudder_rotate_pid_1 = &rudder_rotate_pid_1_obj;
+        static pyro::pid_ctrl_t rudder_rotate_pid_2_obj(0.3f, 0.0f, 0.00f);
+        rudder_rotate_pid_2 = &rudder_rotate_pid_2_obj;
 
         rudder_position_pid_1->set_output_limits(1000.0f);
         rudder_position_pid_2->set_output_limits(1000.0f);
         rudder_rotate_pid_1->set_output_limits(3.0f);
         rudder_rotate_pid_2->set_output_limits(3.0f);
 
-        yaw_position_pid_1 = new pyro::pid_ctrl_t(20.0f, 0.0f, 0.00f);
-        yaw_rotate_pid_1 = new pyro::pid_ctrl_t(0.1f, 0.0f, 0.00f);
+        static pyro::pid_ctrl_t yaw_position_pid_1_obj(20.0f, 0.0f, 0.00f);
+        yaw_position_pid_1 = &yaw_position_pid_1_obj;
+        static pyro::pid_ctrl_t yaw_rotate_pid_1_obj(0.1f, 0.0f, 0.00f);
+        yaw_rotate_pid_1 = &yaw_rotate_pid_1_obj;
         yaw_position_pid_1->set_output_limits(1000.0f);
         yaw_rotate_pid_1->set_output_limits(3.0f);
         
-        m3508_drv_1 = new pyro::dji_m3508_motor_drv_t(
+        static pyro::dji_m3508_motor_drv_t m3508_drv_1_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can2);
-        m3508_drv_2 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_1 = &m3508_drv_1_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_2_obj(
             pyro::dji_motor_tx_frame_t::id_3, pyro::can_hub_t::can2);
-        m3508_drv_3 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_2 = &m3508_drv_2_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_3_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can1);
-        m3508_drv_4 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_3 = &m3508_drv_3_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_4_obj(
             pyro::dji_motor_tx_frame_t::id_2, pyro::can_hub_t::can1);
+        m3508_drv_4 = &m3508_drv_4_obj;
 
-        gm6020_drv_1 = new pyro::dji_gm_6020_motor_drv_t(
+        static pyro::dji_gm_6020_motor_drv_t gm6020_drv_1_obj(
             pyro::dji_motor_tx_frame_t::id_3, pyro::can_hub_t::can2);
-        gm6020_drv_2 = new pyro::dji_gm_6020_motor_drv_t(
+        gm6020_drv_1 = &gm6020_drv_1_obj;
+        static pyro::dji_gm_6020_motor_drv_t gm6020_drv_2_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can1);
-        gm6020_drv_3 = new pyro::dji_gm_6020_motor_drv_t(
+        gm6020_drv_2 = &gm6020_drv_2_obj;
+        static pyro::dji_gm_6020_motor_drv_t gm6020_drv_3_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can2);
+        gm6020_drv_3 = &gm6020_drv_3_obj;
 
-        wheel_drv_1 = new pyro::wheel_drv_t(
+        static pyro::wheel_drv_t wheel_drv_1_obj(
             m3508_drv_1,
             *speed_pid_1,
             0.0685f);
+        wheel_drv_1 = &wheel_drv_1_obj;
 
-        wheel_drv_2 = new pyro::wheel_drv_t(
+        static pyro::wheel_drv_t wheel_drv_2_obj(
             m3508_drv_2,
             *speed_pid_2,
             0.06f);
+        wheel_drv_2 = &wheel_drv_2_obj;
 
-        wheel_drv_3 = new pyro::wheel_drv_t(
+        static pyro::wheel_drv_t wheel_drv_3_obj(
            m3508_drv_3,
             *speed_pid_3,
             0.06f);
+        wheel_drv_3 = &wheel_drv_3_obj;
         
-        wheel_drv_4 = new pyro::wheel_drv_t(
+        static pyro::wheel_drv_t wheel_drv_4_obj(
             m3508_drv_4,
             *speed_pid_4,
             0.0685f);
+        wheel_drv_4 = &wheel_drv_4_obj;
 
         wheel_drv_1->set_gear_ratio(19.0f);
         wheel_drv_2->set_gear_ratio(19.0f);
         wheel_drv_3->set_gear_ratio(19.0f);
         wheel_drv_4->set_gear_ratio(19.0f);
 
-        steering_wheel_drv_1 = new pyro::steering_wheel_drv_t(
+        static pyro::steering_wheel_drv_t steering_wheel_drv_1_obj(
             wheel_drv_2,
             gm6020_drv_1,
             *rudder_rotate_pid_1,
             *rudder_position_pid_1);
+        steering_wheel_drv_1 = &steering_wheel_drv_1_obj;
 
-        steering_wheel_drv_2 = new pyro::steering_wheel_drv_t(
+        static pyro::steering_wheel_drv_t steering_wheel_drv_2_obj(
             wheel_drv_3,
             gm6020_drv_2,
             *rudder_rotate_pid_2,
             *rudder_position_pid_2);
+        steering_wheel_drv_2 = &steering_wheel_drv_2_obj;
 
-        yaw_drv_1 = new pyro::yaw_drv_t(
+        static pyro::yaw_drv_t yaw_drv_1_obj(
             gm6020_drv_3,
             *yaw_rotate_pid_1,
             *yaw_position_pid_1);
+        yaw_drv_1 = &yaw_drv_1_obj;
 
         steering_wheel_drv_1->set_offset_radian(0.959505022f);
         steering_wheel_drv_2->set_offset_radian(4.52447653f);
         yaw_drv_1->set_offset_radian(0.48397094f);
 
-        chassis_drv = new pyro::chassis_drv_t(
+        static pyro::chassis_drv_t chassis_drv_obj(
             steering_wheel_drv_1,
             steering_wheel_drv_2,
             wheel_drv_1,
             wheel_drv_4);
+        chassis_drv = &chassis_drv_obj;
 
         while (true)
         {
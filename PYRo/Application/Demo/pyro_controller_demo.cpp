@@ -16,10 +16,6 @@
 
 extern "C"
 {
-    pyro::can_drv_t *can1_drv;
-    pyro::can_drv_t *can2_drv;
-    pyro::can_drv_t *can3_drv;
-
     pyro::position_controller_t *ctrl;
     pyro::dm_motor_drv_t *motor;
     pyro::pid_ctrl_t *spd_pid,*pos_pid;
@@ -31,38 +27,34 @@ extern "C"
     void pyro_controller_demo(void *arg)
     {
         pyro::get_uart5().enable_rx_dma();
-        dr16_drv = new pyro::dr16_drv_t(&pyro::get_uart5());
+        static pyro::dr16_drv_t dr16_drv_obj(&pyro::get_uart5());
+        dr16_drv = &dr16_drv_obj;
         dr16_drv->init();
         dr16_drv->enable();
 
 
+        // The CAN drivers are created and started by pyro_init_thread
         pyro::can_hub_t::get_instance();
-        can1_drv = new pyro::can_drv_t(&hfdcan1);
-        can2_drv = new pyro::can_drv_t(&hfdcan2);
-        can3_drv = new pyro::can_drv_t(&hfdcan3);
-
-        can1_drv->init();
-        can2_drv->init();
-        can3_drv->init();
-        can1_drv->start();
-        can2_drv->start();  
-        can3_drv->start();
-
-        motor = new pyro::dm_motor_drv_t(0x5, 0x4, pyro::can_hub_t::can1);
+
+        static pyro::dm_motor_drv_t motor_obj(0x5, 0x4, pyro::can_hub_t::can1);
+        motor = &motor_obj;
         motor->set_position_range(-pyro::PI, pyro::PI);
         motor->set_rotate_range(-20, 20);
         motor->set_torque_range(-10, 10);
         
-        spd_pid   = new pyro::pid_ctrl_t(1.0f, 0.1f, 0.0f);
+        static pyro::pid_ctrl_t spd_pid_obj(1.0f, 0.1f, 0.0f);
+        spd_pid = &spd_pid_obj;
         spd_pid->set_output_limits(10.0f);
         spd_pid->set_integral_limits(5.0f);
 
-        pos_pid   = new pyro::pid_ctrl_t(1.6f, 0.0f, 0.0f);
+        static pyro::pid_ctrl_t pos_pid_obj(1.6f, 0.0f, 0.0f);
+        pos_pid = &pos_pid_obj;
         pos_pid->set_output_limits(20.0f);
         pos_pid->set_integral_limits(5.0f);
 
-        ctrl  = new pyro::position_controller_t(
+        static pyro::position_controller_t ctrl_obj(
             motor, pos_pid, spd_pid);
+        ctrl = &ctrl_obj;
         ctrl->set_target(-1.0f);
         vTaskDelay(1000);
         motor->enable();
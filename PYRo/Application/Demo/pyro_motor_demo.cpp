@@ -10,10 +10,6 @@
 
 extern "C"
 {
-    pyro::can_drv_t *can1_drv;
-    pyro::can_drv_t *can2_drv;
-    pyro::can_drv_t *can3_drv;
-
     std::array<uint8_t, 8> can1_data;
     std::array<uint8_t, 8> can2_data;
 
@@ -30,30 +26,25 @@ extern "C"
 
     void pyro_motor_demo(void *arg)
     {
+        // The CAN drivers are created and started by pyro_init_thread
         pyro::can_hub_t::get_instance();
-        can1_drv = new pyro::can_drv_t(&hfdcan1);
-        can2_drv = new pyro::can_drv_t(&hfdcan2);
-        can3_drv = new pyro::can_drv_t(&hfdcan3);
-
-        can1_drv->init();
-        can2_drv->init();
-        can3_drv->init();
-
-        can1_drv->start();
-        can2_drv->start();
-        can3_drv->start();
 
-        m3508_drv_1 = new pyro::dji_m3508_motor_drv_t(
+        static pyro::dji_m3508_motor_drv_t m3508_drv_1_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can2);
-        m3508_drv_2 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_1 = &m3508_drv_1_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_2_obj(
             pyro::dji_motor_tx_frame_t::id_3, pyro::can_hub_t::can2);
-        m3508_drv_3 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_2 = &m3508_drv_2_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_3_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can1);
-        m3508_drv_4 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_3 = &m3508_drv_3_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_4_obj(
             pyro::dji_motor_tx_frame_t::id_2, pyro::can_hub_t::can1);
+        m3508_drv_4 = &m3508_drv_4_obj;
 
         //dm_drv = new pyro::dm_motor_drv_t(0x10, 0x20, pyro::can_hub_t::can1);
-        dm_drv = new pyro::dm_motor_drv_t(0x5, 0x4, pyro::can_hub_t::can1);
+        static pyro::dm_motor_drv_t dm_drv_obj(0x5, 0x4, pyro::can_hub_t::can1);
+        dm_drv = &dm_drv_obj;
         dm_drv->set_position_range(-pyro::PI, pyro::PI);
         dm_drv->set_rotate_range(-20, 20);
         dm_drv->set_torque_range(-10, 10);
@@ -31,10 +31,14 @@ extern "C"
 
     void pyro_shoot_demo(void *arg)
     { 
-        fric1_speed_pid = new pyro::pid_ctrl_t(12.0f, 0.0f, 0.0f);
-        fric2_speed_pid = new pyro::pid_ctrl_t(12.0f, 0.0f, 0.0f);
-        trigger_speed_pid = new pyro::pid_ctrl_t(6.0f, 80.0f, 0.0004f);
-        trigger_positon_pid = new pyro::pid_ctrl_t(7.0f, 0.0f, 0.0f);
+        static pyro::pid_ctrl_t fric1_speed_pid_obj(12.0f, 0.0f, 0.0f);
+        fric1_speed_pid = &fric1_speed_pid_obj;
+        static pyro::pid_ctrl_t fric2_speed_pid_obj(12.0f, 0.0f, 0.0f);
+        fric2_speed_pid = &fric2_speed_pid_obj;
+        static pyro::pid_ctrl_t trigger_speed_pid_obj(6.0f, 80.0f, 0.0004f);
+        trigger_speed_pid = &trigger_speed_pid_obj;
+        static pyro::pid_ctrl_t trigger_positon_pid_obj(7.0f, 0.0f, 0.0f);
+        trigger_positon_pid = &trigger_positon_pid_obj;
 
         trigger_speed_pid->set_integral_limits(0.01f);
         trigger_positon_pid->set_integral_limits(1000.0f);
@@ -45,31 +49,37 @@ extern "C"
         trigger_positon_pid->set_output_limits(20.0f);
 
 
-        m3508_drv_1 = new pyro::dji_m3508_motor_drv_t(
+        static pyro::dji_m3508_motor_drv_t m3508_drv_1_obj(
             pyro::dji_motor_tx_frame_t::id_1, pyro::can_hub_t::can2);
-        m3508_drv_2 = new pyro::dji_m3508_motor_drv_t(
+        m3508_drv_1 = &m3508_drv_1_obj;
+        static pyro::dji_m3508_motor_drv_t m3508_drv_2_obj(
             pyro::dji_motor_tx_frame_t::id_2, pyro::can_hub_t::can2);
-        m2006_drv = new pyro::dji_m2006_motor_drv_t(
+        m3508_drv_2 = &m3508_drv_2_obj;
+        static pyro::dji_m2006_motor_drv_t m2006_drv_obj(
             pyro::dji_motor_tx_frame_t::id_3, pyro::can_hub_t::can2);
+        m2006_drv = &m2006_drv_obj;
 
-        fric_drv_1 = new pyro::fric_drv_t(
+        static pyro::fric_drv_t fric_drv_1_obj(
             m3508_drv_1, 
             *fric1_speed_pid,
             FRIC_RADIUS,
             pyro::fric_drv_t::CLOCKWISE);
+        fric_drv_1 = &fric_drv_1_obj;
 
-        fric_drv_2 = new pyro::fric_drv_t(
+        static pyro::fric_drv_t fric_drv_2_obj(
             m3508_drv_2, 
             *fric2_speed_pid,
             FRIC_RADIUS,
             pyro::fric_drv_t::COUNTERCLOCKWISE);
+        fric_drv_2 = &fric_drv_2_obj;
 
-        trigger_drv = new pyro::trigger_drv_t(
+        static pyro::trigger_drv_t trigger_drv_obj(
             m2006_drv,
             *trigger_speed_pid,
             *trigger_positon_pid,
             STEP,
             pyro::trigger_drv_t::DOWN);
+        trigger_drv = &trigger_drv_obj;
 
         fric_drv_1->set_dt(0.001f);
         fric_drv_2->set_dt(0.001f);
@@ -77,11 +87,12 @@ extern "C"
         trigger_drv->set_dt(0.001f);
         trigger_drv->set_gear_ratio(36.0f);
 
-        shoot_drv = new pyro::shoot_17mm_control_t(
+        static pyro::shoot_17mm_control_t shoot_drv_obj(
             trigger_drv,
             fric_drv_1,
             fric_drv_2
             );
+        shoot_drv = &shoot_drv_obj;
 
         shoot_drv->set_continuous_mode_delay(20);
         shoot_drv->set_fric_speed(23.0f);
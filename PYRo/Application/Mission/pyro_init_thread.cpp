@@ -1,6 +1,18 @@
 #include "pyro_can_drv.h"
+#include "pyro_can_monitor.h"
+#include "pyro_core_config.h"
 #include "pyro_rc_hub.h"
 #include "pyro_dwt_drv.h"
+#include "pyro_heap_guard.h"
+#if MEM_REPORT_DEBUG_EN
+#include "pyro_mem_report.h"
+#endif
+#if VOFA_DEBUG_EN
+#include "pyro_vofa.h"
+#endif
+#if JCOM_DEBUG_EN
+#include "pyro_jcom.h"
+#endif
 
 extern "C"
 {
@@ -12,8 +24,9 @@ extern "C"
     {
         pyro::dwt_drv_t::init(480); // Initialize DWT at 480 MHz
 
+        // UART1 carries the referee stream: receive it into a circular ring
         pyro::uart_drv_t::get_instance(pyro::uart_drv_t::uart1)
-            ->enable_rx_dma();
+            ->enable_rx_circular(UART1_RX_RING_SIZE);
         pyro::uart_drv_t::get_instance(pyro::uart_drv_t::uart5)
             ->enable_rx_dma();
         pyro::uart_drv_t::get_instance(pyro::uart_drv_t::uart7)
@@ -25,16 +38,37 @@ extern "C"
         pyro::rc_hub_t::get_instance(pyro::rc_hub_t::VT03)->enable();
 
         pyro::can_hub_t::get_instance();
-        can1_drv = new pyro::can_drv_t(&hfdcan1);
-        can2_drv = new pyro::can_drv_t(&hfdcan2);
-        can3_drv = new pyro::can_drv_t(&hfdcan3);
+        static pyro::can_drv_t can1(&hfdcan1);
+        static pyro::can_drv_t can2(&hfdcan2);
+        static pyro::can_drv_t can3(&hfdcan3);
+        can1_drv = &can1;
+        can2_drv = &can2;
+        can3_drv = &can3;
         can1_drv->init();
         can2_drv->init();
         can3_drv->init();
         can1_drv->start();
         can2_drv->start();
         can3_drv->start();
+        pyro::can_monitor_t::get_instance()->start();
+
+#if PYRO_STATIC_ALLOC_EN
+        // Singletons are built on first use, which may come after the lock;
+        // the ones that allocate in their constructor are built here. A
+        // chassis_base_t must be constructed and start()ed here as well
+#if MEM_REPORT_DEBUG_EN
+        pyro::mem_report_t::get_instance();
+#endif
+#if VOFA_DEBUG_EN
+        pyro::vofa_drv_t::get_instance();
+#endif
+#if JCOM_DEBUG_EN
+        pyro::jcom_drv_t::get_instance();
+#endif
 
+        // Everything is in place: from here on the heap must not be touched
+        vPortHeapLock();
+#endif
         vTaskDelete(nullptr);
     }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "cmsis_os.h"
+#include "pyro_static_alloc.h"
 
 extern "C"
 {
@@ -6,8 +7,9 @@ extern "C"
 
     void start_mission_planer_task(void const *argument)
     {
-        xTaskCreate(pyro_init_thread, "pyro_init_thread", 512, nullptr,
-                    configMAX_PRIORITIES - 1, nullptr);
+        static pyro::task_storage_t<512> init_thread_storage;
+        init_thread_storage.create(pyro_init_thread, "pyro_init_thread",
+                                   nullptr, configMAX_PRIORITIES - 1);
         vTaskDelete(nullptr);
     }
 }
\ No newline at end of file
@@ -1,88 +1,247 @@
 #include "cstdint"
+#include "cstring"
 
+#include "pyro_core_config.h"
 #include "pyro_crc.h"
 
+#if PYRO_CRC_HW_EN
+#include "FreeRTOS.h"
+#include "stm32h7xx_hal.h"
+#include "stm32h7xx_ll_crc.h"
+#endif
 
-static uint16_t get_crc16_check_sum(uint8_t const*p_msg, uint16_t len,
-                                    uint16_t crc16);
-
-static uint16_t crc16_init           = 0xffff;
-static const uint16_t crc16_tab[256] = {
-    0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf, 0x8c48,
-    0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7, 0x1081, 0x0108,
-    0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e, 0x9cc9, 0x8d40, 0xbfdb,
-    0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876, 0x2102, 0x308b, 0x0210, 0x1399,
-    0x6726, 0x76af, 0x4434, 0x55bd, 0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e,
-    0xfae7, 0xc87c, 0xd9f5, 0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e,
-    0x54b5, 0x453c, 0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd,
-    0xc974, 0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
-    0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3, 0x5285,
-    0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a, 0xdecd, 0xcf44,
-    0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72, 0x6306, 0x728f, 0x4014,
-    0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9, 0xef4e, 0xfec7, 0xcc5c, 0xddd5,
-    0xa96a, 0xb8e3, 0x8a78, 0x9bf1, 0x7387, 0x620e, 0x5095, 0x411c, 0x35a3,
-    0x242a, 0x16b1, 0x0738, 0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862,
-    0x9af9, 0x8b70, 0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e,
-    0xf0b7, 0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
-    0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036, 0x18c1,
-    0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e, 0xa50a, 0xb483,
-    0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5, 0x2942, 0x38cb, 0x0a50,
-    0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd, 0xb58b, 0xa402, 0x9699, 0x8710,
-    0xf3af, 0xe226, 0xd0bd, 0xc134, 0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7,
-    0x6e6e, 0x5cf5, 0x4d7c, 0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1,
-    0xa33a, 0xb2b3, 0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72,
-    0x3efb, 0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
-    0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a, 0xe70e,
-    0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1, 0x6b46, 0x7acf,
-    0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9, 0xf78f, 0xe606, 0xd49d,
-    0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330, 0x7bc7, 0x6a4e, 0x58d5, 0x495c,
-    0x3de3, 0x2c6a, 0x1ef1, 0x0f78};
-
+namespace pyro
+{
+/* Tables --------------------------------------------------------------------*/
 /**
- * @brief Get the crc16 checksum
+ * @brief Slice-by-N lookup tables of a reflected CRC.
  *
- * @param p_msg Data to check
- * @param len Data length
- * @param crc16 Crc16 initialized checksum
- * @return crc16 Crc16 checksum
+ * `t[0]` is the classic bytewise table; `t[k][b]` is the CRC of byte `b`
+ * followed by `k` zero bytes, so N bytes fold into one CRC update.
  */
-static uint16_t get_crc16_check_sum(uint8_t const *p_msg, uint16_t len,
-                                    uint16_t crc16)
+template <typename T, size_t SLICES> struct crc_table_t
 {
-    uint8_t data;
+    T t[SLICES][256];
+};
 
-    if (p_msg == nullptr)
+template <typename T, size_t SLICES>
+static constexpr crc_table_t<T, SLICES> crc_make_table(const T rpoly)
+{
+    crc_table_t<T, SLICES> tab{};
+    for (uint32_t b = 0; b < 256; b++)
     {
-        return 0xffff;
+        T crc = static_cast<T>(b);
+        for (int k = 0; k < 8; k++)
+        {
+            crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ rpoly)
+                            : static_cast<T>(crc >> 1);
+        }
+        tab.t[0][b] = crc;
+    }
+    for (size_t s = 1; s < SLICES; s++)
+    {
+        for (uint32_t b = 0; b < 256; b++)
+        {
+            const T prev = tab.t[s - 1][b];
+            tab.t[s][b] =
+                static_cast<T>((prev >> 8) ^ tab.t[0][prev & 0xff]);
+        }
+    }
+    return tab;
+}
+
+static_assert(PYRO_CRC_SLICE == 1 || PYRO_CRC_SLICE == 4 ||
+                  PYRO_CRC_SLICE == 8,
+              "PYRO_CRC_SLICE must be 1, 4 or 8");
+
+// x^8 + x^5 + x^4 + 1 and x^16 + x^12 + x^5 + 1, both bit-reflected
+static constexpr auto crc8_table =
+    crc_make_table<uint8_t, PYRO_CRC_SLICE>(0x8c);
+static constexpr auto crc16_table =
+    crc_make_table<uint16_t, PYRO_CRC_SLICE>(0x8408);
+
+static_assert(crc8_table.t[0][1] == 0x5e && crc8_table.t[0][255] == 0x35,
+              "crc8 table");
+static_assert(crc16_table.t[0][1] == 0x1189 &&
+                  crc16_table.t[0][255] == 0x0f78,
+              "crc16 table");
+
+/* Software kernel -----------------------------------------------------------*/
+template <typename T, size_t SLICES>
+static T crc_slice(const crc_table_t<T, SLICES> &tab, const uint8_t *p,
+                   size_t len, T crc)
+{
+    if constexpr (SLICES > 1)
+    {
+        while (len >= SLICES)
+        {
+            uint8_t b[SLICES];
+            memcpy(b, p, SLICES);
+            b[0] ^= static_cast<uint8_t>(crc);
+            if constexpr (sizeof(T) > 1)
+            {
+                b[1] ^= static_cast<uint8_t>(crc >> 8);
+            }
+            T x = 0;
+            for (size_t i = 0; i < SLICES; i++)
+            {
+                x ^= tab.t[SLICES - 1 - i][b[i]];
+            }
+            crc = x;
+            p += SLICES;
+            len -= SLICES;
+        }
+    }
+    while (len--)
+    {
+        crc = static_cast<T>((crc >> 8) ^ tab.t[0][(crc ^ *p++) & 0xff]);
     }
+    return crc;
+}
 
+/* Hardware backend ----------------------------------------------------------*/
+#if PYRO_CRC_HW_EN
+static constexpr uint32_t crc_reflect(uint32_t v, const uint8_t bits)
+{
+    uint32_t r = 0;
+    for (uint8_t i = 0; i < bits; i++, v >>= 1)
+    {
+        r = (r << 1) | (v & 1);
+    }
+    return r;
+}
+
+/**
+ * @brief Runs one checksum on the CRC unit; reconfigured every call since
+ * CRC-8 and CRC-16 share it. Masks interrupts up to the syscall level, so
+ * it is safe from tasks and ISRs alike.
+ */
+static uint32_t crc_hw(const uint32_t poly_size, const uint32_t poly,
+                       const uint8_t bits, const uint32_t crc,
+                       const uint8_t *p, uint32_t len)
+{
+    const UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    LL_CRC_SetPolynomialSize(CRC, poly_size);
+    LL_CRC_SetPolynomialCoef(CRC, poly);
+    LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_BYTE);
+    LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_BIT);
+    LL_CRC_SetInitialData(CRC, crc_reflect(crc, bits));
+    LL_CRC_ResetCRCCalculationUnit(CRC);
     while (len--)
     {
-        data    = *p_msg++;
-        (crc16) = (crc16 >> 8) ^
-                  crc16_tab[(crc16 ^ static_cast<uint16_t>(data)) & 0x00ff];
+        LL_CRC_FeedData8(CRC, *p++);
     }
+    const uint32_t result = LL_CRC_ReadData32(CRC) & ((1U << bits) - 1);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    return result;
+}
 
-    return crc16;
+/**
+ * @brief Enables the unit and cross-checks it against the software kernel
+ * once; any mismatch keeps the software path.
+ */
+static bool crc_hw_ready()
+{
+    static int8_t state = -1;
+    if (state < 0)
+    {
+        static constexpr uint8_t check[] = {'1', '2', '3', '4', '5',
+                                            '6', '7', '8', '9'};
+        __HAL_RCC_CRC_CLK_ENABLE();
+        const bool ok =
+            crc_hw(LL_CRC_POLYLENGTH_8B, 0x31, 8, CRC8_INIT, check,
+                   sizeof(check)) ==
+                crc_slice(crc8_table, check, sizeof(check), CRC8_INIT) &&
+            crc_hw(LL_CRC_POLYLENGTH_16B, 0x1021, 16, CRC16_INIT, check,
+                   sizeof(check)) ==
+                crc_slice(crc16_table, check, sizeof(check), CRC16_INIT);
+        state = ok ? 1 : 0;
+    }
+    return state > 0;
 }
+#endif
 
+/* Verify / append -----------------------------------------------------------*/
 /**
- * @brief crc16 verify function
- *
- * @param p_msg Data to verify
+ * @brief crc8 verify function
  * @param len Stream length=data+checksum
- * @return bool Crc16 check result
  */
-bool verify_crc16_check_sum(uint8_t const *p_msg, uint16_t len)
+bool crc8_verify(const uint8_t *p_msg, const size_t len)
 {
-    uint16_t w_expected = 0;
+    if ((p_msg == nullptr) || (len <= 2))
+    {
+        return false;
+    }
+    return crc8_calc(p_msg, len - 1) == p_msg[len - 1];
+}
+
+void crc8_append(uint8_t *p_msg, const size_t len)
+{
+    if ((p_msg == nullptr) || (len <= 2))
+    {
+        return;
+    }
+    p_msg[len - 1] = crc8_calc(p_msg, len - 1);
+}
 
+/**
+ * @brief crc16 verify function, checksum little-endian at the end
+ * @param len Stream length=data+checksum
+ */
+bool crc16_verify(const uint8_t *p_msg, const size_t len)
+{
     if ((p_msg == nullptr) || (len <= 2))
     {
         return false;
     }
-    w_expected = get_crc16_check_sum(p_msg, len - 2, crc16_init);
+    const uint16_t expected = crc16_calc(p_msg, len - 2);
+    return (expected & 0xff) == p_msg[len - 2] &&
+           ((expected >> 8) & 0xff) == p_msg[len - 1];
+}
 
-    return ((w_expected & 0xff) == p_msg[len - 2] &&
-            ((w_expected >> 8) & 0xff) == p_msg[len - 1]);
+void crc16_append(uint8_t *p_msg, const size_t len)
+{
+    if ((p_msg == nullptr) || (len <= 2))
+    {
+        return;
+    }
+    const uint16_t crc = crc16_calc(p_msg, len - 2);
+    p_msg[len - 2]     = static_cast<uint8_t>(crc & 0xff);
+    p_msg[len - 1]     = static_cast<uint8_t>((crc >> 8) & 0xff);
+}
+} // namespace pyro
+
+/* C interface ---------------------------------------------------------------*/
+extern "C" uint8_t pyro_crc8(const uint8_t *p_msg, const uint32_t len,
+                             const uint8_t crc8)
+{
+    if (p_msg == nullptr)
+    {
+        return crc8;
+    }
+#if PYRO_CRC_HW_EN
+    if (pyro::crc_hw_ready())
+    {
+        return static_cast<uint8_t>(
+            pyro::crc_hw(LL_CRC_POLYLENGTH_8B, 0x31, 8, crc8, p_msg, len));
+    }
+#endif
+    return pyro::crc_slice(pyro::crc8_table, p_msg, len, crc8);
+}
+
+extern "C" uint16_t pyro_crc16(const uint8_t *p_msg, const uint32_t len,
+                               const uint16_t crc16)
+{
+    if (p_msg == nullptr)
+    {
+        return 0xffff;
+    }
+#if PYRO_CRC_HW_EN
+    if (pyro::crc_hw_ready())
+    {
+        return static_cast<uint16_t>(pyro::crc_hw(
+            LL_CRC_POLYLENGTH_16B, 0x1021, 16, crc16, p_msg, len));
+    }
+#endif
+    return pyro::crc_slice(pyro::crc16_table, p_msg, len, crc16);
 }
@@ -1,6 +1,54 @@
-#ifndef __PYRO_CORE_PROTOCOL_H__
-#define __PYRO_CORE_PROTOCOL_H__
+#ifndef __PYRO_CRC_H__
+#define __PYRO_CRC_H__
 
-extern bool verify_crc16_check_sum(uint8_t const*p_msg, uint16_t len);
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * CRC-8 (poly 0x31 reflected, init 0xFF) and CRC-16 (poly 0x1021 reflected,
+ * init 0xFFFF), as used by the referee system and the VT03 link. Software
+ * slice-by-N kernels by default, the STM32H7 CRC unit with PYRO_CRC_HW_EN.
+ */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    uint8_t pyro_crc8(const uint8_t *p_msg, uint32_t len, uint8_t crc8);
+    uint16_t pyro_crc16(const uint8_t *p_msg, uint32_t len, uint16_t crc16);
+
+#ifdef __cplusplus
+}
+
+namespace pyro
+{
+static constexpr uint8_t CRC8_INIT   = 0xff;
+static constexpr uint16_t CRC16_INIT = 0xffff;
+
+/**
+ * @brief Checksum of `len` bytes, continuing from `crc`.
+ */
+inline uint8_t crc8_calc(const uint8_t *p_msg, const size_t len,
+                         const uint8_t crc = CRC8_INIT)
+{
+    return pyro_crc8(p_msg, len, crc);
+}
+
+inline uint16_t crc16_calc(const uint8_t *p_msg, const size_t len,
+                           const uint16_t crc = CRC16_INIT)
+{
+    return pyro_crc16(p_msg, len, crc);
+}
+
+/**
+ * @brief Checks / writes the trailing checksum; `len` = data + checksum.
+ */
+bool crc8_verify(const uint8_t *p_msg, size_t len);
+void crc8_append(uint8_t *p_msg, size_t len);
+bool crc16_verify(const uint8_t *p_msg, size_t len);
+void crc16_append(uint8_t *p_msg, size_t len);
+} // namespace pyro
+
+#endif
 
 #endif
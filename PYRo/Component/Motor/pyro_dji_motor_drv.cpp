@@ -5,6 +5,11 @@
 
 namespace pyro
 {
+static_assert(sizeof(dji_m3508_motor_drv_t) <= MOTOR_POOL_SLOT_SIZE &&
+                  sizeof(dji_m2006_motor_drv_t) <= MOTOR_POOL_SLOT_SIZE &&
+                  sizeof(dji_gm_6020_motor_drv_t) <= MOTOR_POOL_SLOT_SIZE,
+              "DJI motor drivers must fit a motor pool slot");
+
 dji_motor_tx_frame_t::dji_motor_tx_frame_t(can_hub_t::which_can which,
                                                  uint32_t id)
     : _key(id, which)
@@ -55,23 +60,19 @@ status_t dji_motor_tx_frame_t::update_value(uint8_t id,int16_t value)
         data[i * 2]     = (_value_list[i] & 0xff00) >> 8;
         data[i * 2 + 1] = _value_list[i] & 0xff;
     }
-    _can->send_msg(_key.first, data.data());
+    _can->send_msg(_key.first, data.data(), can_drv_t::tx_prio_control);
     return PYRO_OK;
 }
 
 dji_motor_tx_frame_pool_t::dji_motor_tx_frame_pool_t(void)
+    : _frame_list{}, _frame_num(0)
 {
-    _frame_list.clear();
 }
-dji_motor_tx_frame_pool_t *dji_motor_tx_frame_pool_t::_instancePtr = nullptr;
 
 dji_motor_tx_frame_pool_t * dji_motor_tx_frame_pool_t::get_instance(void)
 {
-    if (_instancePtr == nullptr) // Mutex
-    {
-        _instancePtr = new dji_motor_tx_frame_pool_t();
-    }
-    return _instancePtr;
+    static dji_motor_tx_frame_pool_t instance;
+    return &instance;
 }
 
 dji_motor_tx_frame_t *
@@ -79,8 +80,7 @@ dji_motor_tx_frame_pool_t::get_frame(can_hub_t::which_can which, uint32_t id)
 {
     dji_motor_tx_frame_t *frame = nullptr;
     dji_motor_tx_frame_t::_frame_key_t key(id, which);
-    int length = _frame_list.size();
-    for (uint8_t i = 0; i < length; i++)
+    for (size_t i = 0; i < _frame_num; i++)
     {
         if (_frame_list[i]->get_key() == key)
         {
@@ -90,8 +90,12 @@ dji_motor_tx_frame_pool_t::get_frame(can_hub_t::which_can which, uint32_t id)
     }
     if (frame == nullptr)
     {
-        frame = new dji_motor_tx_frame_t(which, id);
-        _frame_list.push_back(frame);
+        frame = _frames.create(which, id);
+        configASSERT(frame != nullptr);
+        if (frame != nullptr)
+        {
+            _frame_list[_frame_num++] = frame;
+        }
     }
     return frame;
 }
@@ -118,8 +122,11 @@ status_t dji_motor_drv_t::disable()
 
 status_t dji_motor_drv_t::update_feedback()
 {
-    static std::array<uint8_t, 8> data;
-    _feedback_msg->get_data(data);
+    std::array<uint8_t, 8> data;
+    if (!is_online())
+        return PYRO_TIMEOUT;
+    if (!_feedback_msg->get_data(data))
+        return PYRO_ERROR;
 
     _current_position = ((float)((uint16_t)((data[0] << 8) | (data[1])))) /
                         8192.0f * 2 * PI;
@@ -180,6 +187,7 @@ dji_m3508_motor_drv_t::dji_m3508_motor_drv_t(
             break;
     }
     _feedback_msg = new can_msg_buffer_t(_rx_id);
+    _feedback_msg->set_nominal_period(FEEDBACK_PERIOD_TICKS);
     if (_can_drv)
     {
         _can_drv->register_rx_msg(_feedback_msg);
@@ -217,6 +225,7 @@ dji_m2006_motor_drv_t::dji_m2006_motor_drv_t(
             break;
     }
     _feedback_msg = new can_msg_buffer_t(_rx_id);
+    _feedback_msg->set_nominal_period(FEEDBACK_PERIOD_TICKS);
     if (_can_drv)
     {
         _can_drv->register_rx_msg(_feedback_msg);
@@ -255,6 +264,7 @@ dji_gm_6020_motor_drv_t::dji_gm_6020_motor_drv_t(
     }
 
     _feedback_msg = new can_msg_buffer_t(_rx_id);
+    _feedback_msg->set_nominal_period(FEEDBACK_PERIOD_TICKS);
     if (_can_drv)
     {
         _can_drv->register_rx_msg(_feedback_msg);
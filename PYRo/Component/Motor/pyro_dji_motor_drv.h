@@ -47,12 +47,16 @@ class dji_motor_tx_frame_pool_t
                                     uint32_t id);
 
   private:
+    // DJI motors share at most 3 control IDs (0x200, 0x1FF, 0x2FE) per bus
+    static constexpr size_t MAX_FRAME_NUM = 4 * can_hub_t::can_num;
+
     dji_motor_tx_frame_pool_t(void);
     dji_motor_tx_frame_pool_t(const dji_motor_tx_frame_pool_t &) = delete;
     dji_motor_tx_frame_pool_t &
     operator=(const dji_motor_tx_frame_pool_t &) = delete;
-    static dji_motor_tx_frame_pool_t *_instancePtr;
-    std::vector<dji_motor_tx_frame_t *> _frame_list;
+    pool_t<dji_motor_tx_frame_t, MAX_FRAME_NUM> _frames;
+    std::array<dji_motor_tx_frame_t *, MAX_FRAME_NUM> _frame_list;
+    size_t _frame_num;
 };
 
 class dji_motor_drv_t : public motor_base_t
@@ -69,6 +73,9 @@ class dji_motor_drv_t : public motor_base_t
     status_t send_torque(float torque) override;
 
   protected:
+    // DJI motors broadcast feedback at 1 kHz
+    static constexpr TickType_t FEEDBACK_PERIOD_TICKS = pdMS_TO_TICKS(1);
+
     dji_motor_tx_frame_t::register_id_t _register_id;
     uint32_t _tx_id;
     uint32_t _rx_id;
@@ -2,6 +2,9 @@
 
 namespace pyro
 {
+static_assert(sizeof(dm_motor_drv_t) <= MOTOR_POOL_SLOT_SIZE,
+              "dm_motor_drv_t must fit a motor pool slot");
+
 dm_motor_drv_t::dm_motor_drv_t(uint32_t can_id, uint32_t master_id,
                                      can_hub_t::which_can which)
     : motor_base_t(which)
@@ -9,6 +12,7 @@ dm_motor_drv_t::dm_motor_drv_t(uint32_t can_id, uint32_t master_id,
     _master_id     = master_id;
     _can_id        = can_id;
     _feedback_msg = new can_msg_buffer_t(_master_id);
+    _feedback_msg->set_nominal_period(FEEDBACK_PERIOD_TICKS);
     if (_can_drv)
     {
         _can_drv->register_rx_msg(_feedback_msg);
@@ -58,7 +62,10 @@ static float uint_to_float(int x_int, float x_min, float x_max, int bits)
 status_t pyro::dm_motor_drv_t::update_feedback()
 {
     std::array<uint8_t, 8> data;
-    _feedback_msg->get_data(data);
+    if (!is_online())
+        return PYRO_TIMEOUT;
+    if (!_feedback_msg->get_data(data))
+        return PYRO_ERROR;
     _error_code = static_cast<error_code>(((data[0]>>4)&0x0f));
     uint16_t position = ((uint16_t)((data[1] << 8) | (data[2])));
     uint16_t rotate   = ((uint16_t)((data[3] << 4) | ((data[4] >> 4) & 0x0f)));
@@ -91,7 +98,8 @@ status_t pyro::dm_motor_drv_t::send_torque(float torque)
     data[6]      = ((kd_int & 0x0f) << 4) | (torque_int >> 8);
     data[7]      = torque_int;
 
-    if(PYRO_OK!=_can_drv->send_msg(_can_id, data.data()))
+    if(PYRO_OK!=_can_drv->send_msg(_can_id, data.data(),
+                                   can_drv_t::tx_prio_control))
     {
         return PYRO_ERROR;
     }
@@ -36,6 +36,9 @@ class dm_motor_drv_t : public motor_base_t // MIT only
     void set_runtime_kd(float kd);
 
   private:
+    // DM motors answer every MIT command, expected at the 1 kHz control rate
+    static constexpr TickType_t FEEDBACK_PERIOD_TICKS = pdMS_TO_TICKS(1);
+
     uint32_t _can_id;
     uint32_t _master_id;
 
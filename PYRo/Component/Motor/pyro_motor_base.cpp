@@ -9,6 +9,10 @@ motor_base_t::motor_base_t(can_hub_t::which_can which)
     _can_drv = can_hub_t::get_instance()->hub_get_can_obj(which);
 }
 
+motor_base_t::~motor_base_t(void)
+{
+}
+
 int8_t motor_base_t::get_temperature(void)
 {
     return _temperature;
@@ -34,4 +38,22 @@ bool motor_base_t::is_enable(void)
     return _enable;
 }
 
+/**
+ * @brief Whether feedback arrived within the online monitor's timeout.
+ */
+bool motor_base_t::is_online(void)
+{
+    return _feedback_msg && _feedback_msg->is_online();
+}
+
+/**
+ * @brief Adds this motor's feedback frame to an RX notification group.
+ */
+status_t motor_base_t::join_rx_group(can_rx_group_t &group)
+{
+    if (nullptr == _feedback_msg)
+        return PYRO_ERROR;
+    return group.add(_feedback_msg);
+}
+
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "main.h"
 #include "pyro_can_drv.h"
 #include "pyro_core_def.h"
+#include "pyro_pool.h"
 #include <cstdint>
 
 #include <memory>
@@ -14,11 +15,15 @@
 
 namespace pyro
 {
+// 电机对象池槽位，需容纳最大的派生类 (dm_motor_drv_t)
+static constexpr size_t MOTOR_POOL_SLOT_SIZE = 24 * sizeof(void *);
+
 class motor_base_t
+    : public pool_new_t<motor_base_t, PYRO_POOL_MOTOR_NUM, MOTOR_POOL_SLOT_SIZE>
 {
   public:
     motor_base_t(can_hub_t::which_can which);
-    virtual ~motor_base_t(void);//先不实现
+    virtual ~motor_base_t(void);
 
     virtual status_t enable()        = 0;
     virtual status_t disable()       = 0;
@@ -32,6 +37,8 @@ class motor_base_t
     float get_current_torque(void);
 
     bool is_enable(void);
+    bool is_online(void);
+    status_t join_rx_group(can_rx_group_t &group);
 
   protected:
     can_hub_t::which_can _which_can;
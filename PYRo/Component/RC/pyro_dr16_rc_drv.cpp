@@ -15,7 +15,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "pyro_dr16_rc_drv.h"
 #include "pyro_rw_lock.h"
-#include "task.h" // Needed for xTaskCreate calls
+#include "task.h" // Needed for task creation calls
 #include <cstring>
 
 // External FreeRTOS task entry point
@@ -26,13 +26,19 @@ namespace pyro
 static constexpr uint16_t DR16_CH_VALUE_MIN    = 364;
 static constexpr uint16_t DR16_CH_VALUE_MAX    = 1684;
 static constexpr uint16_t DR16_CH_VALUE_OFFSET = 1024;
+
+// 18-byte frames without sync or CRC: framing comes from the UART IDLE event
+static constexpr frame_format_t dr16_format = {
+    {0x00, 0x00}, 0, 0, 0, 0, 0, 18, 18, nullptr, nullptr,
+};
 /* Constructor ---------------------------------------------------------------*/
 /**
  * @brief Constructor for the DR16 driver.
  *
  * Calls the base class constructor and sets the internal task priority.
  */
-dr16_drv_t::dr16_drv_t(uart_drv_t *dr16_uart) : rc_drv_t(dr16_uart)
+dr16_drv_t::dr16_drv_t(uart_drv_t *dr16_uart)
+    : rc_drv_t(dr16_uart), _parser(dr16_format)
 {
     _priority = 1;
     dr16_drv_t::init();
@@ -46,11 +52,12 @@ dr16_drv_t::dr16_drv_t(uart_drv_t *dr16_uart) : rc_drv_t(dr16_uart)
 status_t dr16_drv_t::init()
 {
     // Create the message buffer (108 bytes capacity)
-    _rc_msg_buffer   = xMessageBufferCreate(108);
+    _rc_msg_buffer   = _rc_msg_storage.create();
 
     // Create the processing task
-    const BaseType_t x_ret = xTaskCreate(dr16_task, "dr16_task", 256, this,
-                                   configMAX_PRIORITIES - 1, &_rc_task_handle);
+    const BaseType_t x_ret =
+        _rc_task_storage.create(dr16_task, "dr16_task", this,
+                                configMAX_PRIORITIES - 1, &_rc_task_handle);
 
     if (x_ret != pdPASS)
     {
@@ -60,7 +67,6 @@ status_t dr16_drv_t::init()
     {
         return PYRO_ERROR;
     }
-    _lock = new rw_lock;
     _rc_data = &_dr16_ctrl;
     return PYRO_OK;
 }
@@ -76,9 +82,7 @@ void dr16_drv_t::enable()
 {
     // Register the local rc_callback method as the UART RX event handler
     _rc_uart->add_rx_event_callback(
-        [this](uint8_t *buf, const uint16_t len,
-               const BaseType_t xHigherPriorityTaskWoken) -> bool
-        { return rc_callback(buf, len, xHigherPriorityTaskWoken); },
+        uart_drv_t::rx_event_func::bind<dr16_drv_t, &dr16_drv_t::rc_callback>(this),
         reinterpret_cast<uint32_t>(this));
 }
 
@@ -235,25 +239,28 @@ void dr16_drv_t::unpack(const dr16_buf_t *dr16_buf)
 /**
  * @brief Called by the UART driver upon an RX event (ISR context).
  *
- * If the length is correct (18 bytes for DR16), it checks the priority flag
- * and sends the raw buffer to the message buffer for deferred processing.
+ * Every IDLE event is framed as one DR16 packet (18 bytes). A valid frame is
+ * sent to the message buffer for deferred processing if the priority allows.
  * @return true if data was buffered and the UART buffer should switch.
  */
 bool dr16_drv_t::rc_callback(uint8_t *buf, const uint16_t len,
-                             BaseType_t xHigherPriorityTaskWoken)
+                             BaseType_t &xHigherPriorityTaskWoken)
 {
-    if (len == 18)
-    {
-        // Check if the protocol is higher priority than any other active RC
-        // protocol
-        if (__builtin_ctz(sequence) >= _priority)
-        {
-            xMessageBufferSendFromISR(_rc_msg_buffer, buf, len,
-                                      &xHigherPriorityTaskWoken);
-            return true;
-        }
-    }
-    return false;
+    bool consumed = false;
+    _parser.reset(); // Each IDLE event starts a new frame
+    _parser.feed(buf, len,
+                 [&](const uint8_t *frame, const uint16_t size)
+                 {
+                     // Check if the protocol is higher priority than any
+                     // other active RC protocol
+                     if (__builtin_ctz(sequence) >= _priority)
+                     {
+                         xMessageBufferSendFromISR(_rc_msg_buffer, frame, size,
+                                                   &xHigherPriorityTaskWoken);
+                         consumed = true;
+                     }
+                 });
+    return consumed;
 }
 
 /* FreeRTOS Task Thread ------------------------------------------------------*/
@@ -17,6 +17,7 @@
 #define __PYRO_DR16_RC_DRV_H__
 
 /* Includes ------------------------------------------------------------------*/
+#include "frame_parser.h"
 #include "pyro_rc_base_drv.h"
 
 /* Defines -------------------------------------------------------------------*/
@@ -162,6 +163,7 @@ class dr16_drv_t : public rc_drv_t
   private:
     explicit dr16_drv_t(uart_drv_t *dr16_uart);
     dr16_ctrl_t _dr16_ctrl{}; ///< The latest decoded control data.
+    frame_parser_t<sizeof(dr16_buf_t)> _parser; ///< ISR-side framing.
     /* Private Methods - Overrides
      * ---------------------------------------------*/
     /**
@@ -170,7 +172,7 @@ class dr16_drv_t : public rc_drv_t
      * Receives raw UART data and forwards it to the FreeRTOS message buffer.
      */
     bool rc_callback(uint8_t *buf, uint16_t len,
-                     BaseType_t xHigherPriorityTaskWoken) override;
+                     BaseType_t &xHigherPriorityTaskWoken) override;
 
     /* Private Methods - Processing
      * --------------------------------------------*/
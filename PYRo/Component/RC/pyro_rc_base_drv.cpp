@@ -40,7 +40,7 @@ rc_drv_t::rc_drv_t(uart_drv_t *uart)
 
 rw_lock &rc_drv_t::get_lock() const
 {
-    return *_lock;
+    return _lock;
 }
 
 bool rc_drv_t::check_online() const
@@ -74,6 +74,5 @@ rc_drv_t::~rc_drv_t()
         vTaskDelete(_rc_task_handle);
         _rc_task_handle = nullptr;
     }
-    delete _lock;
 }
 } // namespace pyro
\ No newline at end of file
@@ -18,6 +18,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "pyro_rw_lock.h"
+#include "pyro_static_alloc.h"
 #include "pyro_uart_drv.h" // Dependency on the UART driver
 #include "task.h"          // FreeRTOS Task definitions
 #include "message_buffer.h" // FreeRTOS Message Buffer definitions
@@ -64,7 +65,7 @@ class rc_drv_t
      * UART driver.
      */
     virtual bool rc_callback(uint8_t *buf, uint16_t len,
-                             BaseType_t xHigherPriorityTaskWoken) = 0;
+                             BaseType_t &xHigherPriorityTaskWoken) = 0;
 
 
   protected:
@@ -72,8 +73,13 @@ class rc_drv_t
      * ---------------------------------*/
     explicit rc_drv_t(uart_drv_t *uart);
     virtual ~rc_drv_t();
+    static constexpr uint32_t RC_TASK_STACK_DEPTH = 256;
+    static constexpr size_t RC_MSG_BUFFER_SIZE    = 108;
+
     void const *_rc_data{}; ///< Pointer to the latest decoded control data.
-    rw_lock *_lock{};
+    mutable rw_lock _lock;  ///< Guards _rc_data; created with the driver.
+    task_storage_t<RC_TASK_STACK_DEPTH> _rc_task_storage;
+    message_buffer_storage_t<RC_MSG_BUFFER_SIZE> _rc_msg_storage;
     MessageBufferHandle_t _rc_msg_buffer{};
     ///< Handle for the FreeRTOS message buffer.
     TaskHandle_t _rc_task_handle{};
@@ -16,7 +16,7 @@
 #include "pyro_vt03_rc_drv.h"
 #include "pyro_crc.h"
 #include "pyro_rw_lock.h"
-#include "task.h" // Needed for xTaskCreate calls
+#include "task.h" // Needed for task creation calls
 #include <cstring>
 
 // External FreeRTOS task entry point
@@ -27,13 +27,24 @@ namespace pyro
 static constexpr uint16_t VT03_CH_VALUE_MIN    = 364;
 static constexpr uint16_t VT03_CH_VALUE_MAX    = 1684;
 static constexpr uint16_t VT03_CH_VALUE_OFFSET = 1024;
+
+static bool vt03_crc_check(const uint8_t *p, const uint16_t len)
+{
+    return crc16_verify(p, len);
+}
+
+// A9 53 | channels, mouse, keys | CRC16: fixed 21 bytes
+static constexpr frame_format_t vt03_format = {
+    {0xA9, 0x53}, 2, 2, 0, 0, 0, 21, 21, nullptr, vt03_crc_check,
+};
 /* Constructor ---------------------------------------------------------------*/
 /**
  * @brief Constructor for the VT03 driver.
  *
  * Calls the base class constructor and sets the internal task priority.
  */
-vt03_drv_t::vt03_drv_t(uart_drv_t *vt03_uart) : rc_drv_t(vt03_uart)
+vt03_drv_t::vt03_drv_t(uart_drv_t *vt03_uart)
+    : rc_drv_t(vt03_uart), _parser(vt03_format)
 {
     _priority = 0;
     vt03_drv_t::init();
@@ -47,11 +58,12 @@ vt03_drv_t::vt03_drv_t(uart_drv_t *vt03_uart) : rc_drv_t(vt03_uart)
 status_t vt03_drv_t::init()
 {
     // Create the message buffer (108 bytes capacity)
-    _rc_msg_buffer   = xMessageBufferCreate(108);
+    _rc_msg_buffer   = _rc_msg_storage.create();
 
     // Create the processing task
-    const BaseType_t x_ret = xTaskCreate(vt03_task, "vt03_task", 256, this,
-                                   configMAX_PRIORITIES - 1, &_rc_task_handle);
+    const BaseType_t x_ret =
+        _rc_task_storage.create(vt03_task, "vt03_task", this,
+                                configMAX_PRIORITIES - 1, &_rc_task_handle);
 
     if (x_ret != pdPASS)
     {
@@ -61,7 +73,6 @@ status_t vt03_drv_t::init()
     {
         return PYRO_ERROR;
     }
-    _lock = new rw_lock;
     _rc_data = &_vt03_ctrl;
     return PYRO_OK;
 }
@@ -70,16 +81,23 @@ status_t vt03_drv_t::init()
 /**
  * @brief Enables the VT03 receiver.
  *
- * Adds the ISR callback to the UART driver and sets the protocol's sequence
- * bit.
+ * On a circular-DMA UART (UART1, shared with the referee stream) the parser
+ * reads the ring in place through a span callback; otherwise it gets the
+ * double-buffered IDLE chunks.
  */
 void vt03_drv_t::enable()
 {
+    if (_rc_uart->state.rx_circular)
+    {
+        _rc_uart->add_rx_span_callback(
+            uart_drv_t::rx_span_func::bind<vt03_drv_t,
+                                           &vt03_drv_t::rc_span_callback>(this),
+            reinterpret_cast<uint32_t>(this));
+        return;
+    }
     // Register the local rc_callback method as the UART RX event handler
     _rc_uart->add_rx_event_callback(
-        [this](uint8_t *buf, const uint16_t len,
-               const BaseType_t xHigherPriorityTaskWoken) -> bool
-        { return rc_callback(buf, len, xHigherPriorityTaskWoken); },
+        uart_drv_t::rx_event_func::bind<vt03_drv_t, &vt03_drv_t::rc_callback>(this),
         reinterpret_cast<uint32_t>(this));
 }
 
@@ -93,13 +111,15 @@ void vt03_drv_t::disable()
     // Clear the priority bit in the base class static sequence variable
     sequence &= ~(1 << _priority);
     // Remove the registered callback using the instance address as the owner ID
+    _rc_uart->remove_rx_span_callback(reinterpret_cast<uint32_t>(this));
     _rc_uart->remove_rx_event_callback(reinterpret_cast<uint32_t>(this));
 }
 
 
 /* Data Processing - Error Check ---------------------------------------------*/
 /**
- * @brief Performs basic range checking on received channel data.
+ * @brief Performs basic range checking on received channel data. The CRC is
+ * already verified by the frame parser in the ISR.
  * @return PYRO_OK if all main channels are within min/max bounds.
  */
 status_t vt03_drv_t::error_check(const vt03_buf_t *vt03_buf)
@@ -117,10 +137,6 @@ status_t vt03_drv_t::error_check(const vt03_buf_t *vt03_buf)
     {
         return PYRO_ERROR;
     }
-    if (!verify_crc16_check_sum(reinterpret_cast<uint8_t const*>(vt03_buf), sizeof(vt03_buf_t)))
-    {
-        return PYRO_ERROR;
-    }
     return PYRO_OK;
 }
 
@@ -246,26 +262,46 @@ void vt03_drv_t::unpack(const vt03_buf_t *vt03_buf)
 /**
  * @brief Called by the UART driver upon an RX event (ISR context).
  *
- * If the length matches the expected size, it checks the priority flag
- * and sends the raw buffer to the message buffer for deferred processing.
+ * Runs the chunk through the frame parser; every CRC-valid frame is sent to
+ * the message buffer for deferred processing if the priority allows.
  * @return true if data was buffered and the UART buffer should switch.
  */
 bool vt03_drv_t::rc_callback(uint8_t *buf, const uint16_t len,
-                             BaseType_t xHigherPriorityTaskWoken)
+                             BaseType_t &xHigherPriorityTaskWoken)
 {
-    if (len == sizeof(vt03_buf_t))
+    // The parser finds frames anywhere in the chunk (UART1 also carries the
+    // referee stream) and reassembles frames split across RX events
+    bool consumed = false;
+    _parser.feed(buf, len,
+                 [&](const uint8_t *frame, const uint16_t size)
+                 {
+                     if (__builtin_ctz(sequence) >= _priority)
+                     {
+                         xMessageBufferSendFromISR(_rc_msg_buffer, frame, size,
+                                                   &xHigherPriorityTaskWoken);
+                         consumed = true;
+                     }
+                 });
+    return consumed;
+}
+
+/**
+ * @brief Called by the UART driver with new ring bytes (ISR context).
+ *
+ * Feeds both pieces of the span to the frame parser, which reassembles a
+ * frame split across the ring end or across events.
+ */
+void vt03_drv_t::rc_span_callback(const uart_rx_span_t &span,
+                                  BaseType_t &xHigherPriorityTaskWoken)
+{
+    for (uint8_t i = 0; i < 2; i++)
     {
-        if (buf[0] == 0xA9 && buf[1] == 0x53)
+        if (span.size[i])
         {
-            if (__builtin_ctz(sequence) >= _priority)
-            {
-                xMessageBufferSendFromISR(_rc_msg_buffer, buf, len,
-                                          &xHigherPriorityTaskWoken);
-                return true;
-            }
+            rc_callback(const_cast<uint8_t *>(span.data[i]), span.size[i],
+                        xHigherPriorityTaskWoken);
         }
     }
-    return false;
 }
 
 /* FreeRTOS Task Thread ------------------------------------------------------*/
@@ -17,6 +17,7 @@
 #define __PYRO_VT03_RC_DRV_H__
 
 /* Includes ------------------------------------------------------------------*/
+#include "frame_parser.h"
 #include "pyro_rc_base_drv.h"
 
 /* Defines -------------------------------------------------------------------*/
@@ -174,6 +175,7 @@ class vt03_drv_t : public rc_drv_t
   private:
     explicit vt03_drv_t(uart_drv_t *vt03_uart);
     vt03_ctrl_t _vt03_ctrl{}; ///< The latest decoded control data.
+    frame_parser_t<sizeof(vt03_buf_t)> _parser; ///< ISR-side framing.
     /* Private Methods - Overrides
      * ---------------------------------------------*/
     /**
@@ -182,7 +184,14 @@ class vt03_drv_t : public rc_drv_t
      * Receives raw UART data and forwards it to the FreeRTOS message buffer.
      */
     bool rc_callback(uint8_t *buf, uint16_t len,
-                     BaseType_t xHigherPriorityTaskWoken) override;
+                     BaseType_t &xHigherPriorityTaskWoken) override;
+    /**
+     * @brief Zero-copy variant for a circular-DMA UART (ISR context).
+     *
+     * Runs both pieces of the ring span through the frame parser.
+     */
+    void rc_span_callback(const uart_rx_span_t &span,
+                          BaseType_t &xHigherPriorityTaskWoken);
 
     /* Private Methods - Processing
      * --------------------------------------------*/
@@ -525,6 +525,44 @@ end:
   return (-1);
 }
 
+//******************************************************************************************
+//
+//! \brief  Borrow the contiguous used block at the read pointer (in single mode).
+//!
+//! The block stays valid until it is released with fifo_s_discard(); the producer
+//! only writes the free area, so the consumer may parse it in place.
+//!
+//! \param  [in]  p_fifo is the pointer of valid FIFO.
+//! \param  [out] pp_block receives the start of the block.
+//!
+//! \retval The block length, 0 if the FIFO is empty.
+//
+//******************************************************************************************
+int fifo_s_peek_block(fifo_s_t *p_fifo, char **pp_block)
+{
+  FIFO_CPU_SR_TYPE cpu_sr;
+  int len;
+
+  ASSERT(p_fifo);
+  ASSERT(pp_block);
+
+  //Interrupt Off;
+  cpu_sr = FIFO_GET_CPU_SR();
+  FIFO_ENTER_CRITICAL();
+
+  if (p_fifo->p_read_addr > p_fifo->p_end_addr)
+    p_fifo->p_read_addr = p_fifo->p_start_addr;
+
+  len = p_fifo->p_end_addr - p_fifo->p_read_addr + 1;
+  len = (len < p_fifo->used_num) ? len : p_fifo->used_num;
+  *pp_block = p_fifo->p_read_addr;
+
+  //Interrupt On
+  FIFO_RESTORE_CPU_SR(cpu_sr);
+
+  return len;
+}
+
 //******************************************************************************************
 //
 //! \brief  FIFO is empty (in single mode)?
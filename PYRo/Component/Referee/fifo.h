@@ -2,7 +2,7 @@
 #ifndef __FIFO_H__
 #define __FIFO_H__
 #ifdef __cplusplus
-"C"
+extern "C"
 {
 #endif
 
@@ -148,6 +148,19 @@
   char fifo_s_preread(fifo_s_t * p_fifo, int offset);
   int fifo_s_prereads(fifo_s_t * p_fifo, char *p_dest, int offset, int len);
 
+  //******************************************************************************************
+  //
+  //! \brief  Borrow the contiguous used block at the read pointer, release it with
+  //!         fifo_s_discard() once parsed.
+  //!
+  //! \param  [in]  p_fifo is the pointer of valid FIFO.
+  //! \param  [out] pp_block receives the start of the block.
+  //!
+  //! \retval The block length, 0 if the FIFO is empty.
+  //
+  //******************************************************************************************
+  int fifo_s_peek_block(fifo_s_t * p_fifo, char **pp_block);
+
   //******************************************************************************************
   //
   //! \brief  FIFO is empty (in single mode)?
@@ -231,30 +231,6 @@ typedef struct __packed
 } sentry_desicion_making_t;
 
 
-typedef struct	
-{
-	game_status_t game_status;//1
-	game_result_t	 game_result;//2
-	ext_game_robot_HP_t game_robot_HP;//3
-	event_data_t field_event;//101
-	ext_supply_projectile_action_t projectile;//102
-	referee_warning_t referee_warning;//104
-	robot_status_t robot_status;//201
-	power_heat_data_t power_heat;//202
-	robot_pos_t robot_pos;//203
-	buff_t buff;//204
-	hurt_data_t hurt;//206
-	shoot_data_t shoot;//207
-	projectile_allowance_t allowance;//208
-	rfid_status_t rfid;//209
-	ground_robot_position_t ground_robot_position;//20B
-	sentry_info_t sentry_info;//20D
-	robot_interaction_data_t robot_interaction;//301
-	map_data_t map;//307
-	custom_info_t custom_info;//308
-}referee_data_t;
-
-extern referee_data_t referee_data;
 
 
 
@@ -275,5 +251,4 @@ extern void Referee_Check_Hurt(void);
 extern uint8_t Referee_Check_hurt_gyro_flag(void);
 extern uint8_t Referee_Check_Revival_Status();
 
-extern referee_data_t referee_data;
 #endif
@@ -1,24 +1,75 @@
 #include "cmsis_os.h"
+#include "frame_parser.h"
+#include "protocol.h"
+#include "pyro_crc.h"
 #include "pyro_uart_drv.h"
 
 #include <cstdio>
 #include <cstring>
 
 extern "C" void referee_usart_task(void *argument);
-extern "C" void referee_rx_handler(uint8_t *buf, uint16_t Size);
+extern "C" void referee_rx_handler(uint8_t *buf, uint16_t Size,
+                                   BaseType_t *woken);
+extern "C" void referee_data_solve(uint8_t *frame);
 
-bool referee_uart_callback(uint8_t *data, uint16_t size,
-                           BaseType_t xHigherPriorityTaskWoken)
+/* Frame Parser --------------------------------------------------------------*/
+static bool referee_header_check(const uint8_t *p, const uint16_t len)
 {
+    return pyro::crc8_verify(p, len);
+}
+
+static bool referee_frame_check(const uint8_t *p, const uint16_t len)
+{
+    return pyro::crc16_verify(p, len);
+}
+
+// SOF | data_length(2) | seq | CRC8 | cmd_id(2) | data | CRC16
+static constexpr pyro::frame_format_t referee_format = {
+    {HEADER_SOF, 0x00},
+    1,
+    REF_PROTOCOL_HEADER_SIZE,
+    1,
+    2,
+    REF_HEADER_CRC_CMDID_LEN,
+    0,
+    REF_HEADER_CRC_CMDID_LEN,
+    referee_header_check,
+    referee_frame_check,
+};
 
-    referee_rx_handler(data, size);
-    return true;
+static pyro::frame_parser_t<REF_PROTOCOL_FRAME_MAX_SIZE>
+    referee_parser(referee_format);
+
+/**
+ * @brief Parses a chunk of the referee stream and solves every valid frame.
+ */
+extern "C" void referee_frame_feed(const uint8_t *buf, const uint16_t len)
+{
+    referee_parser.feed(buf, len,
+                        [](const uint8_t *frame, uint16_t)
+                        { referee_data_solve(const_cast<uint8_t *>(frame)); });
+}
+
+void referee_uart_callback(const pyro::uart_rx_span_t &span,
+                           BaseType_t &xHigherPriorityTaskWoken)
+{
+    // Both pieces are read straight out of the UART1 DMA ring
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (span.size[i])
+        {
+            referee_rx_handler(const_cast<uint8_t *>(span.data[i]),
+                               span.size[i], &xHigherPriorityTaskWoken);
+        }
+    }
 }
 
 extern "C" void referee_init()
 {
     pyro::uart_drv_t::get_instance(pyro::uart_drv_t::uart1)
-        ->add_rx_event_callback(referee_uart_callback, 0x20);
+        ->add_rx_span_callback(
+            pyro::uart_drv_t::rx_span_func::bind<referee_uart_callback>(),
+            0x20);
 }
 
 extern "C" void referee_task(void *arg)
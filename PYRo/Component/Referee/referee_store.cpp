@@ -0,0 +1,23 @@
+#include "referee_store.h"
+
+#include "cmsis_os.h"
+
+namespace pyro
+{
+referee_store_t *referee_store_t::get_instance()
+{
+    static referee_store_t instance;
+    return &instance;
+}
+} // namespace pyro
+
+/**
+ * @brief Publishes one referee payload, stamped with the current tick.
+ */
+extern "C" bool referee_store_update(const uint16_t cmd_id,
+                                     const uint8_t *payload,
+                                     const uint16_t len)
+{
+    return pyro::referee_store_t::get_instance()->update(
+        cmd_id, payload, len, xTaskGetTickCount());
+}
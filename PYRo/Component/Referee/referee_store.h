@@ -0,0 +1,316 @@
+#ifndef PYRO_REFEREE_STORE_H
+#define PYRO_REFEREE_STORE_H
+
+#include "cmsis_os.h"
+#include "delegate.h"
+#include "protocol.h"
+#include "pyro_core_def.h"
+#include "pyro_seqlatch.h"
+#include "referee.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+
+namespace pyro
+{
+/**
+ * @brief Binds a referee command ID to its payload struct.
+ */
+template <uint16_t ID, typename T> struct referee_cmd_t
+{
+    static constexpr uint16_t id = ID;
+    using type                   = T;
+};
+
+/**
+ * @brief Metadata kept next to every payload.
+ */
+struct referee_meta_t
+{
+    uint32_t stamp; // receive time, RTOS ticks
+    uint32_t count; // updates since boot, 0 = never received
+};
+
+/**
+ * @brief Per-command store of the latest referee payloads.
+ *
+ * Every command has its own double-buffered seqlock, so a reader never
+ * waits and only retries when the unpack task completes two updates of the
+ * same command during one read. A 1 kHz control loop reading
+ * `POWER_HEAT_DATA_CMD_ID` preempting the unpack task therefore always
+ * gets a consistent snapshot. Single writer: the referee unpack task.
+ *
+ * Commands are dispatched through a table sorted by ID at compile time
+ * (binary search, no switch). Modules that must react to a command at once
+ * register a typed subscriber; it runs in the unpack task right after the
+ * payload is published, so keep it short and non-blocking.
+ */
+template <typename... CMDS> class referee_store_base_t
+{
+    template <size_t I>
+    using cmd_at = std::tuple_element_t<I, std::tuple<CMDS...>>;
+
+    static constexpr size_t CMD_NUM = sizeof...(CMDS);
+
+  public:
+    static constexpr uint8_t MAX_SUBSCRIBER_NUM = 2;
+
+    template <uint16_t ID> static constexpr size_t index_of()
+    {
+        constexpr uint16_t ids[] = {CMDS::id...};
+        for (size_t i = 0; i < CMD_NUM; i++)
+        {
+            if (ids[i] == ID)
+                return i;
+        }
+        return CMD_NUM;
+    }
+
+    template <uint16_t ID>
+    using type_of = typename cmd_at<index_of<ID>()>::type;
+
+    template <uint16_t ID>
+    using sub_func =
+        delegate_t<void(const type_of<ID> &data, const referee_meta_t &meta)>;
+
+    /**
+     * @brief One row of the dispatch table.
+     */
+    struct cmd_entry_t
+    {
+        uint16_t id;
+        uint16_t index; // position in the command list / slot tuple
+        uint16_t size;  // payload struct size
+        void (*write)(referee_store_base_t &self, const uint8_t *payload,
+                      uint16_t len, uint32_t stamp);
+    };
+
+    /**
+     * @brief Table row of `id`, nullptr for an unknown command.
+     */
+    static const cmd_entry_t *find(const uint16_t id)
+    {
+        static constexpr std::array<cmd_entry_t, CMD_NUM> table =
+            make_table(std::index_sequence_for<CMDS...>{});
+        size_t lo = 0;
+        size_t hi = CMD_NUM;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (table[mid].id < id)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return (lo < CMD_NUM && table[lo].id == id) ? &table[lo] : nullptr;
+    }
+
+    /**
+     * @brief Copies the latest payload of command `ID`.
+     * @return false if it was never received, or on a torn read; `out` is
+     *         untouched then.
+     */
+    template <uint16_t ID>
+    bool get(type_of<ID> &out, referee_meta_t *meta = nullptr) const
+    {
+        sample_t<type_of<ID>> sample;
+        const auto &latch = std::get<index_of<ID>()>(_slots).latch;
+        // Sample the count first: it may only lag behind the snapshot
+        const uint32_t count = latch.get_sequence();
+        if (0 == count || !latch.read(sample))
+            return false;
+        out = sample.data;
+        if (meta)
+        {
+            meta->stamp = sample.stamp;
+            meta->count = count;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Number of updates of command `ID` since boot.
+     */
+    template <uint16_t ID> uint32_t count() const
+    {
+        return std::get<index_of<ID>()>(_slots).latch.get_sequence();
+    }
+
+    /**
+     * @brief Registers `func` to run on every update of command `ID`.
+     */
+    template <uint16_t ID>
+    status_t subscribe(const sub_func<ID> &func, const uint32_t owner)
+    {
+        auto &slot      = std::get<index_of<ID>()>(_slots);
+        status_t status = PYRO_NO_MEMORY;
+        taskENTER_CRITICAL();
+        if (slot.sub_num < MAX_SUBSCRIBER_NUM)
+        {
+            slot.subs[slot.sub_num].owner = owner;
+            slot.subs[slot.sub_num].func  = func;
+            slot.sub_num++;
+            status = PYRO_OK;
+        }
+        taskEXIT_CRITICAL();
+        return status;
+    }
+
+    /**
+     * @brief Removes the subscriber of command `ID` registered by `owner`.
+     */
+    template <uint16_t ID> status_t unsubscribe(const uint32_t owner)
+    {
+        auto &slot      = std::get<index_of<ID>()>(_slots);
+        status_t status = PYRO_NOT_FOUND;
+        taskENTER_CRITICAL();
+        for (uint8_t i = 0; i < slot.sub_num; i++)
+        {
+            if (slot.subs[i].owner == owner)
+            {
+                for (uint8_t j = i; j + 1 < slot.sub_num; j++)
+                {
+                    slot.subs[j] = slot.subs[j + 1];
+                }
+                slot.sub_num--;
+                status = PYRO_OK;
+                break;
+            }
+        }
+        taskEXIT_CRITICAL();
+        return status;
+    }
+
+    /**
+     * @brief Stores a received payload and notifies its subscribers;
+     *        shorter payloads are zero-padded.
+     * @return false for an unknown command ID.
+     */
+    bool update(const uint16_t id, const uint8_t *payload, const uint16_t len,
+                const uint32_t stamp)
+    {
+        const cmd_entry_t *entry = find(id);
+        if (nullptr == entry)
+            return false;
+        entry->write(*this, payload, len, stamp);
+        return true;
+    }
+
+  private:
+    template <typename T> struct sample_t
+    {
+        T data;
+        uint32_t stamp;
+    };
+
+    template <typename CMD> struct slot_t
+    {
+        struct sub_t
+        {
+            uint32_t owner;
+            sub_func<CMD::id> func;
+        };
+
+        seqlatch_t<sample_t<typename CMD::type>> latch;
+        std::array<sub_t, MAX_SUBSCRIBER_NUM> subs{};
+        uint8_t sub_num{};
+    };
+
+    template <size_t... I>
+    static constexpr std::array<cmd_entry_t, CMD_NUM>
+    make_table(std::index_sequence<I...>)
+    {
+        std::array<cmd_entry_t, CMD_NUM> table = {
+            {{cmd_at<I>::id, static_cast<uint16_t>(I),
+              static_cast<uint16_t>(sizeof(typename cmd_at<I>::type)),
+              &write<I>}...}};
+        // Insertion sort by ID for the binary search
+        for (size_t i = 1; i < CMD_NUM; i++)
+        {
+            for (size_t j = i; j > 0 && table[j].id < table[j - 1].id; j--)
+            {
+                const cmd_entry_t tmp = table[j];
+                table[j]              = table[j - 1];
+                table[j - 1]          = tmp;
+            }
+        }
+        return table;
+    }
+
+    static constexpr bool ids_unique()
+    {
+        constexpr uint16_t ids[] = {CMDS::id...};
+        for (size_t i = 0; i < CMD_NUM; i++)
+        {
+            for (size_t j = i + 1; j < CMD_NUM; j++)
+            {
+                if (ids[i] == ids[j])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(CMD_NUM > 0, "referee_store_base_t needs commands");
+    static_assert(ids_unique(), "duplicate referee command ID");
+
+    template <size_t I>
+    static void write(referee_store_base_t &self, const uint8_t *payload,
+                      const uint16_t len, const uint32_t stamp)
+    {
+        auto &slot = std::get<I>(self._slots);
+        sample_t<typename cmd_at<I>::type> sample{};
+        memcpy(&sample.data, payload,
+               len < sizeof(sample.data) ? len : sizeof(sample.data));
+        sample.stamp = stamp;
+        slot.latch.write(sample);
+
+        // Snapshot the list so (un)subscribing never races the calls
+        decltype(slot.subs) subs;
+        taskENTER_CRITICAL();
+        const uint8_t sub_num = slot.sub_num;
+        subs                  = slot.subs;
+        taskEXIT_CRITICAL();
+
+        const referee_meta_t meta = {stamp, slot.latch.get_sequence()};
+        for (uint8_t i = 0; i < sub_num; i++)
+        {
+            subs[i].func(sample.data, meta);
+        }
+    }
+
+    std::tuple<slot_t<CMDS>...> _slots;
+};
+
+class referee_store_t
+    : public referee_store_base_t<
+          referee_cmd_t<GAME_STATE_CMD_ID, game_status_t>,
+          referee_cmd_t<GAME_RESULT_CMD_ID, game_result_t>,
+          referee_cmd_t<GAME_ROBOT_HP_CMD_ID, ext_game_robot_HP_t>,
+          referee_cmd_t<FIELD_EVENTS_CMD_ID, event_data_t>,
+          referee_cmd_t<SUPPLY_PROJECTILE_ACTION_CMD_ID,
+                        ext_supply_projectile_action_t>,
+          referee_cmd_t<REFEREE_WARNING_CMD_ID, referee_warning_t>,
+          referee_cmd_t<ROBOT_STATE_CMD_ID, robot_status_t>,
+          referee_cmd_t<POWER_HEAT_DATA_CMD_ID, power_heat_data_t>,
+          referee_cmd_t<ROBOT_POS_CMD_ID, robot_pos_t>,
+          referee_cmd_t<BUFF_MUSK_CMD_ID, buff_t>,
+          referee_cmd_t<ROBOT_HURT_CMD_ID, hurt_data_t>,
+          referee_cmd_t<SHOOT_DATA_CMD_ID, shoot_data_t>,
+          referee_cmd_t<BULLET_REMAINING_CMD_ID, projectile_allowance_t>,
+          referee_cmd_t<ROBOT_RFID_CMD_ID, rfid_status_t>,
+          referee_cmd_t<SENTRY_MATE_POS_CMD_ID, ground_robot_position_t>,
+          referee_cmd_t<SENTRY_SELF_DECISION_CMD_ID, sentry_info_t>,
+          referee_cmd_t<STUDENT_INTERACTIVE_DATA_CMD_ID,
+                        robot_interaction_data_t>,
+          referee_cmd_t<TINY_MAP_RECEIVE_SENTRY_CMD_ID, map_data_t>>
+{
+  public:
+    static referee_store_t *get_instance();
+};
+} // namespace pyro
+
+#endif
@@ -0,0 +1,115 @@
+#include "referee_tx.h"
+
+#include "pyro_core_config.h"
+#include "pyro_dma_buffer.h"
+
+namespace pyro
+{
+namespace
+{
+// Only one frame is in flight, and there is only one instance
+PYRO_DMA_STATIC uint8_t
+    referee_tx_frame[dma_cache_round_up(referee_tx_sched_t::FRAME_MAX_SIZE)];
+} // namespace
+
+referee_tx_t *referee_tx_t::get_instance()
+{
+    static referee_tx_t instance;
+    return &instance;
+}
+
+referee_tx_t::referee_tx_t()
+    : _sched({REFEREE_TX_RATE, REFEREE_TX_BURST, REFEREE_TX_MIN_INTERVAL_MS}),
+      _uart(uart_drv_t::get_instance(uart_drv_t::uart1)), _busy(false)
+{
+    referee_store_t::get_instance()->subscribe<ROBOT_STATE_CMD_ID>(
+        referee_store_t::sub_func<ROBOT_STATE_CMD_ID>::bind<
+            referee_tx_t, &referee_tx_t::on_robot_status>(this),
+        reinterpret_cast<uint32_t>(this));
+}
+
+status_t referee_tx_t::set_figure(const ui_figure_t &figure,
+                                  const uint8_t priority)
+{
+    scoped_mutex_t lock(_mutex);
+    return _sched.set_figure(figure, priority);
+}
+
+status_t referee_tx_t::set_text(const ui_figure_t &figure, const char *text,
+                                const uint8_t len, const uint8_t priority)
+{
+    scoped_mutex_t lock(_mutex);
+    return _sched.set_text(figure, text, len, priority);
+}
+
+status_t referee_tx_t::remove(const uint8_t name[3])
+{
+    scoped_mutex_t lock(_mutex);
+    return _sched.remove(name);
+}
+
+void referee_tx_t::resync()
+{
+    scoped_mutex_t lock(_mutex);
+    _sched.resync();
+}
+
+status_t referee_tx_t::post(const uint16_t data_cmd_id,
+                            const uint16_t receiver, const uint8_t *data,
+                            const uint16_t len, const uint8_t priority)
+{
+    scoped_mutex_t lock(_mutex);
+    return _sched.post(data_cmd_id, receiver, data, len, priority);
+}
+
+referee_tx_sched_t::stats_t referee_tx_t::get_stats()
+{
+    scoped_mutex_t lock(_mutex);
+    return _sched.get_stats();
+}
+
+void referee_tx_t::on_robot_status(const robot_status_t &status,
+                                   const referee_meta_t &)
+{
+    scoped_mutex_t lock(_mutex);
+    _sched.set_robot_id(status.robot_id);
+}
+
+void referee_tx_t::on_tx_done(BaseType_t &)
+{
+    _busy.store(false, std::memory_order_release);
+}
+
+void referee_tx_t::poll()
+{
+    if (_busy.load(std::memory_order_acquire) || nullptr == _uart)
+    {
+        return;
+    }
+    uint16_t len = 0;
+    {
+        scoped_mutex_t lock(_mutex);
+        len = _sched.poll(xTaskGetTickCount() * portTICK_PERIOD_MS,
+                          referee_tx_frame);
+    }
+    if (0 == len)
+    {
+        return;
+    }
+    _busy.store(true, std::memory_order_relaxed);
+    const uart_tx_seg_t seg = {referee_tx_frame, len};
+    if (PYRO_OK !=
+        _uart->write_frame(
+            &seg, 1,
+            uart_drv_t::tx_done_func::bind<referee_tx_t,
+                                           &referee_tx_t::on_tx_done>(this)))
+    {
+        _busy.store(false, std::memory_order_relaxed);
+    }
+}
+} // namespace pyro
+
+extern "C" void referee_tx_poll(void)
+{
+    pyro::referee_tx_t::get_instance()->poll();
+}
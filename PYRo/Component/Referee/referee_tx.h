@@ -0,0 +1,56 @@
+#ifndef PYRO_REFEREE_TX_H
+#define PYRO_REFEREE_TX_H
+
+#include "pyro_mutex.h"
+#include "pyro_uart_drv.h"
+#include "referee_store.h"
+#include "referee_tx_sched.h"
+
+#include <atomic>
+
+namespace pyro
+{
+/**
+ * @brief Referee client TX on UART1: a locked referee_tx_sched_t fed from
+ *        any task and drained by the referee task.
+ *
+ * One frame is in flight at a time; the next one is only built after the
+ * DMA finished, so the frame buffer needs no copy. It is a static buffer in
+ * RAM_D2 (PYRO_DMA_STATIC) because the instance itself may live in DTCM. The
+ * sender ID follows ROBOT_STATE_CMD_ID from the referee store.
+ */
+class referee_tx_t
+{
+  public:
+    static referee_tx_t *get_instance();
+
+    status_t set_figure(const ui_figure_t &figure, uint8_t priority);
+    status_t set_text(const ui_figure_t &figure, const char *text, uint8_t len,
+                      uint8_t priority);
+    status_t remove(const uint8_t name[3]);
+    void resync();
+    status_t post(uint16_t data_cmd_id, uint16_t receiver, const uint8_t *data,
+                  uint16_t len, uint8_t priority);
+
+    /**
+     * @brief Sends the next frame if one is due; referee task only.
+     */
+    void poll();
+
+    referee_tx_sched_t::stats_t get_stats();
+
+  private:
+    referee_tx_t();
+
+    void on_robot_status(const robot_status_t &status,
+                         const referee_meta_t &meta);
+    void on_tx_done(BaseType_t &woken);
+
+    mutex_t _mutex;
+    referee_tx_sched_t _sched;
+    uart_drv_t *_uart;
+    std::atomic<bool> _busy;
+};
+} // namespace pyro
+
+#endif
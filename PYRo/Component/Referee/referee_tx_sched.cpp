@@ -0,0 +1,471 @@
+#include "referee_tx_sched.h"
+
+#include "protocol.h"
+#include "pyro_crc.h"
+
+#include <cstring>
+
+namespace pyro
+{
+static constexpr uint8_t UI_OPERATE_ADD    = 1;
+static constexpr uint8_t UI_OPERATE_MODIFY = 2;
+static constexpr uint8_t UI_OPERATE_DELETE = 3;
+
+// Offsets inside a 0x0301 frame
+static constexpr uint16_t FRAME_LEN_OFFSET      = 1;
+static constexpr uint16_t FRAME_SEQ_OFFSET      = 3;
+static constexpr uint16_t FRAME_CMD_OFFSET      = 5;
+static constexpr uint16_t FRAME_DATA_CMD_OFFSET = 7;
+static constexpr uint16_t FRAME_SENDER_OFFSET   = 9;
+static constexpr uint16_t FRAME_RECEIVER_OFFSET = 11;
+static constexpr uint16_t FRAME_CONTENT_OFFSET  = 13;
+
+static void put_u16(uint8_t *p, const uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v & 0xff);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+/**
+ * @brief Smallest figure frame that holds `num` figures.
+ */
+static uint8_t figure_group(const uint8_t num)
+{
+    return num <= 1 ? 1 : num <= 2 ? 2 : num <= 5 ? 5 : 7;
+}
+
+static uint16_t figure_group_cmd(const uint8_t group)
+{
+    switch (group)
+    {
+    case 1:
+        return REFEREE_UI_FIGURE1_CMD;
+    case 2:
+        return REFEREE_UI_FIGURE2_CMD;
+    case 5:
+        return REFEREE_UI_FIGURE5_CMD;
+    default:
+        return REFEREE_UI_FIGURE7_CMD;
+    }
+}
+
+referee_tx_sched_t::referee_tx_sched_t(const config_t &config)
+    : _config(config), _elements(), _msgs(), _msg_order(0), _robot_id(0),
+      _seq(0), _tokens(0), _last_refill(0), _last_tx(0), _clock_valid(false),
+      _has_sent(false), _stats()
+{
+}
+
+void referee_tx_sched_t::set_robot_id(const uint16_t robot_id)
+{
+    if (robot_id != _robot_id)
+    {
+        // A new identity means a new client: the UI must be added again
+        _robot_id = robot_id;
+        resync();
+    }
+}
+
+/* UI state ------------------------------------------------------------------*/
+referee_tx_sched_t::element_t *referee_tx_sched_t::find(const uint8_t name[3])
+{
+    for (auto &element : _elements)
+    {
+        if (element.used && 0 == memcmp(element.figure.name, name, 3))
+        {
+            return &element;
+        }
+    }
+    return nullptr;
+}
+
+referee_tx_sched_t::element_t *
+referee_tx_sched_t::acquire(const uint8_t name[3])
+{
+    element_t *element = find(name);
+    if (element)
+    {
+        return element;
+    }
+    for (auto &slot : _elements)
+    {
+        if (!slot.used)
+        {
+            slot      = element_t();
+            slot.used = 1;
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+status_t referee_tx_sched_t::set_element(const ui_figure_t &figure,
+                                         const char *text, const uint8_t len,
+                                         const bool is_text,
+                                         const uint8_t priority)
+{
+    if (len > MAX_TEXT_LEN || (len && nullptr == text))
+    {
+        return PYRO_PARAM_ERROR;
+    }
+    element_t *element = acquire(figure.name);
+    if (nullptr == element)
+    {
+        return PYRO_NO_MEMORY;
+    }
+
+    ui_figure_t wanted  = figure;
+    wanted.operate_type = 0;
+    char wanted_text[MAX_TEXT_LEN] = {};
+    if (len)
+    {
+        memcpy(wanted_text, text, len);
+    }
+
+    element->priority = priority < PRIORITY_NUM ? priority : PRIORITY_NUM - 1;
+    if (element->on_client && !element->removing &&
+        element->is_text == is_text &&
+        0 == memcmp(&element->figure, &wanted, sizeof(wanted)) &&
+        0 == memcmp(element->text, wanted_text, MAX_TEXT_LEN))
+    {
+        _stats.unchanged++;
+        return PYRO_OK;
+    }
+
+    element->figure   = wanted;
+    element->text_len = len;
+    memcpy(element->text, wanted_text, MAX_TEXT_LEN);
+    element->is_text  = is_text;
+    element->removing = 0;
+    element->dirty    = 1;
+    return PYRO_OK;
+}
+
+status_t referee_tx_sched_t::set_figure(const ui_figure_t &figure,
+                                        const uint8_t priority)
+{
+    return set_element(figure, nullptr, 0, false, priority);
+}
+
+status_t referee_tx_sched_t::set_text(const ui_figure_t &figure,
+                                      const char *text, const uint8_t len,
+                                      const uint8_t priority)
+{
+    ui_figure_t with_len = figure;
+    with_len.details_b   = len; // character count
+    return set_element(with_len, text, len, true, priority);
+}
+
+status_t referee_tx_sched_t::remove(const uint8_t name[3])
+{
+    element_t *element = find(name);
+    if (nullptr == element)
+    {
+        return PYRO_NOT_FOUND;
+    }
+    if (!element->on_client)
+    {
+        element->used = 0;
+        return PYRO_OK;
+    }
+    element->removing = 1;
+    element->dirty    = 1;
+    return PYRO_OK;
+}
+
+void referee_tx_sched_t::resync()
+{
+    for (auto &element : _elements)
+    {
+        if (!element.used)
+        {
+            continue;
+        }
+        if (element.removing)
+        {
+            element.used = 0;
+            continue;
+        }
+        element.on_client = 0;
+        element.dirty     = 1;
+    }
+}
+
+/* Messages ------------------------------------------------------------------*/
+status_t referee_tx_sched_t::post(const uint16_t data_cmd_id,
+                                  const uint16_t receiver, const uint8_t *data,
+                                  const uint16_t len, const uint8_t priority)
+{
+    if (len > MAX_MSG_LEN || (len && nullptr == data))
+    {
+        return PYRO_PARAM_ERROR;
+    }
+    for (auto &msg : _msgs)
+    {
+        if (!msg.used)
+        {
+            msg.used        = true;
+            msg.order       = _msg_order++;
+            msg.data_cmd_id = data_cmd_id;
+            msg.receiver    = receiver;
+            msg.len         = len;
+            msg.priority = priority < PRIORITY_NUM ? priority : PRIORITY_NUM - 1;
+            if (len)
+            {
+                memcpy(msg.data, data, len);
+            }
+            return PYRO_OK;
+        }
+    }
+    _stats.msg_dropped++;
+    return PYRO_NO_MEMORY;
+}
+
+/* Selection -----------------------------------------------------------------*/
+int referee_tx_sched_t::best_msg() const
+{
+    int best = -1;
+    for (size_t i = 0; i < MAX_MSG_NUM; i++)
+    {
+        const msg_t &msg = _msgs[i];
+        if (!msg.used)
+        {
+            continue;
+        }
+        if (best < 0 || msg.priority < _msgs[best].priority ||
+            (msg.priority == _msgs[best].priority &&
+             static_cast<int32_t>(msg.order - _msgs[best].order) < 0))
+        {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+int referee_tx_sched_t::best_text() const
+{
+    int best = -1;
+    for (size_t i = 0; i < MAX_UI_NUM; i++)
+    {
+        const element_t &element = _elements[i];
+        if (element.used && element.dirty && element.is_text &&
+            !element.removing &&
+            (best < 0 || element.priority < _elements[best].priority))
+        {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Picks up to FIGURE_BATCH_MAX dirty figures, best priority first.
+ * Deleting a text is a figure operation too, so it rides in the batch.
+ */
+uint8_t referee_tx_sched_t::collect_figures(figure_batch_t &index) const
+{
+    uint8_t num = 0;
+    for (uint8_t priority = 0; priority < PRIORITY_NUM; priority++)
+    {
+        for (uint8_t i = 0; i < MAX_UI_NUM && num < FIGURE_BATCH_MAX; i++)
+        {
+            const element_t &element = _elements[i];
+            if (element.used && element.dirty &&
+                (!element.is_text || element.removing) &&
+                element.priority == priority)
+            {
+                index[num++] = i;
+            }
+        }
+    }
+    return num;
+}
+
+bool referee_tx_sched_t::pending() const
+{
+    if (best_msg() >= 0)
+    {
+        return true;
+    }
+    for (const auto &element : _elements)
+    {
+        if (element.used && element.dirty)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Frames --------------------------------------------------------------------*/
+uint16_t referee_tx_sched_t::finish(uint8_t *frame, const uint16_t data_cmd_id,
+                                    const uint16_t receiver,
+                                    const uint16_t content_len)
+{
+    const uint16_t total = FRAME_OVERHEAD + content_len;
+    frame[0]             = HEADER_SOF;
+    put_u16(frame + FRAME_LEN_OFFSET, static_cast<uint16_t>(6 + content_len));
+    frame[FRAME_SEQ_OFFSET] = _seq++;
+    crc8_append(frame, REF_PROTOCOL_HEADER_SIZE);
+    put_u16(frame + FRAME_CMD_OFFSET, STUDENT_INTERACTIVE_DATA_CMD_ID);
+    put_u16(frame + FRAME_DATA_CMD_OFFSET, data_cmd_id);
+    put_u16(frame + FRAME_SENDER_OFFSET, _robot_id);
+    put_u16(frame + FRAME_RECEIVER_OFFSET, receiver);
+    crc16_append(frame, total);
+    return total;
+}
+
+void referee_tx_sched_t::sent(element_t &element)
+{
+    _stats.figures++;
+    if (element.removing)
+    {
+        element.used = 0;
+        return;
+    }
+    element.dirty     = 0;
+    element.on_client = 1;
+}
+
+uint16_t referee_tx_sched_t::build_msg(msg_t &msg, uint8_t *frame)
+{
+    memcpy(frame + FRAME_CONTENT_OFFSET, msg.data, msg.len);
+    msg.used = false;
+    return finish(frame, msg.data_cmd_id, msg.receiver, msg.len);
+}
+
+uint16_t referee_tx_sched_t::build_figures(const figure_batch_t &index,
+                                           const uint8_t num, uint8_t *frame)
+{
+    const uint8_t group = figure_group(num);
+    uint8_t *p          = frame + FRAME_CONTENT_OFFSET;
+    // Padding figures keep operate_type 0, which the client ignores
+    memset(p, 0, group * sizeof(ui_figure_t));
+    for (uint8_t i = 0; i < num; i++)
+    {
+        element_t &element  = _elements[index[i]];
+        ui_figure_t figure  = element.figure;
+        figure.operate_type = element.removing    ? UI_OPERATE_DELETE
+                              : element.on_client ? UI_OPERATE_MODIFY
+                                                  : UI_OPERATE_ADD;
+        memcpy(p + i * sizeof(ui_figure_t), &figure, sizeof(figure));
+        sent(element);
+    }
+    return finish(frame, figure_group_cmd(group), 0x0100 + _robot_id,
+                  group * sizeof(ui_figure_t));
+}
+
+uint16_t referee_tx_sched_t::build_text(element_t &element, uint8_t *frame)
+{
+    ui_figure_t figure  = element.figure;
+    figure.operate_type = element.on_client ? UI_OPERATE_MODIFY : UI_OPERATE_ADD;
+    uint8_t *p          = frame + FRAME_CONTENT_OFFSET;
+    memcpy(p, &figure, sizeof(figure));
+    memcpy(p + sizeof(figure), element.text, MAX_TEXT_LEN);
+    sent(element);
+    return finish(frame, REFEREE_UI_CHAR_CMD, 0x0100 + _robot_id,
+                  sizeof(figure) + MAX_TEXT_LEN);
+}
+
+/* Pacing --------------------------------------------------------------------*/
+void referee_tx_sched_t::refill(const uint32_t now)
+{
+    const uint32_t full = _config.burst * 1000;
+    if (!_clock_valid)
+    {
+        _clock_valid = true;
+        _last_refill = now;
+        _tokens      = full;
+        return;
+    }
+    const uint32_t dt = now - _last_refill;
+    _last_refill      = now;
+    // Compare before multiplying so a long idle gap cannot overflow
+    if (_config.rate && dt >= (full - _tokens) / _config.rate)
+    {
+        _tokens = full;
+    }
+    else
+    {
+        _tokens += dt * _config.rate;
+    }
+}
+
+uint16_t referee_tx_sched_t::poll(const uint32_t now, uint8_t *frame)
+{
+    refill(now);
+    if (0 == _robot_id || nullptr == frame)
+    {
+        return 0;
+    }
+    if (_has_sent && now - _last_tx < _config.min_interval)
+    {
+        return 0;
+    }
+
+    const int msg  = best_msg();
+    const int text = best_text();
+    figure_batch_t index{};
+    const uint8_t num = collect_figures(index);
+
+    const uint8_t msg_priority =
+        msg >= 0 ? _msgs[msg].priority : PRIORITY_NUM;
+    const uint8_t figure_priority =
+        num ? _elements[index[0]].priority : PRIORITY_NUM;
+    const uint8_t text_priority =
+        text >= 0 ? _elements[text].priority : PRIORITY_NUM;
+
+    enum
+    {
+        pick_none,
+        pick_msg,
+        pick_figures,
+        pick_text
+    } pick = pick_none;
+    uint16_t len = 0;
+    if (msg >= 0 && msg_priority <= figure_priority &&
+        msg_priority <= text_priority)
+    {
+        pick = pick_msg;
+        len  = FRAME_OVERHEAD + _msgs[msg].len;
+    }
+    else if (num && figure_priority <= text_priority)
+    {
+        pick = pick_figures;
+        len  = FRAME_OVERHEAD + figure_group(num) * sizeof(ui_figure_t);
+    }
+    else if (text >= 0)
+    {
+        pick = pick_text;
+        len  = FRAME_OVERHEAD + sizeof(ui_figure_t) + MAX_TEXT_LEN;
+    }
+    if (pick_none == pick)
+    {
+        return 0;
+    }
+    if (_tokens < len * 1000U)
+    {
+        _stats.deferred++;
+        return 0;
+    }
+
+    switch (pick)
+    {
+    case pick_msg:
+        len = build_msg(_msgs[msg], frame);
+        break;
+    case pick_figures:
+        len = build_figures(index, num, frame);
+        break;
+    default:
+        len = build_text(_elements[text], frame);
+        break;
+    }
+    _tokens -= len * 1000U;
+    _last_tx  = now;
+    _has_sent = true;
+    _stats.frames++;
+    _stats.bytes += len;
+    return len;
+}
+} // namespace pyro
@@ -0,0 +1,194 @@
+#ifndef PYRO_REFEREE_TX_SCHED_H
+#define PYRO_REFEREE_TX_SCHED_H
+
+#include "pyro_core_def.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/* Client protocol -----------------------------------------------------------*/
+static constexpr uint16_t REFEREE_UI_DELETE_CMD  = 0x0100;
+static constexpr uint16_t REFEREE_UI_FIGURE1_CMD = 0x0101;
+static constexpr uint16_t REFEREE_UI_FIGURE2_CMD = 0x0102;
+static constexpr uint16_t REFEREE_UI_FIGURE5_CMD = 0x0103;
+static constexpr uint16_t REFEREE_UI_FIGURE7_CMD = 0x0104;
+static constexpr uint16_t REFEREE_UI_CHAR_CMD    = 0x0110;
+
+/**
+ * @brief One UI graphic (interaction_figure_t of the referee protocol).
+ *
+ * `operate_type` is filled in by the scheduler (add / modify / delete);
+ * whatever the caller sets there is ignored.
+ */
+struct __attribute__((packed)) ui_figure_t
+{
+    uint8_t name[3];
+    uint32_t operate_type : 3;
+    uint32_t figure_type : 3;
+    uint32_t layer : 4;
+    uint32_t color : 4;
+    uint32_t details_a : 9;
+    uint32_t details_b : 9;
+    uint32_t width : 10;
+    uint32_t start_x : 11;
+    uint32_t start_y : 11;
+    uint32_t details_c : 10;
+    uint32_t details_d : 11;
+    uint32_t details_e : 11;
+};
+static_assert(sizeof(ui_figure_t) == 15, "ui_figure_t layout");
+
+/**
+ * @brief Client-side TX scheduler of the referee link (cmd 0x0301).
+ *
+ * Keeps the wanted UI state plus a small queue of robot interaction
+ * messages and turns them into at most one frame per `poll()`:
+ * - UI elements are keyed by their 3-byte name. A `set_*` call that does
+ *   not change the element is dropped, so only changed elements go out.
+ * - Changed figures are batched into one 1/2/5/7-figure frame, padded
+ *   with no-op figures; texts go out one per frame.
+ * - Messages and UI elements carry a priority (0 = highest); the best one
+ *   goes first, messages win ties, equal messages leave in FIFO order.
+ * - A token bucket in bytes/s plus a minimum frame interval gate every
+ *   frame; an unaffordable head frame waits instead of being overtaken.
+ *
+ * Pure logic: the caller passes the clock to `poll()`, no locks and no
+ * HAL, so the whole scheduler runs on a host with a virtual clock.
+ */
+class referee_tx_sched_t
+{
+  public:
+    static constexpr uint8_t MAX_UI_NUM       = 32;
+    static constexpr uint8_t MAX_MSG_NUM      = 4;
+    static constexpr uint16_t MAX_MSG_LEN     = 112;
+    static constexpr uint8_t MAX_TEXT_LEN     = 30;
+    static constexpr uint8_t PRIORITY_NUM     = 4;
+    static constexpr uint8_t FIGURE_BATCH_MAX = 7;
+    // SOF | len | seq | CRC8 | cmd_id | data_cmd_id | sender | receiver | CRC16
+    static constexpr uint16_t FRAME_OVERHEAD = 5 + 2 + 6 + 2;
+    static constexpr uint16_t FRAME_MAX_SIZE = FRAME_OVERHEAD + MAX_MSG_LEN;
+
+    struct config_t
+    {
+        uint32_t rate;         // sustained budget, bytes/s
+        uint32_t burst;        // bucket depth, bytes (>= FRAME_MAX_SIZE)
+        uint32_t min_interval; // minimum gap between frames, ms
+    };
+
+    struct stats_t
+    {
+        uint32_t frames;
+        uint32_t bytes;
+        uint32_t figures;     // figures and texts sent
+        uint32_t unchanged;   // set_* calls dropped by the diff
+        uint32_t deferred;    // polls that had a frame but no budget
+        uint32_t msg_dropped; // post() on a full queue
+    };
+
+    explicit referee_tx_sched_t(const config_t &config);
+
+    /**
+     * @brief Sender robot ID; the UI goes to its own client. Nothing is
+     *        sent while it is 0 (unknown).
+     */
+    void set_robot_id(uint16_t robot_id);
+
+    status_t set_figure(const ui_figure_t &figure, uint8_t priority);
+    status_t set_text(const ui_figure_t &figure, const char *text,
+                      uint8_t len, uint8_t priority);
+    /**
+     * @brief Deletes an element from the client, by name.
+     */
+    status_t remove(const uint8_t name[3]);
+    /**
+     * @brief Marks every element as unknown to the client (e.g. after the
+     *        client restarted) so all of them are added again.
+     */
+    void resync();
+
+    /**
+     * @brief Queues one robot interaction message.
+     */
+    status_t post(uint16_t data_cmd_id, uint16_t receiver, const uint8_t *data,
+                  uint16_t len, uint8_t priority);
+
+    /**
+     * @brief Builds the next frame if the budget allows.
+     * @param now  current time, ms (wraps)
+     * @param frame output, at least FRAME_MAX_SIZE bytes
+     * @return frame length, 0 if nothing is due.
+     */
+    uint16_t poll(uint32_t now, uint8_t *frame);
+
+    /**
+     * @brief True if anything waits for transmission.
+     */
+    bool pending() const;
+
+    const stats_t &get_stats() const
+    {
+        return _stats;
+    }
+
+  private:
+    struct element_t
+    {
+        ui_figure_t figure;
+        char text[MAX_TEXT_LEN];
+        uint8_t text_len;
+        uint8_t priority;
+        uint8_t used      : 1;
+        uint8_t is_text   : 1;
+        uint8_t dirty     : 1;
+        uint8_t on_client : 1;
+        uint8_t removing  : 1;
+    };
+
+    struct msg_t
+    {
+        uint32_t order;
+        uint16_t data_cmd_id;
+        uint16_t receiver;
+        uint16_t len;
+        uint8_t priority;
+        bool used;
+        uint8_t data[MAX_MSG_LEN];
+    };
+
+    using figure_batch_t = std::array<uint8_t, FIGURE_BATCH_MAX>;
+
+    element_t *find(const uint8_t name[3]);
+    element_t *acquire(const uint8_t name[3]);
+    status_t set_element(const ui_figure_t &figure, const char *text,
+                         uint8_t len, bool is_text, uint8_t priority);
+    void refill(uint32_t now);
+    int best_msg() const;
+    int best_text() const;
+    uint16_t build_msg(msg_t &msg, uint8_t *frame);
+    uint8_t collect_figures(figure_batch_t &index) const;
+    uint16_t build_figures(const figure_batch_t &index, uint8_t num,
+                           uint8_t *frame);
+    uint16_t build_text(element_t &element, uint8_t *frame);
+    uint16_t finish(uint8_t *frame, uint16_t data_cmd_id, uint16_t receiver,
+                    uint16_t content_len);
+    void sent(element_t &element);
+
+    const config_t _config;
+    std::array<element_t, MAX_UI_NUM> _elements;
+    std::array<msg_t, MAX_MSG_NUM> _msgs;
+    uint32_t _msg_order;
+    uint16_t _robot_id;
+    uint8_t _seq;
+    uint32_t _tokens; // milli-bytes
+    uint32_t _last_refill;
+    uint32_t _last_tx;
+    bool _clock_valid;
+    bool _has_sent;
+    stats_t _stats;
+};
+} // namespace pyro
+
+#endif
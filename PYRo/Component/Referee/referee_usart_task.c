@@ -19,16 +19,12 @@
 #include "fifo.h"
 #include "main.h"
 #include "protocol.h"
+#include "pyro_core_config.h"
 #include "referee.h"
 
 
 /**
- * @brief          single byte upacked
- * @param[in]      void
- * @retval         none
- */
-/**
-  * @brief          µ¥ז½ڽⰼ
+  * @brief          parse the fifo in place, one contiguous block at a time
   * @param[in]      void
   * @retval         none
   */
@@ -49,19 +45,25 @@ extern DMA_HandleTypeDef hdma_usart10_tx;
 
 fifo_s_t referee_fifo;
 uint8_t referee_fifo_buf[REFEREE_FIFO_BUF_LENGTH];
-unpack_data_t referee_unpack_obj;
+static TaskHandle_t referee_task_handle = NULL;
 	
 extern void referee_init();
+extern void referee_frame_feed(const uint8_t *buf, uint16_t len);
+extern void referee_tx_poll(void);
 
 void referee_usart_task(void* argument)
 {
     init_referee_struct_data();
     fifo_s_init(&referee_fifo, referee_fifo_buf, REFEREE_FIFO_BUF_LENGTH);
+    referee_task_handle = xTaskGetCurrentTaskHandle();
     referee_init();
     while(1)
     {
+        // woken by referee_rx_handler as soon as new bytes are queued, and
+        // at least every REFEREE_TX_POLL_MS to pace the client TX
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REFEREE_TX_POLL_MS));
         referee_unpack_fifo_data();
-        vTaskDelay(10);
+        referee_tx_poll();
     }
 
 }
@@ -70,122 +72,29 @@ void referee_usart_task(void* argument)
 
 
 
-uint32_t seqcount=0;
-sentry_desicion_making_t decision_send;
-uint8_t DECISION_BUF[100];
-
-
 /**
-  * @brief          single byte upacked 
-  * @param[in]      void
-  * @retval         none
-  */
-/**
-  * @brief          µ¥ז½ڽⰼ
+  * @brief          parse the fifo in place, one contiguous block at a time
   * @param[in]      void
   * @retval         none
   */
 void referee_unpack_fifo_data(void)
 {
-  uint8_t byte = 0;
-  uint8_t sof = HEADER_SOF;
-  unpack_data_t *p_obj = &referee_unpack_obj;
+  char *block;
+  int len;
 
-  while ( fifo_s_used(&referee_fifo) )
+  while ( (len = fifo_s_peek_block(&referee_fifo, &block)) > 0 )
   {
-    byte = fifo_s_get(&referee_fifo);
-    switch(p_obj->unpack_step)
-    {
-      case STEP_HEADER_SOF:
-      {
-        if(byte == sof)
-        {
-          p_obj->unpack_step = STEP_LENGTH_LOW;
-          p_obj->protocol_packet[p_obj->index++] = byte;
-        }
-        else
-        {
-          p_obj->index = 0;
-        }
-      }break;
-      
-      case STEP_LENGTH_LOW:
-      {
-        p_obj->data_len = byte;
-        p_obj->protocol_packet[p_obj->index++] = byte;
-        p_obj->unpack_step = STEP_LENGTH_HIGH;
-      }break;
-      
-      case STEP_LENGTH_HIGH:
-      {
-        p_obj->data_len |= (byte << 8);
-        p_obj->protocol_packet[p_obj->index++] = byte;
-
-        if(p_obj->data_len < (REF_PROTOCOL_FRAME_MAX_SIZE - REF_HEADER_CRC_CMDID_LEN))
-        {
-          p_obj->unpack_step = STEP_FRAME_SEQ;
-        }
-        else
-        {
-          p_obj->unpack_step = STEP_HEADER_SOF;
-          p_obj->index = 0;
-        }
-      }break;
-      case STEP_FRAME_SEQ:
-      {
-        p_obj->protocol_packet[p_obj->index++] = byte;
-        p_obj->unpack_step = STEP_HEADER_CRC8;
-      }break;
-
-      case STEP_HEADER_CRC8:
-      {
-        p_obj->protocol_packet[p_obj->index++] = byte;
-
-        if (p_obj->index == REF_PROTOCOL_HEADER_SIZE)
-        {
-          if ( verify_CRC8_check_sum(p_obj->protocol_packet, REF_PROTOCOL_HEADER_SIZE) )
-          {
-            p_obj->unpack_step = STEP_DATA_CRC16;
-          }
-          else
-          {
-            p_obj->unpack_step = STEP_HEADER_SOF;
-            p_obj->index = 0;
-          }
-        }
-      }break;  
-      
-      case STEP_DATA_CRC16:
-      {
-        if (p_obj->index < (REF_HEADER_CRC_CMDID_LEN + p_obj->data_len))
-        {
-           p_obj->protocol_packet[p_obj->index++] = byte;  
-        }
-        if (p_obj->index >= (REF_HEADER_CRC_CMDID_LEN + p_obj->data_len))
-        {
-          p_obj->unpack_step = STEP_HEADER_SOF;
-          p_obj->index = 0;
-
-          if ( verify_CRC16_check_sum(p_obj->protocol_packet, REF_HEADER_CRC_CMDID_LEN + p_obj->data_len) )
-          {
-            referee_data_solve(p_obj->protocol_packet);
-          }
-        }
-      }break;
-
-      default:
-      {
-        p_obj->unpack_step = STEP_HEADER_SOF;
-        p_obj->index = 0;
-      }break;
-    }
+    referee_frame_feed((const uint8_t *)block, (uint16_t)len);
+    fifo_s_discard(&referee_fifo, len);
   }
 }
 
 
-void referee_rx_handler(uint8_t *buf,uint16_t Size)
+void referee_rx_handler(uint8_t *buf,uint16_t Size, BaseType_t *woken)
 {
-        static uint16_t Rx_counter;
-	Rx_counter = Size;
-	fifo_s_puts(&referee_fifo, (char*)buf, Rx_counter);
+  fifo_s_puts(&referee_fifo, (char*)buf, Size);
+  if (referee_task_handle != NULL)
+  {
+    vTaskNotifyGiveFromISR(referee_task_handle, woken);
+  }
 }
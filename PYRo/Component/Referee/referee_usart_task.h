@@ -17,6 +17,7 @@
 #ifndef REFEREE_USART_TASK_H
 #define REFEREE_USART_TASK_H
 #include "main.h"
+#include "FreeRTOS.h"
 
 #define USART_RX_BUF_LENGHT     512
 #define REFEREE_FIFO_BUF_LENGTH 1024
@@ -33,6 +34,6 @@
   */
 extern void referee_usart_task(void* argument);
 void Referee_USART6_IRQHandler(void);
-extern void referee_rx_handler(uint8_t *buf,uint16_t Size);
+extern void referee_rx_handler(uint8_t *buf,uint16_t Size, BaseType_t *woken);
 
 #endif
@@ -1,14 +1,9 @@
 #ifndef STRUCT_TYPEDEF_H
 #define STRUCT_TYPEDEF_H
 
-typedef signed char int8_t;
-typedef signed short int int16_t;
-typedef signed long long int64_t;
+/* exact-width integer types, as the target toolchain defines them */
+#include <stdint.h>
 
-/* exact-width unsigned integer types */
-typedef unsigned char uint8_t;
-typedef unsigned short int uint16_t;
-typedef unsigned long long uint64_t;
 typedef unsigned char bool_t;
 typedef float fp32;
 typedef double fp64;
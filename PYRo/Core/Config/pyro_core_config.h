@@ -4,6 +4,76 @@
 #define DEMO_MODE 1
 #define DEBUG_MODE 1
 
+// CAN FD: sizes the TX queue for 64-byte frames. The FDCAN peripheral itself
+// must also be configured for FD (frame format, data bit timing, element size)
+#define CAN_FD_EN 0
+
+// CAN online monitor: scan period, and how many nominal periods a buffer may
+// miss before it is flagged offline
+#define CAN_MONITOR_PERIOD_MS 10
+#define CAN_MONITOR_TIMEOUT_FACTOR 20
+
+// Enable the Cortex-M7 I/D-cache at boot. Every DMA buffer must then be a
+// pyro::dma_buffer_t or be cleaned/invalidated around the transfer
+#define PYRO_DCACHE_EN 1
+
+// CRC-8/CRC-16: slice-by-N software kernel (1, 4 or 8 bytes per step), or the
+// STM32H7 CRC unit (self-checked against software at first use). The slice
+// can be set from the build; the host tests build all three
+#ifndef PYRO_CRC_SLICE
+#define PYRO_CRC_SLICE 4
+#endif
+#define PYRO_CRC_HW_EN 0
+
+// UART1 circular DMA ring (referee + VT03), bytes
+#define UART1_RX_RING_SIZE 512
+
+// Referee client TX (UI + robot interaction): sustained budget in bytes/s,
+// bucket depth in bytes (>= one 127-byte frame), minimum gap between frames
+// and the referee task's poll period
+#define REFEREE_TX_RATE 3000
+#define REFEREE_TX_BURST 256
+#define REFEREE_TX_MIN_INTERVAL_MS 34
+#define REFEREE_TX_POLL_MS 10
+
+// Named heap regions (pyro_mem_region.h), bytes; 0 disables a region and
+// reserves no RAM. DTCM is zero-wait but DMA-unreachable and shares its 128K
+// with the FreeRTOS heap and the stack; D2 is the DMA heap; D3 is the only
+// region BDMA can reach. Only D2 has users, so the others are off until
+// something allocates there. The sizes can be set from the build
+#ifndef PYRO_MEM_DTCM_HEAP_SIZE
+#define PYRO_MEM_DTCM_HEAP_SIZE 0
+#endif
+#ifndef PYRO_MEM_AXI_HEAP_SIZE
+#define PYRO_MEM_AXI_HEAP_SIZE 0
+#endif
+#ifndef PYRO_MEM_D2_HEAP_SIZE
+#define PYRO_MEM_D2_HEAP_SIZE (16 * 1024)
+#endif
+#ifndef PYRO_MEM_D3_HEAP_SIZE
+#define PYRO_MEM_D3_HEAP_SIZE 0
+#endif
+
+// Fixed-slot pools behind the class operator new of motors, PID controllers
+// and CAN RX buffers (pyro_pool.h). A full pool falls back to pvPortMalloc
+#define PYRO_POOL_MOTOR_NUM 16
+#define PYRO_POOL_PID_NUM 32
+#define PYRO_POOL_CAN_MSG_NUM 24
+
+// Static allocation: core tasks, message buffers and semaphores use static
+// storage (pyro_static_alloc.h), and pyro_init_thread locks the heap when it
+// finishes, so any later allocation trips configASSERT. Everything has to be
+// created during init; a chassis_base_t is brought up there with start()
+#define PYRO_STATIC_ALLOC_EN 0
+
+// Heap instrumentation (pyro_mem_trace.h): every heap and region-heap
+// allocation goes into a ring of PYRO_MEM_TRACE_DEPTH events (power of 2)
+// with call site, size and task; up to PYRO_MEM_TRACE_LIVE_NUM unfreed blocks
+// are kept for leak reports
+#define PYRO_MEM_TRACE_EN 0
+#define PYRO_MEM_TRACE_DEPTH 64
+#define PYRO_MEM_TRACE_LIVE_NUM 128
+
 #if DEMO_MODE
 
 #define RC_DEMO_EN 0
@@ -19,6 +89,11 @@
 
 #define VOFA_DEBUG_EN 0
 #define JCOM_DEBUG_EN 0
+// Heap and region statistics over uart1 every MEM_REPORT_PERIOD_MS, decoded
+// by PYRo/Debug/MEM/mem_report.py. Task stacks, allocation events and live
+// blocks are only reported with PYRO_MEM_TRACE_EN
+#define MEM_REPORT_DEBUG_EN 0
+#define MEM_REPORT_PERIOD_MS 1000
 
 #endif
 
@@ -0,0 +1,82 @@
+#ifndef DELEGATE_H
+#define DELEGATE_H
+#include <utility>
+namespace pyro
+{
+template <typename Sig> class delegate_t;
+
+/**
+ * @brief Non-owning, allocation-free callable reference.
+ *
+ * Holds an object pointer and a stub that forwards to a member or free
+ * function chosen at compile time, so a call is one indirect jump with no
+ * heap storage and no type-erased copy. The bound object must outlive the
+ * delegate.
+ *
+ * @code
+ * auto d = delegate_t<bool(int)>::bind<foo_t, &foo_t::on_event>(&foo);
+ * auto f = delegate_t<bool(int)>::bind<&on_event>();
+ * @endcode
+ */
+template <typename R, typename... Args> class delegate_t<R(Args...)>
+{
+    using stub_t = R (*)(void *, Args...);
+
+  public:
+    constexpr delegate_t() : _obj(nullptr), _stub(nullptr)
+    {
+    }
+
+    template <R (*F)(Args...)> static constexpr delegate_t bind()
+    {
+        return delegate_t(nullptr, &free_stub<F>);
+    }
+
+    template <typename C, R (C::*M)(Args...)>
+    static constexpr delegate_t bind(C *obj)
+    {
+        return delegate_t(obj, &member_stub<C, M>);
+    }
+
+    R operator()(Args... args) const
+    {
+        return _stub(_obj, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return nullptr != _stub;
+    }
+
+    bool operator==(const delegate_t &other) const
+    {
+        return _obj == other._obj && _stub == other._stub;
+    }
+
+    bool operator!=(const delegate_t &other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    constexpr delegate_t(void *obj, stub_t stub) : _obj(obj), _stub(stub)
+    {
+    }
+
+    template <R (*F)(Args...)> static R free_stub(void *, Args... args)
+    {
+        return F(std::forward<Args>(args)...);
+    }
+
+    template <typename C, R (C::*M)(Args...)>
+    static R member_stub(void *obj, Args... args)
+    {
+        return (static_cast<C *>(obj)->*M)(std::forward<Args>(args)...);
+    }
+
+    void *_obj;
+    stub_t _stub;
+};
+}; // namespace pyro
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef FRAME_PARSER_H
+#define FRAME_PARSER_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+namespace pyro
+{
+/**
+ * @brief Layout of a framed serial protocol.
+ *
+ * A frame is `SOF | header ... | payload | trailer`. `header_len` counts all
+ * bytes up to and including the header check; `check_header` runs over
+ * those. The total length comes from a little-endian length field at
+ * `len_offset` (`len_size` 1 or 2) plus `len_extra`, or is `fixed_len` when
+ * `len_size` is 0. `check_frame` runs over the whole frame. Either check may
+ * be nullptr.
+ *
+ * With `sof_len` 0 the stream has no sync pattern; frames are delimited by
+ * the caller (e.g. UART IDLE) via `reset()` before every chunk.
+ */
+struct frame_format_t
+{
+    using check_func = bool (*)(const uint8_t *p, uint16_t len);
+
+    uint8_t sof[2];
+    uint8_t sof_len;
+    uint16_t header_len;
+    uint16_t len_offset;
+    uint8_t len_size;
+    uint16_t len_extra;
+    uint16_t fixed_len;
+    uint16_t min_len;
+    check_func check_header;
+    check_func check_frame;
+};
+
+/**
+ * @brief Bulk frame parser for one `frame_format_t`.
+ *
+ * `feed` consumes arbitrary chunks. A frame that lies completely inside the
+ * chunk is validated and handed out in place; only a frame that spans two
+ * chunks is assembled in the internal buffer. Garbage is skipped with a
+ * `memchr` scan for the first SOF byte, and a rejected candidate restarts
+ * the scan one byte after its SOF, so a corrupted length or CRC never costs
+ * more than that candidate.
+ *
+ * No locks and no HAL: drive it from exactly one context.
+ */
+template <size_t MAX_LEN> class frame_parser_t
+{
+    static_assert(MAX_LEN >= 2, "frame_parser_t buffer too small");
+
+  public:
+    struct stats_t
+    {
+        uint32_t frames;
+        uint32_t rejected;
+        uint32_t skipped_bytes;
+    };
+
+    explicit frame_parser_t(const frame_format_t &format)
+        : _format(format), _buf(), _fill(0), _stats()
+    {
+    }
+
+    void reset()
+    {
+        _fill = 0;
+    }
+
+    const stats_t &stats() const
+    {
+        return _stats;
+    }
+
+    /**
+     * @brief Parses `len` bytes; `on_frame(const uint8_t *frame, uint16_t
+     *        len)` runs for every valid frame, in stream order.
+     * @return number of frames delivered.
+     */
+    template <typename F> size_t feed(const uint8_t *p, size_t len, F &&on_frame)
+    {
+        size_t frames = 0;
+        while (true)
+        {
+            if (0 == _fill)
+            {
+                if (0 == len)
+                    break;
+                const size_t skip = scan(p, len);
+                _stats.skipped_bytes += skip;
+                p += skip;
+                len -= skip;
+                if (0 == len)
+                    break;
+
+                size_t need        = 0;
+                const result_t ret = check(p, len, need);
+                if (result_ok == ret)
+                {
+                    on_frame(p, static_cast<uint16_t>(need));
+                    _stats.frames++;
+                    frames++;
+                    p += need;
+                    len -= need;
+                }
+                else if (result_bad == ret)
+                {
+                    _stats.rejected++;
+                    _stats.skipped_bytes++;
+                    p++;
+                    len--;
+                }
+                else
+                {
+                    // Tail of the chunk: keep it until the next one
+                    memcpy(_buf, p, len);
+                    _fill = len;
+                    break;
+                }
+                continue;
+            }
+
+            size_t need        = 0;
+            const result_t ret = check(_buf, _fill, need);
+            if (result_ok == ret)
+            {
+                on_frame(_buf, static_cast<uint16_t>(need));
+                _stats.frames++;
+                frames++;
+                // After a resync the buffer may hold bytes past this frame
+                _fill -= need;
+                memmove(_buf, _buf + need, _fill);
+            }
+            else if (result_bad == ret)
+            {
+                _stats.rejected++;
+                shift();
+            }
+            else
+            {
+                if (0 == len)
+                    break;
+                size_t n = need - _fill;
+                n        = n < len ? n : len;
+                memcpy(_buf + _fill, p, n);
+                _fill += n;
+                p += n;
+                len -= n;
+            }
+        }
+        return frames;
+    }
+
+  private:
+    enum result_t
+    {
+        result_ok,
+        result_bad,
+        result_more
+    };
+
+    /**
+     * @brief Bytes before the first possible SOF.
+     */
+    size_t scan(const uint8_t *p, const size_t len) const
+    {
+        if (0 == _format.sof_len)
+            return 0;
+        const void *hit = memchr(p, _format.sof[0], len);
+        return hit ? static_cast<const uint8_t *>(hit) - p : len;
+    }
+
+    /**
+     * @brief Validates a candidate starting at p[0].
+     * @param need total frame length on result_ok; bytes required to make
+     *        progress on result_more.
+     */
+    result_t check(const uint8_t *p, const size_t len, size_t &need) const
+    {
+        for (uint8_t i = 1; i < _format.sof_len; i++)
+        {
+            if (i >= len)
+            {
+                need = _format.sof_len;
+                return result_more;
+            }
+            if (p[i] != _format.sof[i])
+                return result_bad;
+        }
+
+        const size_t header = _format.header_len;
+        if (len < header)
+        {
+            need = header;
+            return result_more;
+        }
+        if (_format.check_header &&
+            !_format.check_header(p, static_cast<uint16_t>(header)))
+            return result_bad;
+
+        size_t total = _format.fixed_len;
+        if (_format.len_size)
+        {
+            total = p[_format.len_offset];
+            if (_format.len_size > 1)
+                total |= static_cast<size_t>(p[_format.len_offset + 1]) << 8;
+            total += _format.len_extra;
+        }
+        if (total > MAX_LEN || total < header || total < _format.min_len)
+            return result_bad;
+        if (len < total)
+        {
+            need = total;
+            return result_more;
+        }
+        if (_format.check_frame &&
+            !_format.check_frame(p, static_cast<uint16_t>(total)))
+            return result_bad;
+        need = total;
+        return result_ok;
+    }
+
+    /**
+     * @brief Drops the rejected candidate and moves to the next SOF in the
+     *        assembly buffer.
+     */
+    void shift()
+    {
+        const size_t skip = 1 + scan(_buf + 1, _fill - 1);
+        _stats.skipped_bytes += skip;
+        _fill -= skip;
+        memmove(_buf, _buf + skip, _fill);
+    }
+
+    const frame_format_t _format;
+    uint8_t _buf[MAX_LEN];
+    size_t _fill;
+    stats_t _stats;
+};
+} // namespace pyro
+#endif
@@ -0,0 +1,124 @@
+#ifndef ID_TABLE_H
+#define ID_TABLE_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+namespace pyro
+{
+/**
+ * @brief Fixed-size perfect-hash table keyed by 32-bit identifiers.
+ *
+ * The slot of a key is `(key * seed) >> (32 - log2(SLOTS))`. A seed that
+ * maps every registered key to a distinct slot is searched for when the key
+ * set changes (`plan`), so a lookup is one multiply, one indexed load and
+ * one compare, independent of how many keys are registered.
+ *
+ * `plan` only reads its arguments and may run with interrupts enabled;
+ * `commit` rewrites the table and must not race with `find`.
+ */
+template <typename V, size_t SLOTS> class id_table_t
+{
+    static_assert(SLOTS >= 2 && (SLOTS & (SLOTS - 1)) == 0,
+                  "SLOTS must be a power of two");
+
+  public:
+    static constexpr uint32_t INVALID_KEY = 0xFFFFFFFFU;
+    static constexpr uint32_t MAX_TRIES   = 8192;
+
+    id_table_t()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        _seed = DEFAULT_SEED;
+        for (auto &entry : _entries)
+        {
+            entry.key   = INVALID_KEY;
+            entry.value = V();
+        }
+    }
+
+    V find(const uint32_t key) const
+    {
+        const entry_t &entry = _entries[slot(key, _seed)];
+        return entry.key == key ? entry.value : V();
+    }
+
+    /**
+     * @brief Searches a seed that places all keys in distinct slots.
+     * @return false if the keys do not fit or no seed was found.
+     */
+    static bool plan(const uint32_t *keys, const size_t count, uint32_t &seed)
+    {
+        if (count > SLOTS)
+        {
+            return false;
+        }
+        uint32_t candidate = DEFAULT_SEED;
+        for (uint32_t tries = 0; tries < MAX_TRIES; tries++)
+        {
+            std::array<uint8_t, SLOTS / 8> used{};
+            bool collision = false;
+            for (size_t i = 0; i < count && !collision; i++)
+            {
+                const uint32_t s = slot(keys[i], candidate);
+                if (used[s >> 3] & (1U << (s & 0x07U)))
+                {
+                    collision = true;
+                }
+                used[s >> 3] |= static_cast<uint8_t>(1U << (s & 0x07U));
+            }
+            if (!collision)
+            {
+                seed = candidate;
+                return true;
+            }
+            candidate = (candidate * 1664525U + 1013904223U) | 0x01U;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Rebuilds the table with a seed returned by `plan`.
+     */
+    void commit(const uint32_t seed, const uint32_t *keys, const V *values,
+                const size_t count)
+    {
+        clear();
+        _seed = seed;
+        for (size_t i = 0; i < count; i++)
+        {
+            entry_t &entry = _entries[slot(keys[i], seed)];
+            entry.key      = keys[i];
+            entry.value    = values[i];
+        }
+    }
+
+  private:
+    struct entry_t
+    {
+        uint32_t key;
+        V value;
+    };
+
+    static constexpr uint32_t DEFAULT_SEED = 0x9E3779B1U;
+
+    static constexpr uint32_t log2(const size_t n)
+    {
+        return n <= 1 ? 0 : 1 + log2(n >> 1);
+    }
+
+    static uint32_t slot(const uint32_t key, const uint32_t seed)
+    {
+        return (key * seed) >> (32 - log2(SLOTS));
+    }
+
+    uint32_t _seed;
+    std::array<entry_t, SLOTS> _entries;
+};
+}; // namespace pyro
+
+
+#endif
@@ -9,7 +9,7 @@ namespace pyro
 
 mutex_t::mutex_t()
 {
-    _handle = xSemaphoreCreateMutex();
+    _handle = _storage.create_mutex();
     // 确保创建成功，类似 rw_lock 中的处理
     configASSERT(_handle != nullptr);
 }
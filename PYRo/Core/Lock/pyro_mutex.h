@@ -3,6 +3,7 @@
 
 
 #include "FreeRTOS.h"
+#include "pyro_static_alloc.h"
 #include "semphr.h"
 
 namespace pyro {
@@ -38,6 +39,7 @@ private:
     [[nodiscard]] SemaphoreHandle_t native_handle() const;
 
 
+    semaphore_storage_t _storage;
     SemaphoreHandle_t _handle;
 };
 
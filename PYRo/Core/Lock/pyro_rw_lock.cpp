@@ -5,9 +5,9 @@ namespace pyro
 
 rw_lock::rw_lock() : _reader_count(0), _writer_waiting_count(0)
 {
-    _internal_mutex = xSemaphoreCreateMutex();
-    _read_gate      = xSemaphoreCreateBinary();
-    _write_gate     = xSemaphoreCreateBinary();
+    _internal_mutex = _storage[0].create_mutex();
+    _read_gate      = _storage[1].create_binary();
+    _write_gate     = _storage[2].create_binary();
 
     configASSERT(_internal_mutex != nullptr);
     configASSERT(_read_gate != nullptr);
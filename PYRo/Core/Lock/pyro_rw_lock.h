@@ -2,6 +2,7 @@
 #define __PYRO_RW_LOCK_H__
 
 #include "freertos.h"
+#include "pyro_static_alloc.h"
 #include "semphr.h"
 #include "task.h"
 
@@ -72,6 +73,7 @@ class rw_lock
      */
     bool write_lock(TickType_t timeout_ticks);
 
+    semaphore_storage_t _storage[3];    // 三个信号量的存储（静态分配模式）
     SemaphoreHandle_t _internal_mutex;  // 用于保护内部计数器的互斥锁
     SemaphoreHandle_t _read_gate;       // 读者“大门”信号量
     SemaphoreHandle_t _write_gate;      // 写者“大门”信号量
@@ -0,0 +1,121 @@
+#ifndef __PYRO_SEQLATCH_H__
+#define __PYRO_SEQLATCH_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pyro
+{
+/**
+ * @brief 单写者双缓冲顺序锁 (seqlatch)
+ *
+ * 与 seqlock_t 的区别在于写者可以被读者抢占：
+ * - 两份数据槽交替写入，第 n 次写入使用槽 n & 1，写完后发布序号 n，
+ *   读者始终读取最近一次发布的槽，写者正在写的是另一个槽。
+ * - 写入前先记录"开始序号"，读者读完后检查该槽是否已被下一轮写入覆盖。
+ * - 读者只有在一次读取期间写者完成了一次写入并开始了下一次写入时才需要重试，
+ *   因此高优先级任务读取低优先级任务写入的数据时不会失败。
+ * - 数据按 32 位原子字存放，不依赖 FreeRTOS，可直接在主机上测试。
+ *
+ * @tparam T 可平凡拷贝的数据类型
+ */
+template <typename T> class seqlatch_t
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "seqlatch_t requires a trivially copyable type");
+
+    static constexpr size_t WORDS = (sizeof(T) + 3) / 4;
+
+  public:
+    static constexpr uint32_t DEFAULT_RETRIES = 4;
+
+    seqlatch_t() : _seq(0), _begin(0), _torn_count(0)
+    {
+        for (auto &slot : _slots)
+        {
+            for (auto &word : slot)
+            {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    seqlatch_t(const seqlatch_t &)            = delete;
+    seqlatch_t &operator=(const seqlatch_t &) = delete;
+
+    /**
+     * @brief 写入数据 (仅允许单个写者)
+     */
+    void write(const T &value)
+    {
+        std::array<uint32_t, WORDS> raw{};
+        memcpy(raw.data(), &value, sizeof(T));
+
+        const uint32_t seq = _seq.load(std::memory_order_relaxed) + 1;
+        _begin.store(seq, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        auto &slot = _slots[seq & 0x01U];
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            slot[i].store(raw[i], std::memory_order_relaxed);
+        }
+        _seq.store(seq, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取最近一次发布的完整快照
+     * @param value 输出数据，仅在返回 true 时有效
+     * @param retries 最大尝试次数
+     * @return true 读取成功, false 连续读到被覆盖的槽
+     */
+    bool read(T &value, uint32_t retries = DEFAULT_RETRIES) const
+    {
+        std::array<uint32_t, WORDS> raw{};
+        while (retries-- > 0)
+        {
+            const uint32_t seq = _seq.load(std::memory_order_acquire);
+            const auto &slot   = _slots[seq & 0x01U];
+            for (size_t i = 0; i < WORDS; i++)
+            {
+                raw[i] = slot[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // 槽 seq & 1 的下一次写入是第 seq + 2 次
+            if (_begin.load(std::memory_order_relaxed) - seq < 2U)
+            {
+                memcpy(&value, raw.data(), sizeof(T));
+                return true;
+            }
+            _torn_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 已写入的次数
+     */
+    uint32_t get_sequence() const
+    {
+        return _seq.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 被检测并丢弃的撕裂读次数
+     */
+    uint32_t get_torn_count() const
+    {
+        return _torn_count.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<uint32_t> _seq;
+    std::atomic<uint32_t> _begin;
+    std::array<std::array<std::atomic<uint32_t>, WORDS>, 2> _slots;
+    mutable std::atomic<uint32_t> _torn_count;
+};
+}; // namespace pyro
+
+#endif
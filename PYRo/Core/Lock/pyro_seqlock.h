@@ -0,0 +1,115 @@
+#ifndef __PYRO_SEQLOCK_H__
+#define __PYRO_SEQLOCK_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pyro
+{
+/**
+ * @brief 单写者顺序锁 (seqlock)
+ *
+ * 适用于 ISR 写、任务读的小块数据：
+ * - 写端无等待：序号置为奇数 -> 写数据 -> 序号置为下一个偶数。
+ * - 读端读取前后序号，不一致或为奇数说明读到了撕裂数据，丢弃后重试，
+ *   超过重试次数返回 false。
+ * - 数据按 32 位原子字存放，不依赖 FreeRTOS，可直接在主机上测试。
+ *
+ * @tparam T 可平凡拷贝的数据类型
+ */
+template <typename T> class seqlock_t
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "seqlock_t requires a trivially copyable type");
+
+    static constexpr size_t WORDS = (sizeof(T) + 3) / 4;
+
+  public:
+    static constexpr uint32_t DEFAULT_RETRIES = 4;
+
+    seqlock_t() : _seq(0), _torn_count(0)
+    {
+        for (auto &word : _words)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    seqlock_t(const seqlock_t &)            = delete;
+    seqlock_t &operator=(const seqlock_t &) = delete;
+
+    /**
+     * @brief 写入数据 (仅允许单个写者，如 ISR)
+     */
+    void write(const T &value)
+    {
+        std::array<uint32_t, WORDS> raw{};
+        memcpy(raw.data(), &value, sizeof(T));
+
+        const uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            _words[i].store(raw[i], std::memory_order_relaxed);
+        }
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取一份完整的数据快照
+     * @param value 输出数据，仅在返回 true 时有效
+     * @param retries 最大尝试次数
+     * @return true 读取成功, false 连续读到撕裂数据
+     */
+    bool read(T &value, uint32_t retries = DEFAULT_RETRIES) const
+    {
+        std::array<uint32_t, WORDS> raw{};
+        while (retries-- > 0)
+        {
+            const uint32_t begin = _seq.load(std::memory_order_acquire);
+            if (0 == (begin & 0x01U))
+            {
+                for (size_t i = 0; i < WORDS; i++)
+                {
+                    raw[i] = _words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_seq.load(std::memory_order_relaxed) == begin)
+                {
+                    memcpy(&value, raw.data(), sizeof(T));
+                    return true;
+                }
+            }
+            _torn_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 已写入的次数
+     */
+    uint32_t get_sequence() const
+    {
+        return _seq.load(std::memory_order_acquire) >> 1;
+    }
+
+    /**
+     * @brief 被检测并丢弃的撕裂读次数
+     */
+    uint32_t get_torn_count() const
+    {
+        return _torn_count.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<uint32_t> _seq;
+    std::array<std::atomic<uint32_t>, WORDS> _words;
+    mutable std::atomic<uint32_t> _torn_count;
+};
+}; // namespace pyro
+
+#endif
@@ -9,6 +9,7 @@ extern "C" {
 #endif
 
     void *pvPortDmaMalloc( size_t xWantedSize );
+    void *pvPortDmaMallocAligned( size_t xWantedSize, size_t xAlignment );
     void vPortDmaFree( void *pv );
     void vPortGetDmaHeapStats( HeapStats_t *pxHeapStats );
 
@@ -1,15 +1,21 @@
 #include <cstdlib>
 #include "FreeRTOS.h"
+#include "pyro_mem_trace.h"
 
+// 跟踪模式下把分配记在 new 表达式所在处，而不是这里
 void *operator new(const std::size_t size)
 {
+    PYRO_MEM_TRACE_ENTER();
     void *ptr = pvPortMalloc(size);
+    PYRO_MEM_TRACE_EXIT();
     return ptr;
 }
 
 void *operator new[](const std::size_t size)
 {
+    PYRO_MEM_TRACE_ENTER();
     void *ptr = pvPortMalloc(size);
+    PYRO_MEM_TRACE_EXIT();
     return ptr;
 }
 
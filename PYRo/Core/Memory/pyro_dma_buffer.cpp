@@ -0,0 +1,113 @@
+#include "pyro_dma_buffer.h"
+
+#include "pyro_core_config.h"
+#include "pyro_core_dma_heap.h"
+#include "pyro_mem_trace.h"
+#include "stm32h7xx.h"
+
+namespace pyro
+{
+
+// ----------------------------------------------------------------
+// cache 维护
+// ----------------------------------------------------------------
+
+void dma_cache_clean(const void *p, const size_t size)
+{
+#if PYRO_DCACHE_EN && defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    const dma_cache_range_t range =
+        dma_cache_range(reinterpret_cast<uintptr_t>(p), size);
+    if (range.size && (SCB->CCR & SCB_CCR_DC_Msk))
+    {
+        SCB_CleanDCache_by_Addr(reinterpret_cast<uint32_t *>(range.start),
+                                static_cast<int32_t>(range.size));
+    }
+#else
+    (void)p;
+    (void)size;
+#endif
+}
+
+void dma_cache_invalidate(void *p, const size_t size)
+{
+#if PYRO_DCACHE_EN && defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    const dma_cache_range_t range =
+        dma_cache_range(reinterpret_cast<uintptr_t>(p), size);
+    if (range.size && (SCB->CCR & SCB_CCR_DC_Msk))
+    {
+        SCB_InvalidateDCache_by_Addr(reinterpret_cast<uint32_t *>(range.start),
+                                     static_cast<int32_t>(range.size));
+    }
+#else
+    (void)p;
+    (void)size;
+#endif
+}
+
+// ----------------------------------------------------------------
+// dma_buffer_t 实现
+// ----------------------------------------------------------------
+
+dma_buffer_t::dma_buffer_t() : _data(nullptr), _size(0)
+{
+}
+
+dma_buffer_t::dma_buffer_t(const size_t size) : dma_buffer_t()
+{
+    allocate(size);
+}
+
+dma_buffer_t::~dma_buffer_t()
+{
+    release();
+}
+
+bool dma_buffer_t::allocate(const size_t size)
+{
+    release();
+    if (0 == size)
+    {
+        return false;
+    }
+    // 由堆直接按行对齐放置，前导空隙留在堆中
+    PYRO_MEM_TRACE_ENTER();
+    _data = static_cast<uint8_t *>(
+        pvPortDmaMallocAligned(dma_cache_round_up(size), DMA_CACHE_LINE));
+    PYRO_MEM_TRACE_EXIT();
+    if (nullptr == _data)
+    {
+        return false;
+    }
+    _size = size;
+    return true;
+}
+
+void dma_buffer_t::release()
+{
+    if (_data != nullptr)
+    {
+        vPortDmaFree(_data);
+    }
+    _data = nullptr;
+    _size = 0;
+}
+
+void dma_buffer_t::clean(const size_t offset, const size_t len) const
+{
+    if (_data && offset < _size)
+    {
+        dma_cache_clean(_data + offset,
+                        len < _size - offset ? len : _size - offset);
+    }
+}
+
+void dma_buffer_t::invalidate(const size_t offset, const size_t len) const
+{
+    if (_data && offset < _size)
+    {
+        dma_cache_invalidate(_data + offset,
+                             len < _size - offset ? len : _size - offset);
+    }
+}
+
+} // namespace pyro
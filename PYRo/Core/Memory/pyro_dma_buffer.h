@@ -0,0 +1,143 @@
+#ifndef __PYRO_DMA_BUFFER_H__
+#define __PYRO_DMA_BUFFER_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/* Cache-line arithmetic -----------------------------------------------------*/
+/**
+ * @brief Cortex-M7 D-cache 行大小（字节）。
+ */
+static constexpr size_t DMA_CACHE_LINE = 32;
+
+/**
+ * @brief 将长度向上取整到整数个 cache 行。
+ */
+constexpr size_t dma_cache_round_up(const size_t size)
+{
+    return (size + DMA_CACHE_LINE - 1) & ~(DMA_CACHE_LINE - 1);
+}
+
+/**
+ * @brief 将地址向下/向上对齐到 cache 行边界。
+ */
+constexpr uintptr_t dma_cache_align_down(const uintptr_t addr)
+{
+    return addr & ~static_cast<uintptr_t>(DMA_CACHE_LINE - 1);
+}
+
+constexpr uintptr_t dma_cache_align_up(const uintptr_t addr)
+{
+    return dma_cache_align_down(addr + DMA_CACHE_LINE - 1);
+}
+
+/**
+ * @brief 覆盖 [addr, addr + size) 的最小整行区间。
+ */
+struct dma_cache_range_t
+{
+    uintptr_t start;
+    size_t size;
+};
+
+constexpr dma_cache_range_t dma_cache_range(const uintptr_t addr,
+                                            const size_t size)
+{
+    return size ? dma_cache_range_t{dma_cache_align_down(addr),
+                                    static_cast<size_t>(
+                                        dma_cache_align_up(addr + size) -
+                                        dma_cache_align_down(addr))}
+                : dma_cache_range_t{dma_cache_align_down(addr), 0};
+}
+
+static_assert(dma_cache_round_up(0) == 0, "round_up(0)");
+static_assert(dma_cache_round_up(1) == 32 && dma_cache_round_up(32) == 32 &&
+                  dma_cache_round_up(33) == 64,
+              "round_up");
+static_assert(dma_cache_range(0x1F, 2).start == 0x00 &&
+                  dma_cache_range(0x1F, 2).size == 64,
+              "range across a line boundary");
+static_assert(dma_cache_range(0x40, 32).size == 32, "aligned range");
+
+/**
+ * @brief 静态 DMA 缓冲区：放入 RAM_D2 的 .dma_buffer 段（不加载、不清零），
+ *        按 cache 行对齐。长度应用 dma_cache_round_up 取整，使缓冲区独占其行。
+ *        用于常驻的收发缓冲区，不占用 DMA 堆，也不受 vPortHeapLock 限制。
+ */
+#define PYRO_DMA_STATIC                                                        \
+    __attribute__((section(".dma_buffer"), aligned(pyro::DMA_CACHE_LINE)))
+
+/* Cache maintenance ---------------------------------------------------------*/
+/**
+ * @brief 将 CPU 写入的数据写回内存，DMA 读取（TX）之前调用。
+ *
+ * 只做写回，不丢弃数据，因此可用于任意未对齐的缓冲区。
+ */
+void dma_cache_clean(const void *p, size_t size);
+
+/**
+ * @brief 丢弃 cache 中的旧数据，DMA 写入（RX）之后、CPU 读取之前调用。
+ *
+ * 会丢弃整行，p/size 所在的行中不得有其他需要保留的 CPU 数据；
+ * 仅用于 dma_buffer_t 这类按行对齐、按行取整的缓冲区。
+ */
+void dma_cache_invalidate(void *p, size_t size);
+
+/* DMA buffer ----------------------------------------------------------------*/
+/**
+ * @brief 从 DMA 堆分配、按 cache 行对齐且长度按行取整的缓冲区。
+ *
+ * 缓冲区独占它所在的 cache 行，因此 invalidate 不会误伤相邻数据。
+ * 交给 DMA 之前调用 clean()（TX）或 invalidate()（RX），
+ * DMA 写完之后 CPU 读取之前再调用 invalidate()。
+ */
+class dma_buffer_t
+{
+  public:
+    dma_buffer_t();
+    explicit dma_buffer_t(size_t size);
+    ~dma_buffer_t();
+
+    dma_buffer_t(const dma_buffer_t &)            = delete;
+    dma_buffer_t &operator=(const dma_buffer_t &) = delete;
+
+    bool allocate(size_t size);
+    void release();
+
+    uint8_t *data() const
+    {
+        return _data;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    explicit operator bool() const
+    {
+        return nullptr != _data;
+    }
+
+    void clean(size_t offset, size_t len) const;
+    void invalidate(size_t offset, size_t len) const;
+
+    void clean() const
+    {
+        clean(0, _size);
+    }
+
+    void invalidate() const
+    {
+        invalidate(0, _size);
+    }
+
+  private:
+    uint8_t *_data; // 按行对齐的起始地址
+    size_t _size;   // 请求的长度（可用长度已按行取整）
+};
+} // namespace pyro
+
+#endif
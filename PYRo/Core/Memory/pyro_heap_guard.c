@@ -0,0 +1,43 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pyro_heap_guard.h"
+#include "pyro_mem_trace.h"
+
+
+static volatile BaseType_t xHeapLocked = pdFALSE;
+
+void vPortHeapLock( void )
+{
+    xHeapLocked = pdTRUE;
+}
+
+BaseType_t xPortHeapIsLocked( void )
+{
+    return xHeapLocked;
+}
+
+void vPortHeapOnMalloc( void *pv, size_t xSize, void *pvCaller )
+{
+    #if( PYRO_MEM_TRACE_EN == 1 )
+        vPortMemTraceMalloc( pv, xSize, pvCaller );
+    #else
+        ( void ) pv;
+        ( void ) xSize;
+        ( void ) pvCaller;
+    #endif
+
+    #if( PYRO_STATIC_ALLOC_EN == 1 )
+        /* 锁定后仍有分配：调用栈上即是违规的 new / xxxCreate，应改为静态存储或移到初始化阶段 */
+        configASSERT( xHeapLocked == pdFALSE );
+    #endif
+}
+
+void vPortHeapOnFree( void *pv, size_t xSize )
+{
+    #if( PYRO_MEM_TRACE_EN == 1 )
+        vPortMemTraceFree( pv, xSize );
+    #else
+        ( void ) pv;
+        ( void ) xSize;
+    #endif
+}
@@ -0,0 +1,31 @@
+#ifndef __PYRO_HEAP_GUARD_H__
+#define __PYRO_HEAP_GUARD_H__
+
+#include "FreeRTOS.h"
+#include "pyro_core_config.h"
+#include <stddef.h>
+
+/*
+ * 堆钩子。PYRO_STATIC_ALLOC_EN 或 PYRO_MEM_TRACE_EN 为 1 时 FreeRTOSConfig.h
+ * 把 traceMALLOC/traceFREE 指向这里，主堆与各内存区域的每次分配/释放都会经过：
+ * - 静态分配模式下 vPortHeapLock() 之后的任何分配都会触发 configASSERT；
+ * - 跟踪模式下转交 pyro_mem_trace 记录。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /* 锁定堆，通常在 pyro_init_thread 结束时调用，不可解锁 */
+    void vPortHeapLock( void );
+    BaseType_t xPortHeapIsLocked( void );
+
+    /* traceMALLOC/traceFREE 钩子，在堆的临界区内调用；pvCaller 为堆函数的返回地址 */
+    void vPortHeapOnMalloc( void *pv, size_t xSize, void *pvCaller );
+    void vPortHeapOnFree( void *pv, size_t xSize );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,263 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pyro_mem_region.h"
+#include "pyro_mem_trace.h"
+#include "pyro_tlsf.h"
+#include "pyro_core_config.h"
+
+
+/* ========== 具名内存区域 ========== */
+/*
+ * 每个区域一个静态缓冲区 + 一个 TLSF 控制块。缓冲区通过段名放入对应 RAM，
+ * 链接脚本中各段均为 NOLOAD，不占用 FLASH 镜像，也不由启动代码清零。
+ * 控制块（位图与链表头）放在普通 .bss 中。
+ *
+ * 互斥方式与主堆一致（vTaskSuspendAll），不可在中断中调用。
+ * 首次分配时初始化对应区域，未使用的区域不产生初始化开销。
+ */
+
+#ifndef PYRO_MEM_DTCM_HEAP_SIZE
+    #define PYRO_MEM_DTCM_HEAP_SIZE 0
+#endif
+#ifndef PYRO_MEM_AXI_HEAP_SIZE
+    #define PYRO_MEM_AXI_HEAP_SIZE 0
+#endif
+#ifndef PYRO_MEM_D2_HEAP_SIZE
+    #define PYRO_MEM_D2_HEAP_SIZE 0
+#endif
+#ifndef PYRO_MEM_D3_HEAP_SIZE
+    #define PYRO_MEM_D3_HEAP_SIZE 0
+#endif
+
+#if( PYRO_MEM_DTCM_HEAP_SIZE > 0 )
+    __attribute__((section(".dtcm_heap"), aligned(8))) static uint8_t ucDtcmHeap[ PYRO_MEM_DTCM_HEAP_SIZE ];
+    #define prvDTCM_HEAP ucDtcmHeap
+#else
+    #define prvDTCM_HEAP NULL
+#endif
+
+#if( PYRO_MEM_AXI_HEAP_SIZE > 0 )
+    __attribute__((section(".axi_heap"), aligned(8))) static uint8_t ucAxiHeap[ PYRO_MEM_AXI_HEAP_SIZE ];
+    #define prvAXI_HEAP ucAxiHeap
+#else
+    #define prvAXI_HEAP NULL
+#endif
+
+#if( PYRO_MEM_D2_HEAP_SIZE > 0 )
+    __attribute__((section(".dma_heap"), aligned(8))) static uint8_t ucD2Heap[ PYRO_MEM_D2_HEAP_SIZE ];
+    #define prvD2_HEAP ucD2Heap
+#else
+    #define prvD2_HEAP NULL
+#endif
+
+#if( PYRO_MEM_D3_HEAP_SIZE > 0 )
+    __attribute__((section(".d3_heap"), aligned(8))) static uint8_t ucD3Heap[ PYRO_MEM_D3_HEAP_SIZE ];
+    #define prvD3_HEAP ucD3Heap
+#else
+    #define prvD3_HEAP NULL
+#endif
+
+typedef struct
+{
+    const char *pcName;
+    uint32_t ulAttr;
+    uint8_t *pucMem;
+    size_t xSize;
+} MemRegionDesc_t;
+
+/* 注册顺序即 pvPortMallocWithAttr 的优先顺序：越快越靠前 */
+static const MemRegionDesc_t xRegionDesc[ PYRO_MEM_REGION_NUM ] =
+{
+    [ PYRO_MEM_DTCM ] = { "DTCM", PYRO_MEM_ATTR_FAST, prvDTCM_HEAP, PYRO_MEM_DTCM_HEAP_SIZE },
+    [ PYRO_MEM_AXI ]  = { "AXI", PYRO_MEM_ATTR_DMA | PYRO_MEM_ATTR_CACHEABLE, prvAXI_HEAP, PYRO_MEM_AXI_HEAP_SIZE },
+    [ PYRO_MEM_D2 ]   = { "D2", PYRO_MEM_ATTR_DMA | PYRO_MEM_ATTR_CACHEABLE, prvD2_HEAP, PYRO_MEM_D2_HEAP_SIZE },
+    [ PYRO_MEM_D3 ]   = { "D3", PYRO_MEM_ATTR_DMA | PYRO_MEM_ATTR_BDMA | PYRO_MEM_ATTR_CACHEABLE, prvD3_HEAP, PYRO_MEM_D3_HEAP_SIZE },
+};
+
+static pyro_tlsf_t xRegionTlsf[ PYRO_MEM_REGION_NUM ];
+static BaseType_t xRegionReady[ PYRO_MEM_REGION_NUM ];
+
+/* 调用方须已挂起调度器 */
+static void *prvRegionMalloc( pyro_mem_region_t xRegion, size_t xWantedSize, size_t xAlignment )
+{
+const MemRegionDesc_t *pxDesc = &xRegionDesc[ xRegion ];
+void *pvReturn = NULL;
+
+    if( pxDesc->xSize == 0 )
+    {
+        return NULL;
+    }
+
+    if( xRegionReady[ xRegion ] == pdFALSE )
+    {
+        const int xInitResult = pyro_tlsf_init( &xRegionTlsf[ xRegion ], pxDesc->pucMem, pxDesc->xSize );
+        configASSERT( xInitResult == 0 );
+        ( void ) xInitResult;
+        xRegionReady[ xRegion ] = pdTRUE;
+    }
+
+    pvReturn = pyro_tlsf_memalign( &xRegionTlsf[ xRegion ], xAlignment, xWantedSize );
+
+    return pvReturn;
+}
+
+static void prvMallocFailed( void *pvReturn )
+{
+    #if( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            extern void vApplicationMallocFailedHook( void );
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else
+        ( void ) pvReturn;
+    #endif
+}
+
+static size_t prvAlignment( size_t xAlignment )
+{
+    /* 对齐必须为 2 的幂 */
+    configASSERT( ( xAlignment & ( xAlignment - 1 ) ) == 0 );
+    return xAlignment < portBYTE_ALIGNMENT ? portBYTE_ALIGNMENT : xAlignment;
+}
+
+void *pvPortMallocInAligned( pyro_mem_region_t xRegion, size_t xWantedSize, size_t xAlignment )
+{
+void *pvReturn = NULL;
+
+    configASSERT( xRegion < PYRO_MEM_REGION_NUM );
+    xAlignment = prvAlignment( xAlignment );
+
+    PYRO_MEM_TRACE_ENTER();
+    vTaskSuspendAll();
+    {
+        pvReturn = prvRegionMalloc( xRegion, xWantedSize, xAlignment );
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+    PYRO_MEM_TRACE_EXIT();
+
+    prvMallocFailed( pvReturn );
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( xAlignment - 1 ) ) == 0 );
+    return pvReturn;
+}
+
+void *pvPortMallocIn( pyro_mem_region_t xRegion, size_t xWantedSize )
+{
+void *pvReturn;
+
+    PYRO_MEM_TRACE_ENTER();
+    pvReturn = pvPortMallocInAligned( xRegion, xWantedSize, portBYTE_ALIGNMENT );
+    PYRO_MEM_TRACE_EXIT();
+
+    return pvReturn;
+}
+
+void *pvPortMallocWithAttr( uint32_t ulAttr, size_t xWantedSize )
+{
+void *pvReturn = NULL;
+
+    PYRO_MEM_TRACE_ENTER();
+    vTaskSuspendAll();
+    {
+        for( int i = 0; ( i < PYRO_MEM_REGION_NUM ) && ( pvReturn == NULL ); i++ )
+        {
+            if( ( xRegionDesc[ i ].ulAttr & ulAttr ) == ulAttr )
+            {
+                pvReturn = prvRegionMalloc( ( pyro_mem_region_t ) i, xWantedSize, portBYTE_ALIGNMENT );
+            }
+        }
+        /* 只记录最终结果，前面区域的未命中不算失败 */
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+    PYRO_MEM_TRACE_EXIT();
+
+    prvMallocFailed( pvReturn );
+    return pvReturn;
+}
+
+pyro_mem_region_t xPortMemRegionOf( const void *pv )
+{
+    const uint8_t *puc = ( const uint8_t * ) pv;
+
+    for( int i = 0; i < PYRO_MEM_REGION_NUM; i++ )
+    {
+        const MemRegionDesc_t *pxDesc = &xRegionDesc[ i ];
+
+        if( ( pxDesc->xSize > 0 ) && ( puc >= pxDesc->pucMem ) && ( puc < pxDesc->pucMem + pxDesc->xSize ) )
+        {
+            return ( pyro_mem_region_t ) i;
+        }
+    }
+
+    return PYRO_MEM_REGION_NONE;
+}
+
+void vPortFreeIn( void *pv )
+{
+    if( pv != NULL )
+    {
+        const pyro_mem_region_t xRegion = xPortMemRegionOf( pv );
+
+        /* 指针必须来自某个区域 */
+        configASSERT( xRegion != PYRO_MEM_REGION_NONE );
+        if( xRegion == PYRO_MEM_REGION_NONE )
+        {
+            return;
+        }
+
+        vTaskSuspendAll();
+        {
+            traceFREE( pv, pyro_tlsf_usable_size( pv ) );
+            pyro_tlsf_free( &xRegionTlsf[ xRegion ], pv );
+        }
+        ( void ) xTaskResumeAll();
+    }
+}
+
+uint32_t ulPortMemRegionAttr( pyro_mem_region_t xRegion )
+{
+    return ( xRegion < PYRO_MEM_REGION_NUM ) ? xRegionDesc[ xRegion ].ulAttr : 0;
+}
+
+const char *pcPortMemRegionName( pyro_mem_region_t xRegion )
+{
+    return ( xRegion < PYRO_MEM_REGION_NUM ) ? xRegionDesc[ xRegion ].pcName : "NONE";
+}
+
+void vPortGetRegionHeapStats( pyro_mem_region_t xRegion, HeapStats_t *pxHeapStats )
+{
+    /* 未启用或尚未使用的区域统计为 0 */
+    if( ( xRegion >= PYRO_MEM_REGION_NUM ) || ( xRegionReady[ xRegion ] == pdFALSE ) )
+    {
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes = 0;
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = 0;
+        pxHeapStats->xNumberOfFreeBlocks = 0;
+        pxHeapStats->xAvailableHeapSpaceInBytes = 0;
+        pxHeapStats->xNumberOfSuccessfulAllocations = 0;
+        pxHeapStats->xNumberOfSuccessfulFrees = 0;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = 0;
+        return;
+    }
+
+    vTaskSuspendAll();
+    {
+        const pyro_tlsf_t *pxTlsf = &xRegionTlsf[ xRegion ];
+
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes = pyro_tlsf_largest_free( pxTlsf );
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = pyro_tlsf_smallest_free( pxTlsf );
+        pxHeapStats->xNumberOfFreeBlocks = pxTlsf->stats.free_blocks;
+        pxHeapStats->xAvailableHeapSpaceInBytes = pxTlsf->stats.free_bytes;
+        pxHeapStats->xNumberOfSuccessfulAllocations = pxTlsf->stats.allocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = pxTlsf->stats.frees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = pxTlsf->stats.min_ever_free_bytes;
+    }
+    ( void ) xTaskResumeAll();
+}
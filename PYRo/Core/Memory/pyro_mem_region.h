@@ -0,0 +1,85 @@
+#ifndef __PYRO_MEM_REGION_H__
+#define __PYRO_MEM_REGION_H__
+
+#include "FreeRTOS.h" /* for HeapStats_t */
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 具名内存区域。每个区域是一块独立的 TLSF 堆，带有速度与 DMA 可达性属性：
+ *
+ *   区域          位置                 属性
+ *   DTCM          DTCMRAM  0x20000000  零等待、CPU 独占（DMA1/2 不可达）
+ *   AXI           RAM_D1   0x24000000  大容量、DMA1/2/MDMA 可达、cache
+ *   D2            RAM_D2   0x30000000  DMA1/2 可达、cache（即 DMA 堆）
+ *   D3            RAM_D3   0x38000000  DMA1/2 与 BDMA 可达、cache
+ *
+ * 控制环、PID/观测器状态放 DTCM；DMA 缓冲区放 D2/AXI，BDMA 外设只能用 D3。
+ * 区域大小在 pyro_core_config.h 中配置，为 0 的区域不可用（分配返回 NULL）。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    typedef enum
+    {
+        PYRO_MEM_DTCM = 0,
+        PYRO_MEM_AXI,
+        PYRO_MEM_D2,
+        PYRO_MEM_D3,
+        PYRO_MEM_REGION_NUM,
+        PYRO_MEM_REGION_NONE = PYRO_MEM_REGION_NUM
+    } pyro_mem_region_t;
+
+    /* 区域属性位 */
+    #define PYRO_MEM_ATTR_FAST      ( 1U << 0 ) /* 零等待，适合控制环数据 */
+    #define PYRO_MEM_ATTR_DMA       ( 1U << 1 ) /* DMA1/DMA2 可达 */
+    #define PYRO_MEM_ATTR_BDMA      ( 1U << 2 ) /* BDMA 可达 */
+    #define PYRO_MEM_ATTR_CACHEABLE ( 1U << 3 ) /* 经过 D-cache，DMA 前后需维护 */
+
+    void *pvPortMallocIn( pyro_mem_region_t xRegion, size_t xWantedSize );
+    void *pvPortMallocInAligned( pyro_mem_region_t xRegion, size_t xWantedSize, size_t xAlignment );
+    /* 按注册顺序选第一个具备全部 ulAttr 属性且分配成功的区域 */
+    void *pvPortMallocWithAttr( uint32_t ulAttr, size_t xWantedSize );
+    /* 释放任意区域分配的内存，按地址找到所属区域 */
+    void vPortFreeIn( void *pv );
+
+    pyro_mem_region_t xPortMemRegionOf( const void *pv );
+    uint32_t ulPortMemRegionAttr( pyro_mem_region_t xRegion );
+    const char *pcPortMemRegionName( pyro_mem_region_t xRegion );
+    void vPortGetRegionHeapStats( pyro_mem_region_t xRegion, HeapStats_t *pxHeapStats );
+
+#ifdef __cplusplus
+}
+
+#include <new>
+#include <utility>
+
+namespace pyro
+{
+/**
+ * @brief 在指定区域构造对象，失败返回 nullptr。
+ */
+template <typename T, typename... Args>
+T *new_in(const pyro_mem_region_t region, Args &&...args)
+{
+    void *p = pvPortMallocInAligned(region, sizeof(T), alignof(T));
+    return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+}
+
+/**
+ * @brief 析构并释放 new_in 构造的对象。
+ */
+template <typename T> void delete_in(T *p)
+{
+    if (p)
+    {
+        p->~T();
+        vPortFreeIn(p);
+    }
+}
+} // namespace pyro
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pyro_mem_trace.h"
+#include "pyro_mem_region.h"
+
+
+#if( PYRO_MEM_TRACE_EN == 1 )
+
+#if( ( PYRO_MEM_TRACE_DEPTH & ( PYRO_MEM_TRACE_DEPTH - 1 ) ) != 0 )
+    #error "PYRO_MEM_TRACE_DEPTH must be a power of 2"
+#endif
+
+/*
+ * 所有状态只在堆的临界区（调度器挂起）内读写：钩子由堆在 vTaskSuspendAll
+ * 期间调用，Enter/Exit 自己挂起调度器，读取接口要求调用方挂起。
+ */
+static pyro_mem_trace_event_t xRing[ PYRO_MEM_TRACE_DEPTH ];
+static pyro_mem_trace_event_t xLive[ PYRO_MEM_TRACE_LIVE_NUM ]; /* ulAddress 为 0 表示空槽 */
+static pyro_mem_trace_stats_t xStats;
+
+static void *pvScopeCaller = NULL;
+static UBaseType_t uxScopeDepth = 0;
+
+static uint32_t prvInfo( void *pv, size_t xSize )
+{
+    /* 释放事件按地址判断所在堆；分配失败时无地址，记为主堆 */
+    const uint32_t ulHeap = ( uint32_t ) ( pv ? xPortMemRegionOf( pv ) : PYRO_MEM_REGION_NONE );
+
+    return ( ( ulHeap << PYRO_MEM_TRACE_HEAP_SHIFT ) & PYRO_MEM_TRACE_HEAP_MASK ) |
+           ( ( uint32_t ) xSize & PYRO_MEM_TRACE_SIZE_MASK );
+}
+
+static void prvRecord( uint32_t ulAddress, uint32_t ulCaller, uint32_t ulTask, uint32_t ulInfo )
+{
+    pyro_mem_trace_event_t *pxEvent = &xRing[ xStats.ulEvents & ( PYRO_MEM_TRACE_DEPTH - 1 ) ];
+
+    pxEvent->ulAddress = ulAddress;
+    pxEvent->ulCaller = ulCaller;
+    pxEvent->ulTask = ulTask;
+    pxEvent->ulInfo = ulInfo;
+    xStats.ulEvents++;
+}
+
+void vPortMemTraceMalloc( void *pv, size_t xSize, void *pvCaller )
+{
+    const uint32_t ulCaller = ( uint32_t ) ( uintptr_t ) ( pvScopeCaller ? pvScopeCaller : pvCaller );
+    const uint32_t ulTask = ( uint32_t ) ( uintptr_t ) xTaskGetCurrentTaskHandle();
+    const uint32_t ulInfo = prvInfo( pv, xSize );
+
+    prvRecord( ( uint32_t ) ( uintptr_t ) pv, ulCaller, ulTask, ulInfo );
+
+    if( pv == NULL )
+    {
+        xStats.ulFailures++;
+        return;
+    }
+
+    for( size_t i = 0; i < PYRO_MEM_TRACE_LIVE_NUM; i++ )
+    {
+        if( xLive[ i ].ulAddress == 0 )
+        {
+            xLive[ i ].ulAddress = ( uint32_t ) ( uintptr_t ) pv;
+            xLive[ i ].ulCaller = ulCaller;
+            xLive[ i ].ulTask = ulTask;
+            xLive[ i ].ulInfo = ulInfo;
+            xStats.ulLive++;
+            return;
+        }
+    }
+
+    xStats.ulLiveOverflow++;
+}
+
+void vPortMemTraceFree( void *pv, size_t xSize )
+{
+    const uint32_t ulAddress = ( uint32_t ) ( uintptr_t ) pv;
+    uint32_t ulCaller = 0;
+
+    for( size_t i = 0; i < PYRO_MEM_TRACE_LIVE_NUM; i++ )
+    {
+        if( xLive[ i ].ulAddress == ulAddress )
+        {
+            /* 释放事件带上分配时的调用点，便于与分配配对 */
+            ulCaller = xLive[ i ].ulCaller;
+            xLive[ i ].ulAddress = 0;
+            xStats.ulLive--;
+            break;
+        }
+    }
+
+    prvRecord( ulAddress, ulCaller, ( uint32_t ) ( uintptr_t ) xTaskGetCurrentTaskHandle(),
+               prvInfo( pv, xSize ) | PYRO_MEM_TRACE_FREE_FLAG );
+}
+
+void vPortMemTraceEnter( void *pvCaller )
+{
+    vTaskSuspendAll();
+    if( uxScopeDepth++ == 0 )
+    {
+        pvScopeCaller = pvCaller;
+    }
+}
+
+void vPortMemTraceExit( void )
+{
+    if( --uxScopeDepth == 0 )
+    {
+        pvScopeCaller = NULL;
+    }
+    ( void ) xTaskResumeAll();
+}
+
+void vPortMemTraceGetStats( pyro_mem_trace_stats_t *pxStats )
+{
+    *pxStats = xStats;
+}
+
+BaseType_t xPortMemTraceGetEvent( uint32_t ulSeq, pyro_mem_trace_event_t *pxEvent )
+{
+    /* 无符号差值：ulSeq 在 [ulEvents - DEPTH, ulEvents) 内才有效 */
+    if( ( uint32_t ) ( xStats.ulEvents - ulSeq - 1U ) >= PYRO_MEM_TRACE_DEPTH )
+    {
+        return pdFALSE;
+    }
+
+    *pxEvent = xRing[ ulSeq & ( PYRO_MEM_TRACE_DEPTH - 1 ) ];
+    return pdTRUE;
+}
+
+size_t xPortMemTraceCopyLive( size_t *pxCursor, pyro_mem_trace_event_t *pxOut, size_t xMax )
+{
+    size_t xCount = 0;
+    size_t i = *pxCursor;
+
+    for( ; ( i < PYRO_MEM_TRACE_LIVE_NUM ) && ( xCount < xMax ); i++ )
+    {
+        if( xLive[ i ].ulAddress != 0 )
+        {
+            pxOut[ xCount++ ] = xLive[ i ];
+        }
+    }
+
+    *pxCursor = i;
+    return xCount;
+}
+
+#endif /* PYRO_MEM_TRACE_EN */
@@ -0,0 +1,80 @@
+#ifndef __PYRO_MEM_TRACE_H__
+#define __PYRO_MEM_TRACE_H__
+
+#include "FreeRTOS.h"
+#include "pyro_core_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 堆分配跟踪（PYRO_MEM_TRACE_EN）。主堆与各内存区域的每次分配/释放经
+ * traceMALLOC/traceFREE 钩子记录到环形缓冲区：地址、调用点、所属任务、
+ * 大小与所在堆；同时维护一张未释放块表，用于泄漏报告。
+ * 读取接口供 pyro_mem_report 在调度器挂起期间调用。
+ *
+ * 调用点默认是堆函数的返回地址。包装函数（operator new、DMA 堆等）用
+ * PYRO_MEM_TRACE_ENTER/EXIT 包住内部分配，把调用点记为包装函数的调用者；
+ * 嵌套时最外层优先。
+ */
+
+#ifndef PYRO_MEM_TRACE_DEPTH
+    #define PYRO_MEM_TRACE_DEPTH 64
+#endif
+#ifndef PYRO_MEM_TRACE_LIVE_NUM
+    #define PYRO_MEM_TRACE_LIVE_NUM 128
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /* ulInfo 位域：bit31 释放，bit28..30 堆编号（pyro_mem_region_t，主堆为 PYRO_MEM_REGION_NONE），bit0..27 字节数 */
+    #define PYRO_MEM_TRACE_FREE_FLAG   ( 1UL << 31 )
+    #define PYRO_MEM_TRACE_HEAP_SHIFT  28
+    #define PYRO_MEM_TRACE_HEAP_MASK   ( 0x7UL << PYRO_MEM_TRACE_HEAP_SHIFT )
+    #define PYRO_MEM_TRACE_SIZE_MASK   0x0FFFFFFFUL
+
+    /* 一条事件或一个未释放块，16 字节。分配失败时 ulAddress 为 0 */
+    typedef struct
+    {
+        uint32_t ulAddress;
+        uint32_t ulCaller;
+        uint32_t ulTask; /* TaskHandle_t，调度器启动前为 0 */
+        uint32_t ulInfo;
+    } pyro_mem_trace_event_t;
+
+    typedef struct
+    {
+        uint32_t ulEvents;       /* 累计事件数，即下一条事件的序号 */
+        uint32_t ulLive;         /* 当前未释放块数 */
+        uint32_t ulLiveOverflow; /* 未释放块表满而未记录的分配次数 */
+        uint32_t ulFailures;     /* 分配失败次数 */
+    } pyro_mem_trace_stats_t;
+
+    /* 钩子，由 pyro_heap_guard.c 在堆的临界区内调用 */
+    void vPortMemTraceMalloc( void *pv, size_t xSize, void *pvCaller );
+    void vPortMemTraceFree( void *pv, size_t xSize );
+
+    void vPortMemTraceEnter( void *pvCaller );
+    void vPortMemTraceExit( void );
+
+    /* 以下读取接口须在调度器挂起期间调用 */
+    void vPortMemTraceGetStats( pyro_mem_trace_stats_t *pxStats );
+    /* 取序号为 ulSeq 的事件，已被覆盖或尚未发生时返回 pdFALSE */
+    BaseType_t xPortMemTraceGetEvent( uint32_t ulSeq, pyro_mem_trace_event_t *pxEvent );
+    /* 从槽位 *pxCursor 起复制至多 xMax 个未释放块，返回复制数；游标到达 PYRO_MEM_TRACE_LIVE_NUM 即遍历完 */
+    size_t xPortMemTraceCopyLive( size_t *pxCursor, pyro_mem_trace_event_t *pxOut, size_t xMax );
+
+#ifdef __cplusplus
+}
+#endif
+
+#if( PYRO_MEM_TRACE_EN == 1 )
+    #define PYRO_MEM_TRACE_ENTER() vPortMemTraceEnter( __builtin_return_address( 0 ) )
+    #define PYRO_MEM_TRACE_EXIT()  vPortMemTraceExit()
+#else
+    #define PYRO_MEM_TRACE_ENTER()
+    #define PYRO_MEM_TRACE_EXIT()
+#endif
+
+#endif
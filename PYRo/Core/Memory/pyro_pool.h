@@ -0,0 +1,249 @@
+#ifndef __PYRO_POOL_H__
+#define __PYRO_POOL_H__
+
+#include "FreeRTOS.h"
+#include "pyro_mem_trace.h"
+#include "task.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace pyro
+{
+/**
+ * @brief 对象池统计。
+ */
+struct pool_stats_t
+{
+    uint16_t capacity;   // 槽位总数
+    uint16_t used;       // 当前占用
+    uint16_t high_water; // 历史最高占用
+    uint32_t fallbacks;  // 池满或对象过大而改用主堆的次数
+};
+
+/**
+ * @brief 定长槽位分配器 (slab)
+ *
+ * - N 个 SLOT_SIZE 字节的槽位连续存放，分配/释放均为 O(1)，无碎片、无块头。
+ * - 空闲槽位以单链表串起；从未用过的槽位按顺序取用，因此构造函数为 constexpr，
+ *   静态实例在 .bss 中零初始化，不需要运行期初始化。
+ * - 不加锁、不依赖 FreeRTOS，调用方负责互斥。
+ */
+template <size_t SLOT_SIZE, size_t N, size_t ALIGN = alignof(std::max_align_t)>
+class slab_t
+{
+    static_assert(N > 0 && N <= UINT16_MAX, "invalid slab capacity");
+    static_assert((ALIGN & (ALIGN - 1)) == 0, "alignment must be a power of 2");
+
+  public:
+    static constexpr size_t slot_size = SLOT_SIZE;
+    static constexpr size_t capacity  = N;
+
+    constexpr slab_t()
+        : _slots{}, _free(nullptr), _fresh(0), _used(0), _high_water(0),
+          _fallbacks(0)
+    {
+    }
+
+    slab_t(const slab_t &)            = delete;
+    slab_t &operator=(const slab_t &) = delete;
+
+    /**
+     * @brief 取一个槽位，池满时返回 nullptr。
+     */
+    void *allocate()
+    {
+        slot_t *slot = _free;
+        if (slot)
+        {
+            _free = slot->next;
+        }
+        else if (_fresh < N)
+        {
+            slot = &_slots[_fresh++];
+        }
+        else
+        {
+            return nullptr;
+        }
+
+        if (++_used > _high_water)
+        {
+            _high_water = _used;
+        }
+        return slot->data;
+    }
+
+    /**
+     * @brief 归还槽位，p 不属于本池时返回 false。
+     */
+    bool deallocate(void *p)
+    {
+        if (!owns(p))
+        {
+            return false;
+        }
+        slot_t *slot = reinterpret_cast<slot_t *>(p);
+        slot->next   = _free;
+        _free        = slot;
+        _used--;
+        return true;
+    }
+
+    bool owns(const void *p) const
+    {
+        const uintptr_t addr  = reinterpret_cast<uintptr_t>(p);
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(&_slots[0]);
+        return addr >= begin && addr < begin + sizeof(_slots) &&
+               (addr - begin) % sizeof(slot_t) == 0;
+    }
+
+    void count_fallback()
+    {
+        _fallbacks++;
+    }
+
+    pool_stats_t get_stats() const
+    {
+        return pool_stats_t{static_cast<uint16_t>(N), _used, _high_water,
+                            _fallbacks};
+    }
+
+  private:
+    union slot_t
+    {
+        slot_t *next;
+        alignas(ALIGN) uint8_t data[SLOT_SIZE];
+    };
+
+    slot_t _slots[N];
+    slot_t *_free;
+    uint16_t _fresh;
+    uint16_t _used;
+    uint16_t _high_water;
+    uint32_t _fallbacks;
+};
+
+/**
+ * @brief 类型化对象池，create/destroy 负责构造与析构。
+ *
+ * 与 slab_t 相同不加锁；多任务共享时由调用方加锁。
+ */
+template <typename T, size_t N> class pool_t
+{
+  public:
+    constexpr pool_t() = default;
+
+    template <typename... Args> T *create(Args &&...args)
+    {
+        void *p = _slab.allocate();
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void destroy(T *obj)
+    {
+        if (obj)
+        {
+            obj->~T();
+            _slab.deallocate(obj);
+        }
+    }
+
+    bool owns(const T *obj) const
+    {
+        return _slab.owns(obj);
+    }
+
+    pool_stats_t get_stats() const
+    {
+        return _slab.get_stats();
+    }
+
+  private:
+    slab_t<sizeof(T), N, alignof(T)> _slab;
+};
+
+/**
+ * @brief 为一个类族提供类专属 operator new/delete。
+ *
+ * 类族基类继承 pool_new_t<基类, N, 槽位大小>，其所有派生类的 new/delete
+ * 都从同一个 slab 分配；池满或派生类超过槽位大小时退回主堆 (pvPortMalloc)
+ * 并计入 fallbacks，因此不会比原来的全局 new 更差。
+ * SLOT_SIZE 为 0 时取 sizeof(Family)（在首次 new 时求值，此时类型已完整）。
+ * 通过基类指针 delete 时基类须有虚析构函数。
+ */
+template <typename Family, size_t N, size_t SLOT_SIZE = 0> class pool_new_t
+{
+  public:
+    static void *operator new(const std::size_t size)
+    {
+        auto &slab = pool();
+        void *p    = nullptr;
+
+        taskENTER_CRITICAL();
+        if (size <= slab.slot_size)
+        {
+            p = slab.allocate();
+        }
+        if (!p)
+        {
+            slab.count_fallback();
+        }
+        taskEXIT_CRITICAL();
+
+        if (!p)
+        {
+            PYRO_MEM_TRACE_ENTER();
+            p = pvPortMalloc(size);
+            PYRO_MEM_TRACE_EXIT();
+        }
+        return p;
+    }
+
+    static void operator delete(void *p) noexcept
+    {
+        if (!p)
+        {
+            return;
+        }
+
+        bool pooled;
+        taskENTER_CRITICAL();
+        pooled = pool().deallocate(p);
+        taskEXIT_CRITICAL();
+
+        if (!pooled)
+        {
+            vPortFree(p);
+        }
+    }
+
+    // 类专属 operator new 会隐藏全局 placement new，需重新引入
+    static void *operator new(const std::size_t, void *p) noexcept
+    {
+        return p;
+    }
+
+    static void operator delete(void *, void *) noexcept
+    {
+    }
+
+    static pool_stats_t get_pool_stats()
+    {
+        taskENTER_CRITICAL();
+        const pool_stats_t stats = pool().get_stats();
+        taskEXIT_CRITICAL();
+        return stats;
+    }
+
+  private:
+    static auto &pool()
+    {
+        static slab_t<SLOT_SIZE ? SLOT_SIZE : sizeof(Family), N> slab;
+        return slab;
+    }
+};
+} // namespace pyro
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef __PYRO_STATIC_ALLOC_H__
+#define __PYRO_STATIC_ALLOC_H__
+
+#include "FreeRTOS.h"
+#include "message_buffer.h"
+#include "pyro_core_config.h"
+#include "semphr.h"
+#include "task.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/*
+ * FreeRTOS 对象的存储。PYRO_STATIC_ALLOC_EN 为 1 时控制块、任务栈和缓冲区
+ * 都是对象自身的成员，用 xxxCreateStatic 创建，不占用主堆；为 0 时这些类
+ * 不含数据，create 退化为普通的 xxxCreate，任务删除后内存归还主堆。
+ * 存储对象的生命周期必须覆盖它所创建的 FreeRTOS 对象。
+ */
+
+/**
+ * @brief 任务控制块与 DEPTH 字的任务栈。
+ */
+template <uint32_t DEPTH> class task_storage_t
+{
+  public:
+    BaseType_t create(TaskFunction_t func, const char *name, void *arg,
+                      UBaseType_t priority, TaskHandle_t *handle = nullptr)
+    {
+#if PYRO_STATIC_ALLOC_EN
+        TaskHandle_t task = xTaskCreateStatic(func, name, DEPTH, arg, priority,
+                                              _stack, &_tcb);
+        if (handle)
+        {
+            *handle = task;
+        }
+        return task ? pdPASS : pdFAIL;
+#else
+        return xTaskCreate(func, name, DEPTH, arg, priority, handle);
+#endif
+    }
+
+  private:
+#if PYRO_STATIC_ALLOC_EN
+    StaticTask_t _tcb;
+    StackType_t _stack[DEPTH];
+#endif
+};
+
+/**
+ * @brief 容量为 SIZE 字节的消息缓冲区。
+ */
+template <size_t SIZE> class message_buffer_storage_t
+{
+  public:
+    MessageBufferHandle_t create()
+    {
+#if PYRO_STATIC_ALLOC_EN
+        // 静态版本需要多 1 字节来区分满与空
+        return xMessageBufferCreateStatic(SIZE, _buffer, &_control);
+#else
+        return xMessageBufferCreate(SIZE);
+#endif
+    }
+
+  private:
+#if PYRO_STATIC_ALLOC_EN
+    StaticMessageBuffer_t _control;
+    uint8_t _buffer[SIZE + 1];
+#endif
+};
+
+/**
+ * @brief 一个互斥量或二值信号量。
+ */
+class semaphore_storage_t
+{
+  public:
+    SemaphoreHandle_t create_mutex()
+    {
+#if PYRO_STATIC_ALLOC_EN
+        return xSemaphoreCreateMutexStatic(&_control);
+#else
+        return xSemaphoreCreateMutex();
+#endif
+    }
+
+    SemaphoreHandle_t create_binary()
+    {
+#if PYRO_STATIC_ALLOC_EN
+        return xSemaphoreCreateBinaryStatic(&_control);
+#else
+        return xSemaphoreCreateBinary();
+#endif
+    }
+
+  private:
+#if PYRO_STATIC_ALLOC_EN
+    StaticSemaphore_t _control;
+#endif
+};
+} // namespace pyro
+
+#endif
@@ -0,0 +1,444 @@
+#include "pyro_tlsf.h"
+
+#include <string.h>
+
+/*
+ * 块布局：
+ *   [prev_phys | size] 块头，之后为用户数据；空闲块在用户数据区存放
+ *   next_free / prev_free。size 为含块头的整块长度，低 2 位为标志。
+ * 内存池末尾是一个长度为 0 的"已用"哨兵块，合并时无需判断越界。
+ */
+struct pyro_tlsf_block
+{
+    pyro_tlsf_block_t *prev_phys; /* 仅在 PREV_FREE 置位时有效 */
+    size_t size;
+    pyro_tlsf_block_t *next_free; /* 以下两项仅空闲块有效 */
+    pyro_tlsf_block_t *prev_free;
+};
+
+#define BLOCK_FREE      ((size_t)0x1)
+#define BLOCK_PREV_FREE ((size_t)0x2)
+#define BLOCK_FLAGS     (BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define BLOCK_HEADER    (2 * sizeof(void *))
+#define BLOCK_MIN       (4 * sizeof(void *))
+#define BLOCK_MAX       (((size_t)1 << PYRO_TLSF_FL_MAX) - PYRO_TLSF_ALIGN)
+
+_Static_assert(PYRO_TLSF_ALIGN == BLOCK_HEADER, "header must keep alignment");
+_Static_assert(PYRO_TLSF_SL_COUNT <= 32, "sl bitmap is 32 bit");
+_Static_assert(PYRO_TLSF_FL_COUNT <= 32, "fl bitmap is 32 bit");
+
+/* 位运算 ---------------------------------------------------------------------*/
+static inline int tlsf_ffs(const uint32_t word)
+{
+    return word ? __builtin_ctz(word) : -1;
+}
+
+static inline int tlsf_fls(const size_t size)
+{
+    return size ? (int)(sizeof(size_t) * 8 - 1) - __builtin_clzl((unsigned long)size) : -1;
+}
+
+static inline size_t align_up(const size_t x, const size_t align)
+{
+    return (x + align - 1) & ~(align - 1);
+}
+
+/* 块操作 ---------------------------------------------------------------------*/
+static inline size_t block_size(const pyro_tlsf_block_t *block)
+{
+    return block->size & ~BLOCK_FLAGS;
+}
+
+static inline void block_set_size(pyro_tlsf_block_t *block, const size_t size)
+{
+    block->size = size | (block->size & BLOCK_FLAGS);
+}
+
+static inline int block_is_free(const pyro_tlsf_block_t *block)
+{
+    return (block->size & BLOCK_FREE) != 0;
+}
+
+static inline int block_is_prev_free(const pyro_tlsf_block_t *block)
+{
+    return (block->size & BLOCK_PREV_FREE) != 0;
+}
+
+static inline pyro_tlsf_block_t *block_next(const pyro_tlsf_block_t *block)
+{
+    return (pyro_tlsf_block_t *)((uint8_t *)block + block_size(block));
+}
+
+static inline void *block_to_ptr(const pyro_tlsf_block_t *block)
+{
+    return (uint8_t *)block + BLOCK_HEADER;
+}
+
+static inline pyro_tlsf_block_t *block_from_ptr(const void *ptr)
+{
+    return (pyro_tlsf_block_t *)((uint8_t *)ptr - BLOCK_HEADER);
+}
+
+/* 设置空闲标志，并同步下一个块的 PREV_FREE 与 prev_phys */
+static void block_mark_free(pyro_tlsf_block_t *block)
+{
+    pyro_tlsf_block_t *next = block_next(block);
+    block->size |= BLOCK_FREE;
+    next->prev_phys = block;
+    next->size |= BLOCK_PREV_FREE;
+}
+
+static void block_mark_used(pyro_tlsf_block_t *block)
+{
+    pyro_tlsf_block_t *next = block_next(block);
+    block->size &= ~BLOCK_FREE;
+    next->size &= ~BLOCK_PREV_FREE;
+}
+
+/* 大小映射 -------------------------------------------------------------------*/
+static void mapping_insert(const size_t size, int *fl, int *sl)
+{
+    if (size < PYRO_TLSF_SMALL_BLOCK)
+    {
+        *fl = 0;
+        *sl = (int)(size / (PYRO_TLSF_SMALL_BLOCK / PYRO_TLSF_SL_COUNT));
+    }
+    else
+    {
+        const int t = tlsf_fls(size);
+        *sl = (int)(size >> (t - PYRO_TLSF_SL_LOG2)) ^ (int)PYRO_TLSF_SL_COUNT;
+        *fl = t - (int)PYRO_TLSF_FL_SHIFT + 1;
+    }
+}
+
+/* 向上取整到下一个二级区间，保证该区间内任意块都能满足请求 */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+    if (size >= PYRO_TLSF_SMALL_BLOCK)
+    {
+        size += ((size_t)1 << (tlsf_fls(size) - PYRO_TLSF_SL_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+/* 空闲链表 -------------------------------------------------------------------*/
+static void list_insert(pyro_tlsf_t *tlsf, pyro_tlsf_block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    pyro_tlsf_block_t *head = tlsf->blocks[fl][sl];
+    block->next_free        = head;
+    block->prev_free        = NULL;
+    if (head)
+    {
+        head->prev_free = block;
+    }
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= 1U << fl;
+    tlsf->sl_bitmap[fl] |= 1U << sl;
+    tlsf->stats.free_blocks++;
+    tlsf->stats.free_bytes += block_size(block);
+}
+
+static void list_remove(pyro_tlsf_t *tlsf, pyro_tlsf_block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    if (block->prev_free)
+    {
+        block->prev_free->next_free = block->next_free;
+    }
+    else
+    {
+        tlsf->blocks[fl][sl] = block->next_free;
+        if (NULL == block->next_free)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1U << sl);
+            if (0 == tlsf->sl_bitmap[fl])
+            {
+                tlsf->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+    if (block->next_free)
+    {
+        block->next_free->prev_free = block->prev_free;
+    }
+    tlsf->stats.free_blocks--;
+    tlsf->stats.free_bytes -= block_size(block);
+}
+
+/* 找到不小于 size 的空闲块所在链表；没有则返回 NULL */
+static pyro_tlsf_block_t *find_suitable(const pyro_tlsf_t *tlsf, const size_t size)
+{
+    int fl, sl;
+    mapping_search(size, &fl, &sl);
+    if (fl >= (int)PYRO_TLSF_FL_COUNT)
+    {
+        return NULL;
+    }
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0U << sl);
+    if (0 == sl_map)
+    {
+        const uint32_t fl_map = (fl + 1 < 32) ? tlsf->fl_bitmap & (~0U << (fl + 1)) : 0;
+        if (0 == fl_map)
+        {
+            return NULL;
+        }
+        fl     = tlsf_ffs(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+    return tlsf->blocks[fl][tlsf_ffs(sl_map)];
+}
+
+/* 拆分与合并 -----------------------------------------------------------------*/
+/* 把 block 切成 [size][剩余]，剩余部分足够大时作为空闲块放回 */
+static void block_trim_tail(pyro_tlsf_t *tlsf, pyro_tlsf_block_t *block, const size_t size)
+{
+    const size_t total = block_size(block);
+    if (total - size >= BLOCK_MIN)
+    {
+        pyro_tlsf_block_t *rest = (pyro_tlsf_block_t *)((uint8_t *)block + size);
+        rest->size              = total - size;
+        block_set_size(block, size);
+        block_mark_free(rest);
+        list_insert(tlsf, rest);
+    }
+}
+
+/* 把 block 的前 gap 字节切成独立空闲块，返回后半部分（仍为空闲、未入链） */
+static pyro_tlsf_block_t *block_trim_head(pyro_tlsf_t *tlsf, pyro_tlsf_block_t *block, const size_t gap)
+{
+    const size_t total      = block_size(block);
+    pyro_tlsf_block_t *rest = (pyro_tlsf_block_t *)((uint8_t *)block + gap);
+    block_set_size(block, gap);
+    rest->size = (total - gap) | BLOCK_FREE;
+    block_mark_free(block);
+    list_insert(tlsf, block);
+    return rest;
+}
+
+static void *block_prepare_used(pyro_tlsf_t *tlsf, pyro_tlsf_block_t *block, const size_t size)
+{
+    block_trim_tail(tlsf, block, size);
+    block_mark_used(block);
+    tlsf->stats.allocations++;
+    if (tlsf->stats.free_bytes < tlsf->stats.min_ever_free_bytes)
+    {
+        tlsf->stats.min_ever_free_bytes = tlsf->stats.free_bytes;
+    }
+    return block_to_ptr(block);
+}
+
+static size_t adjust_request(const size_t size)
+{
+    if (0 == size || size > BLOCK_MAX)
+    {
+        return 0;
+    }
+    const size_t total = align_up(size + BLOCK_HEADER, PYRO_TLSF_ALIGN);
+    return total < BLOCK_MIN ? BLOCK_MIN : total;
+}
+
+/* 接口 -----------------------------------------------------------------------*/
+int pyro_tlsf_init(pyro_tlsf_t *tlsf, void *mem, const size_t size)
+{
+    memset(tlsf, 0, sizeof(*tlsf));
+    const uintptr_t start = align_up((uintptr_t)mem, PYRO_TLSF_ALIGN);
+    const uintptr_t end   = ((uintptr_t)mem + size) & ~(uintptr_t)(PYRO_TLSF_ALIGN - 1);
+    if (end <= start || end - start < BLOCK_MIN + BLOCK_HEADER ||
+        end - start - BLOCK_HEADER > BLOCK_MAX)
+    {
+        return -1;
+    }
+    tlsf->pool_start = (uint8_t *)start;
+    tlsf->pool_end   = (uint8_t *)end;
+
+    pyro_tlsf_block_t *block = (pyro_tlsf_block_t *)start;
+    block->prev_phys         = NULL;
+    block->size              = end - start - BLOCK_HEADER;
+
+    /* 哨兵：长度 0、已用，只有块头 */
+    pyro_tlsf_block_t *sentinel = block_next(block);
+    sentinel->size              = 0;
+    block_mark_free(block);
+    list_insert(tlsf, block);
+
+    tlsf->stats.min_ever_free_bytes = tlsf->stats.free_bytes;
+    return 0;
+}
+
+void *pyro_tlsf_malloc(pyro_tlsf_t *tlsf, const size_t size)
+{
+    const size_t total = adjust_request(size);
+    if (0 == total)
+    {
+        return NULL;
+    }
+    pyro_tlsf_block_t *block = find_suitable(tlsf, total);
+    if (NULL == block)
+    {
+        return NULL;
+    }
+    list_remove(tlsf, block);
+    return block_prepare_used(tlsf, block, total);
+}
+
+void *pyro_tlsf_memalign(pyro_tlsf_t *tlsf, const size_t align, const size_t size)
+{
+    if (align <= PYRO_TLSF_ALIGN)
+    {
+        return pyro_tlsf_malloc(tlsf, size);
+    }
+    if (align & (align - 1))
+    {
+        return NULL;
+    }
+    const size_t total = adjust_request(size);
+    if (0 == total || total + align + BLOCK_MIN > BLOCK_MAX)
+    {
+        return NULL;
+    }
+    /* 多找 align + BLOCK_MIN，保证前导空隙能独立成一个空闲块 */
+    pyro_tlsf_block_t *block = find_suitable(tlsf, total + align + BLOCK_MIN);
+    if (NULL == block)
+    {
+        return NULL;
+    }
+    list_remove(tlsf, block);
+
+    const uintptr_t ptr = (uintptr_t)block_to_ptr(block);
+    uintptr_t aligned   = align_up(ptr, align);
+    size_t gap          = aligned - ptr;
+    if (gap && gap < BLOCK_MIN)
+    {
+        aligned = align_up(ptr + BLOCK_MIN, align);
+        gap     = aligned - ptr;
+    }
+    if (gap)
+    {
+        block = block_trim_head(tlsf, block, gap);
+    }
+    return block_prepare_used(tlsf, block, total);
+}
+
+void pyro_tlsf_free(pyro_tlsf_t *tlsf, void *ptr)
+{
+    if (NULL == ptr)
+    {
+        return;
+    }
+    pyro_tlsf_block_t *block = block_from_ptr(ptr);
+    if (block_is_free(block))
+    {
+        return; /* 重复释放 */
+    }
+    tlsf->stats.frees++;
+
+    if (block_is_prev_free(block))
+    {
+        pyro_tlsf_block_t *prev = block->prev_phys;
+        list_remove(tlsf, prev);
+        block_set_size(prev, block_size(prev) + block_size(block));
+        block = prev;
+    }
+    pyro_tlsf_block_t *next = block_next(block);
+    if (block_is_free(next))
+    {
+        list_remove(tlsf, next);
+        block_set_size(block, block_size(block) + block_size(next));
+    }
+    block_mark_free(block);
+    list_insert(tlsf, block);
+}
+
+size_t pyro_tlsf_usable_size(const void *ptr)
+{
+    return ptr ? block_size(block_from_ptr(ptr)) - BLOCK_HEADER : 0;
+}
+
+size_t pyro_tlsf_largest_free(const pyro_tlsf_t *tlsf)
+{
+    if (0 == tlsf->fl_bitmap)
+    {
+        return 0;
+    }
+    const int fl = tlsf_fls(tlsf->fl_bitmap);
+    const int sl = tlsf_fls(tlsf->sl_bitmap[fl]);
+    size_t largest = 0;
+    for (const pyro_tlsf_block_t *b = tlsf->blocks[fl][sl]; b; b = b->next_free)
+    {
+        largest = block_size(b) > largest ? block_size(b) : largest;
+    }
+    return largest;
+}
+
+size_t pyro_tlsf_smallest_free(const pyro_tlsf_t *tlsf)
+{
+    if (0 == tlsf->fl_bitmap)
+    {
+        return 0;
+    }
+    const int fl = tlsf_ffs(tlsf->fl_bitmap);
+    const int sl = tlsf_ffs(tlsf->sl_bitmap[fl]);
+    size_t smallest = (size_t)-1;
+    for (const pyro_tlsf_block_t *b = tlsf->blocks[fl][sl]; b; b = b->next_free)
+    {
+        smallest = block_size(b) < smallest ? block_size(b) : smallest;
+    }
+    return smallest;
+}
+
+int pyro_tlsf_check(const pyro_tlsf_t *tlsf)
+{
+    size_t free_blocks = 0, free_bytes = 0;
+    int prev_free = 0;
+    const pyro_tlsf_block_t *prev = NULL;
+    const pyro_tlsf_block_t *block = (const pyro_tlsf_block_t *)tlsf->pool_start;
+
+    while (block_size(block))
+    {
+        if ((uint8_t *)block_next(block) > tlsf->pool_end - BLOCK_HEADER)
+            return 1; /* 越界 */
+        if (block_is_prev_free(block) != prev_free)
+            return 2; /* PREV_FREE 与前一块不符 */
+        if (prev_free && block->prev_phys != prev)
+            return 3;
+        if (block_is_free(block))
+        {
+            if (prev_free)
+                return 4; /* 相邻空闲块未合并 */
+            int fl, sl;
+            mapping_insert(block_size(block), &fl, &sl);
+            const pyro_tlsf_block_t *b = tlsf->blocks[fl][sl];
+            while (b && b != block)
+                b = b->next_free;
+            if (NULL == b)
+                return 5; /* 空闲块不在对应链表中 */
+            free_blocks++;
+            free_bytes += block_size(block);
+        }
+        prev_free = block_is_free(block);
+        prev      = block;
+        block     = block_next(block);
+    }
+    if ((uint8_t *)block != tlsf->pool_end - BLOCK_HEADER)
+        return 6; /* 哨兵位置错误 */
+    if (block_is_prev_free(block) != prev_free)
+        return 7;
+    if (free_blocks != tlsf->stats.free_blocks || free_bytes != tlsf->stats.free_bytes)
+        return 8;
+    for (int fl = 0; fl < (int)PYRO_TLSF_FL_COUNT; fl++)
+    {
+        const int fl_set = (tlsf->fl_bitmap >> fl) & 1;
+        if (fl_set != (tlsf->sl_bitmap[fl] != 0))
+            return 9;
+        for (int sl = 0; sl < (int)PYRO_TLSF_SL_COUNT; sl++)
+        {
+            if (((tlsf->sl_bitmap[fl] >> sl) & 1) != (tlsf->blocks[fl][sl] != NULL))
+                return 10;
+        }
+    }
+    return 0;
+}
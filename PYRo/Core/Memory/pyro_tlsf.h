@@ -0,0 +1,94 @@
+#ifndef __PYRO_TLSF_H__
+#define __PYRO_TLSF_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * TLSF (Two-Level Segregated Fit) 分配器核心。
+ *
+ * - malloc / free / memalign 均为 O(1)：两级位图定位空闲链表，
+ *   释放时只与物理相邻块合并，不遍历链表。
+ * - 每个块 2 个指针宽的头部（目标板 8 字节，与 heap_4 相同），
+ *   返回地址按 PYRO_TLSF_ALIGN 对齐；memalign 支持任意 2 的幂对齐，
+ *   对齐产生的前导空隙作为空闲块放回，不浪费。
+ * - 不加锁、不依赖 FreeRTOS，可在主机上直接测试；
+ *   调用方负责互斥（例如 vTaskSuspendAll）。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 一级：2 的幂区间；二级：每个区间再线性均分为 2^SL_LOG2 份 */
+#ifndef PYRO_TLSF_SL_LOG2
+#define PYRO_TLSF_SL_LOG2 4
+#endif
+/* 可管理的最大块为 2^FL_MAX 字节 */
+#ifndef PYRO_TLSF_FL_MAX
+#define PYRO_TLSF_FL_MAX 20
+#endif
+
+#define PYRO_TLSF_ALIGN         (2 * sizeof(void *))
+#define PYRO_TLSF_SL_COUNT      (1U << PYRO_TLSF_SL_LOG2)
+#define PYRO_TLSF_FL_SHIFT      (PYRO_TLSF_SL_LOG2 + (sizeof(void *) == 8 ? 4 : 3))
+#define PYRO_TLSF_SMALL_BLOCK   ((size_t)1 << PYRO_TLSF_FL_SHIFT)
+#define PYRO_TLSF_FL_COUNT      (PYRO_TLSF_FL_MAX - PYRO_TLSF_FL_SHIFT + 1)
+
+typedef struct pyro_tlsf_block pyro_tlsf_block_t;
+
+typedef struct
+{
+    size_t free_bytes;          /* 空闲块总字节数（含块头） */
+    size_t min_ever_free_bytes; /* 历史最小空闲字节数 */
+    size_t free_blocks;         /* 空闲块个数 */
+    size_t allocations;         /* 成功分配次数 */
+    size_t frees;               /* 成功释放次数 */
+} pyro_tlsf_stats_t;
+
+/* 控制块：位图与空闲链表头，独立于内存池存放 */
+typedef struct
+{
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[PYRO_TLSF_FL_COUNT];
+    pyro_tlsf_block_t *blocks[PYRO_TLSF_FL_COUNT][PYRO_TLSF_SL_COUNT];
+    uint8_t *pool_start;
+    uint8_t *pool_end;
+    pyro_tlsf_stats_t stats;
+} pyro_tlsf_t;
+
+/**
+ * @brief 用 [mem, mem + size) 初始化一个内存池。
+ * @return 0 成功，-1 内存过小或过大。
+ */
+int pyro_tlsf_init(pyro_tlsf_t *tlsf, void *mem, size_t size);
+
+void *pyro_tlsf_malloc(pyro_tlsf_t *tlsf, size_t size);
+/**
+ * @brief 按 align（2 的幂）对齐分配。
+ */
+void *pyro_tlsf_memalign(pyro_tlsf_t *tlsf, size_t align, size_t size);
+void pyro_tlsf_free(pyro_tlsf_t *tlsf, void *ptr);
+
+/**
+ * @brief 块的实际可用字节数，ptr 为 NULL 时返回 0。
+ */
+size_t pyro_tlsf_usable_size(const void *ptr);
+
+/**
+ * @brief 最大/最小空闲块字节数，只遍历一条空闲链表，用于统计。
+ */
+size_t pyro_tlsf_largest_free(const pyro_tlsf_t *tlsf);
+size_t pyro_tlsf_smallest_free(const pyro_tlsf_t *tlsf);
+
+/**
+ * @brief 遍历整个内存池校验块头、标志和空闲链表，O(n)，仅用于调试。
+ * @return 0 正常，否则为第一个错误的编号。
+ */
+int pyro_tlsf_check(const pyro_tlsf_t *tlsf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,21 +1,32 @@
 #include "cmsis_os.h"
 #include "pyro_core_config.h"
+#include "pyro_static_alloc.h"
 #include "task.h"
 
 extern "C"
 {
     extern void pyro_vofa_task(void *arg);
     extern void pyro_jcom_task(void *arg);
+    extern void pyro_mem_report_task(void *arg);
     void start_debug_task(void *arg)
     {
 #if VOFA_DEBUG_EN
-        xTaskCreate(pyro_vofa_task, "pyro_vofa_demo", 128, nullptr,
-                    tskIDLE_PRIORITY + 1, nullptr);
+        static pyro::task_storage_t<128> vofa_task_storage;
+        vofa_task_storage.create(pyro_vofa_task, "pyro_vofa_demo", nullptr,
+                                 tskIDLE_PRIORITY + 1);
 #endif
 
 #if JCOM_DEBUG_EN
-        xTaskCreate(pyro_jcom_task, "pyro_jcom_task", 128, nullptr,
-                    tskIDLE_PRIORITY + 1, nullptr);
+        static pyro::task_storage_t<128> jcom_task_storage;
+        jcom_task_storage.create(pyro_jcom_task, "pyro_jcom_task", nullptr,
+                                 tskIDLE_PRIORITY + 1);
+#endif
+
+#if MEM_REPORT_DEBUG_EN
+        static pyro::task_storage_t<256> mem_report_task_storage;
+        mem_report_task_storage.create(pyro_mem_report_task,
+                                       "pyro_mem_report", nullptr,
+                                       tskIDLE_PRIORITY + 1);
 #endif
         vTaskDelete(nullptr);
     }
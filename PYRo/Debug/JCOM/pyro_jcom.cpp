@@ -12,6 +12,7 @@ jcom_drv_t::jcom_drv_t(uint8_t max_length, uart_drv_t *uart)
     _data_pack = static_cast<float *>(pvPortDmaMalloc(4 * max_length));
     _length    = 0;
     _jcom_uart = uart;
+    _busy.store(false, std::memory_order_relaxed);
 }
 
 jcom_drv_t::~jcom_drv_t()
@@ -84,18 +85,37 @@ void jcom_drv_t::update_data()
     _data_pack[offset] = *reinterpret_cast<float *>(frame_tail);
 }
 
+// _data_pack is rebuilt every cycle, so it is only touched again once the
+// previous frame has left the DMA
 void jcom_drv_t::send()
 {
-    _jcom_uart->write(reinterpret_cast<uint8_t *>(_data_pack),
-                      (_length + 1) * 4);
+    _busy.store(true, std::memory_order_relaxed);
+    const uart_tx_seg_t seg = {reinterpret_cast<uint8_t *>(_data_pack),
+                               static_cast<uint16_t>((_length + 1) * 4)};
+    if (PYRO_OK !=
+        _jcom_uart->write_frame(
+            &seg, 1,
+            uart_drv_t::tx_done_func::bind<jcom_drv_t,
+                                           &jcom_drv_t::on_tx_done>(this)))
+    {
+        _busy.store(false, std::memory_order_relaxed);
+    }
+}
+
+void jcom_drv_t::on_tx_done(BaseType_t &)
+{
+    _busy.store(false, std::memory_order_release);
 }
 
 void jcom_drv_t::thread()
 {
     while (true)
     {
-        update_data();
-        send();
+        if (!_busy.load(std::memory_order_acquire))
+        {
+            update_data();
+            send();
+        }
         vTaskDelay(1);
     }
 }
@@ -104,6 +124,6 @@ void jcom_drv_t::thread()
 
 extern "C" void pyro_jcom_task(void *arg)
 {
-    pyro::jcom_drv_t &jcom = pyro::jcom_drv_t::get_instance(15);
+    pyro::jcom_drv_t &jcom = pyro::jcom_drv_t::get_instance();
     jcom.thread();
 }
\ No newline at end of file
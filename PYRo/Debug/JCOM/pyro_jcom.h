@@ -2,6 +2,7 @@
 #define __PYRO_JCOM_H__
 
 #include "pyro_uart_drv.h"
+#include "atomic"
 #include "vector"
 
 namespace pyro
@@ -11,7 +12,9 @@ class jcom_drv_t
 public:
     explicit jcom_drv_t(uint8_t max_length, uart_drv_t *uart);
     ~jcom_drv_t();
-    static jcom_drv_t &get_instance(uint8_t max_length);
+    static constexpr uint8_t DEFAULT_LENGTH = 15;
+
+    static jcom_drv_t &get_instance(uint8_t max_length = DEFAULT_LENGTH);
     void thread();
 
 private:
@@ -21,6 +24,7 @@ private:
     void remove_data(const float *data);
     void update_data();
     void send();
+    void on_tx_done(BaseType_t &woken);
 
     typedef struct
     {
@@ -32,6 +36,7 @@ private:
     float *_data_pack;
     uint8_t _length;
     uart_drv_t *_jcom_uart;
+    std::atomic<bool> _busy;
 };
 
 
@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""Decoder for the memory report sent by pyro_mem_report (PYRo/Debug/MEM).
+
+Reads the debug UART stream from a serial port (needs pyserial) or from a
+captured file, and prints per report: heap and region usage with
+fragmentation, task stack high-water marks, the allocation events since the
+previous report and the live blocks grouped by call site. On exit it lists
+the call sites whose live bytes grew between the first and the last report.
+
+    mem_report.py /dev/ttyUSB0 --baud 921600 --elf build/PYRo.elf
+    mem_report.py capture.bin
+
+Frame: 0xA5 | type | seq | len (u16 LE) | payload | CRC16 (u16 LE), CRC-16
+reflected 0x1021, init 0xFFFF, over header and payload (pyro_crc16).
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+from collections import defaultdict
+
+SOF = 0xA5
+HEADER_SIZE = 5
+MAX_PAYLOAD = 1024
+
+FRAME_BEGIN, FRAME_HEAP, FRAME_TASK, FRAME_EVENT, FRAME_LIVE, FRAME_END = range(1, 7)
+
+# pyro_mem_region_t; the main FreeRTOS heap is PYRO_MEM_REGION_NONE
+HEAP_NAMES = {0: "DTCM", 1: "AXI", 2: "D2", 3: "D3", 4: "main"}
+TASK_STATES = ["running", "ready", "blocked", "suspended", "deleted", "invalid"]
+
+# pyro_mem_trace_event_t.ulInfo
+FREE_FLAG = 1 << 31
+HEAP_SHIFT = 28
+HEAP_MASK = 0x7 << HEAP_SHIFT
+SIZE_MASK = 0x0FFFFFFF
+
+EVENT = struct.Struct("<IIII")
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+    return crc
+
+
+class FrameParser:
+    """Splits a byte stream into (type, payload), resyncing on bad frames."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.crc_errors = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            start = self.buf.find(bytes([SOF]))
+            if start < 0:
+                self.buf.clear()
+                return
+            del self.buf[:start]
+            if len(self.buf) < HEADER_SIZE:
+                return
+            length = self.buf[3] | (self.buf[4] << 8)
+            if length > MAX_PAYLOAD:
+                del self.buf[0]
+                continue
+            total = HEADER_SIZE + length + 2
+            if len(self.buf) < total:
+                return
+            frame = bytes(self.buf[:total])
+            if crc16(frame[:-2]) != (frame[-2] | (frame[-1] << 8)):
+                self.crc_errors += 1
+                del self.buf[0]
+                continue
+            del self.buf[:total]
+            yield frame[1], frame[HEADER_SIZE:-2]
+
+
+def unpack_events(payload):
+    first, = struct.unpack_from("<I", payload)
+    return first, [EVENT.unpack_from(payload, off) for off in range(4, len(payload), EVENT.size)]
+
+
+class Symbolizer:
+    """Maps code addresses to function:line through addr2line, cached."""
+
+    def __init__(self, elf, tool):
+        self.elf = elf
+        self.tool = tool
+        self.cache = {}
+
+    def __call__(self, addr):
+        if not addr:
+            return "-"
+        if not self.elf:
+            return "0x%08x" % addr
+        if addr not in self.cache:
+            # Return address: step back into the call instruction, drop the Thumb bit
+            pc = (addr & ~1) - 1
+            try:
+                out = subprocess.run([self.tool, "-e", self.elf, "-f", "-C", "-s", "%x" % pc],
+                                     capture_output=True, text=True, check=True).stdout.split("\n")
+                self.cache[addr] = "%s (%s)" % (out[0], out[1])
+            except (OSError, subprocess.CalledProcessError, IndexError):
+                self.cache[addr] = "0x%08x" % addr
+        return self.cache[addr]
+
+
+class Report:
+    def __init__(self, payload):
+        self.tick, self.trace_depth, self.live_capacity = struct.unpack_from("<IHH", payload)
+        self.heaps = []
+        self.tasks = []
+        self.events = []
+        self.live = []
+        self.stats = None
+
+
+class Decoder:
+    def __init__(self, symbolize, out=sys.stdout):
+        self.sym = symbolize
+        self.out = out
+        self.report = None
+        self.reports = 0
+        self.task_names = {}
+        self.next_event = None
+        self.first_sites = None
+        self.last_sites = None
+
+    def on_frame(self, ftype, payload):
+        if ftype == FRAME_BEGIN:
+            self.report = Report(payload)
+            return
+        if self.report is None:
+            return
+        if ftype == FRAME_HEAP:
+            self.report.heaps.append(struct.unpack_from("<B3xIIIIIIII", payload))
+        elif ftype == FRAME_TASK:
+            handle, base, hwm, prio, state = struct.unpack_from("<IIIBB2x", payload)
+            name = payload[16:32].split(b"\0", 1)[0].decode("ascii", "replace")
+            self.task_names[handle] = name
+            self.report.tasks.append((name, handle, base, hwm, prio, state))
+        elif ftype == FRAME_EVENT:
+            first, events = unpack_events(payload)
+            self.report.events.extend((first + i, ev) for i, ev in enumerate(events))
+        elif ftype == FRAME_LIVE:
+            self.report.live.extend(unpack_events(payload)[1])
+        elif ftype == FRAME_END:
+            self.report.stats = struct.unpack_from("<IIII", payload)
+            self.print_report(self.report)
+            self.report = None
+
+    def task(self, handle):
+        if not handle:
+            return "(init)"
+        return self.task_names.get(handle, "0x%08x" % handle)
+
+    def p(self, *args):
+        print(*args, file=self.out)
+
+    def print_report(self, r):
+        self.reports += 1
+        self.p("=== report %d  t=%.3f s ===" % (self.reports, r.tick / 1000.0))
+
+        self.p("%-5s %8s %8s %6s %8s %8s %6s %5s" %
+               ("heap", "size", "free", "used", "min", "largest", "blocks", "frag"))
+        for hid, total, largest, _smallest, blocks, free, allocs, frees, min_free in r.heaps:
+            used = (total - free) * 100.0 / total if total else 0.0
+            frag = 1.0 - largest / free if free else 0.0
+            self.p("%-5s %8d %8d %5.1f%% %8d %8d %6d %5.2f   allocs %d frees %d" %
+                   (HEAP_NAMES.get(hid, str(hid)), total, free, used, min_free, largest, blocks,
+                    frag, allocs, frees))
+
+        if r.tasks:
+            self.p("%-16s %4s %-9s %10s %6s" % ("task", "prio", "state", "stack", "free"))
+            for name, _handle, base, hwm, prio, state in sorted(r.tasks, key=lambda t: t[3]):
+                st = TASK_STATES[state] if state < len(TASK_STATES) else str(state)
+                self.p("%-16s %4d %-9s 0x%08x %6d%s" %
+                       (name, prio, st, base, hwm, "  <-- low" if hwm < 128 else ""))
+
+        if r.events:
+            if self.next_event is not None and r.events[0][0] != self.next_event:
+                self.p("(%d events lost, raise PYRO_MEM_TRACE_DEPTH or lower the period)" %
+                       (r.events[0][0] - self.next_event))
+            self.next_event = r.events[-1][0] + 1
+            for seq, (addr, caller, task, info) in r.events:
+                heap = HEAP_NAMES.get((info & HEAP_MASK) >> HEAP_SHIFT, "?")
+                kind = "free " if info & FREE_FLAG else ("alloc" if addr else "FAIL ")
+                self.p("  #%-6d %s %-4s %6d 0x%08x %-16s %s" %
+                       (seq, kind, heap, info & SIZE_MASK, addr, self.task(task), self.sym(caller)))
+
+        sites = defaultdict(lambda: [0, 0])
+        for _addr, caller, task, info in r.live:
+            site = sites[(caller, task)]
+            site[0] += 1
+            site[1] += info & SIZE_MASK
+        if sites:
+            self.p("%6s %8s  %-16s %s" % ("blocks", "bytes", "task", "call site"))
+            for (caller, task), (count, size) in sorted(sites.items(), key=lambda s: -s[1][1]):
+                self.p("%6d %8d  %-16s %s" % (count, size, self.task(task), self.sym(caller)))
+        if self.first_sites is None:
+            self.first_sites = dict(sites)
+        self.last_sites = dict(sites)
+
+        if r.stats:
+            events, live, overflow, failures = r.stats
+            self.p("events %d  live %d  untracked %d  failed %d" % (events, live, overflow, failures))
+        self.p("")
+
+    def print_leaks(self):
+        if self.reports < 2 or self.first_sites is None:
+            return
+        grown = []
+        for key, (count, size) in self.last_sites.items():
+            first = self.first_sites.get(key, (0, 0))
+            if size > first[1]:
+                grown.append((size - first[1], count - first[0], key))
+        self.p("=== live growth over %d reports ===" % self.reports)
+        if not grown:
+            self.p("none")
+        for size, count, (caller, task) in sorted(grown, reverse=True):
+            self.p("%+8d B %+5d blocks  %-16s %s" % (size, count, self.task(task), self.sym(caller)))
+
+
+def open_source(path, baud):
+    try:
+        import serial  # pylint: disable=import-outside-toplevel
+        return serial.Serial(path, baud, timeout=0.2)
+    except ImportError:
+        return open(path, "rb")
+    except (OSError, ValueError):
+        return open(path, "rb")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("source", help="serial port or captured stream file")
+    ap.add_argument("--baud", type=int, default=921600)
+    ap.add_argument("--elf", help="firmware ELF for resolving call sites")
+    ap.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    ap.add_argument("--count", type=int, default=0, help="stop after N reports")
+    args = ap.parse_args()
+
+    parser = FrameParser()
+    decoder = Decoder(Symbolizer(args.elf, args.addr2line))
+    src = open_source(args.source, args.baud)
+    is_file = not hasattr(src, "in_waiting")
+    try:
+        while not args.count or decoder.reports < args.count:
+            data = src.read(4096)
+            if not data and is_file:
+                break
+            for ftype, payload in parser.feed(data):
+                decoder.on_frame(ftype, payload)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        src.close()
+    decoder.print_leaks()
+    if parser.crc_errors:
+        print("%d frames dropped (CRC)" % parser.crc_errors)
+
+
+if __name__ == "__main__":
+    main()
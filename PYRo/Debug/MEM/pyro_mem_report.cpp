@@ -0,0 +1,284 @@
+#include "pyro_mem_report.h"
+
+#include "pyro_core_config.h"
+#include "pyro_crc.h"
+#include "pyro_mem_region.h"
+
+#include "cstring"
+
+#ifndef MEM_REPORT_PERIOD_MS
+#define MEM_REPORT_PERIOD_MS 1000
+#endif
+
+namespace pyro
+{
+mem_report_t::mem_report_t(uart_drv_t *uart)
+    : _uart(uart), _buf(FRAME_MAX_SIZE), _len(0), _seq(0), _event_seq(0),
+      _task(nullptr)
+{
+}
+
+mem_report_t &mem_report_t::get_instance()
+{
+    static mem_report_t instance(uart_drv_t::get_instance(uart_drv_t::uart1));
+    return instance;
+}
+
+// ----------------------------------------------------------------
+// frame packing
+// ----------------------------------------------------------------
+
+void mem_report_t::begin_frame(const frame_type_t type)
+{
+    uint8_t *p = _buf.data();
+    p[0]       = FRAME_SOF;
+    p[1]       = type;
+    p[2]       = _seq++;
+    _len       = FRAME_HEADER_SIZE;
+}
+
+void mem_report_t::put_u8(const uint8_t v)
+{
+    _buf.data()[_len++] = v;
+}
+
+void mem_report_t::put_u16(const uint16_t v)
+{
+    put_u8(static_cast<uint8_t>(v));
+    put_u8(static_cast<uint8_t>(v >> 8));
+}
+
+void mem_report_t::put_u32(const uint32_t v)
+{
+    put_u16(static_cast<uint16_t>(v));
+    put_u16(static_cast<uint16_t>(v >> 16));
+}
+
+void mem_report_t::put_heap(const uint8_t id, const uint32_t total,
+                            const HeapStats_t &stats)
+{
+    put_u8(id);
+    put_u8(0);
+    put_u16(0);
+    put_u32(total);
+    put_u32(stats.xSizeOfLargestFreeBlockInBytes);
+    put_u32(stats.xSizeOfSmallestFreeBlockInBytes);
+    put_u32(stats.xNumberOfFreeBlocks);
+    put_u32(stats.xAvailableHeapSpaceInBytes);
+    put_u32(stats.xNumberOfSuccessfulAllocations);
+    put_u32(stats.xNumberOfSuccessfulFrees);
+    put_u32(stats.xMinimumEverFreeBytesRemaining);
+}
+
+void mem_report_t::put_event(const pyro_mem_trace_event_t &ev)
+{
+    put_u32(ev.ulAddress);
+    put_u32(ev.ulCaller);
+    put_u32(ev.ulTask);
+    put_u32(ev.ulInfo);
+}
+
+void mem_report_t::send_frame()
+{
+    uint8_t *p             = _buf.data();
+    const uint16_t payload = _len - FRAME_HEADER_SIZE;
+    p[3]                   = static_cast<uint8_t>(payload);
+    p[4]                   = static_cast<uint8_t>(payload >> 8);
+    crc16_append(p, _len + 2);
+
+    // The buffer is reused for the next frame, so wait until it is sent
+    const uart_tx_seg_t seg = {p, static_cast<uint16_t>(_len + 2)};
+    if (PYRO_OK ==
+        _uart->write_frame(
+            &seg, 1,
+            uart_drv_t::tx_done_func::bind<mem_report_t,
+                                           &mem_report_t::on_tx_done>(this)))
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+void mem_report_t::on_tx_done(BaseType_t &woken)
+{
+    vTaskNotifyGiveFromISR(_task, &woken);
+}
+
+// ----------------------------------------------------------------
+// report sections
+// ----------------------------------------------------------------
+
+void mem_report_t::report_heaps()
+{
+    static constexpr uint32_t region_size[PYRO_MEM_REGION_NUM] = {
+        PYRO_MEM_DTCM_HEAP_SIZE, PYRO_MEM_AXI_HEAP_SIZE,
+        PYRO_MEM_D2_HEAP_SIZE, PYRO_MEM_D3_HEAP_SIZE};
+    HeapStats_t stats;
+
+    vPortGetHeapStats(&stats);
+    begin_frame(FRAME_HEAP);
+    put_heap(PYRO_MEM_REGION_NONE, configTOTAL_HEAP_SIZE, stats);
+    send_frame();
+
+    for (uint8_t i = 0; i < PYRO_MEM_REGION_NUM; ++i)
+    {
+        if (0 == region_size[i])
+        {
+            continue;
+        }
+        vPortGetRegionHeapStats(static_cast<pyro_mem_region_t>(i), &stats);
+        begin_frame(FRAME_HEAP);
+        put_heap(i, region_size[i], stats);
+        send_frame();
+    }
+}
+
+void mem_report_t::report_tasks()
+{
+#if configUSE_TRACE_FACILITY == 1
+    UBaseType_t num;
+
+    vTaskSuspendAll();
+    num = uxTaskGetSystemState(_tasks, MAX_TASK_NUM, nullptr);
+    for (UBaseType_t i = 0; i < num; ++i)
+    {
+        strncpy(_names[i], _tasks[i].pcTaskName, TASK_NAME_LEN);
+    }
+    xTaskResumeAll();
+
+    for (UBaseType_t i = 0; i < num; ++i)
+    {
+        const TaskStatus_t &task = _tasks[i];
+        begin_frame(FRAME_TASK);
+        put_u32(reinterpret_cast<uintptr_t>(task.xHandle));
+        put_u32(reinterpret_cast<uintptr_t>(task.pxStackBase));
+        put_u32(task.usStackHighWaterMark * sizeof(StackType_t));
+        put_u8(static_cast<uint8_t>(task.uxCurrentPriority));
+        put_u8(static_cast<uint8_t>(task.eCurrentState));
+        put_u16(0);
+        for (uint8_t j = 0; j < TASK_NAME_LEN; ++j)
+        {
+            put_u8(static_cast<uint8_t>(_names[i][j]));
+        }
+        send_frame();
+    }
+#endif
+}
+
+void mem_report_t::report_events()
+{
+#if PYRO_MEM_TRACE_EN
+    while (true)
+    {
+        pyro_mem_trace_stats_t trace;
+        pyro_mem_trace_event_t ev;
+
+        vTaskSuspendAll();
+        vPortMemTraceGetStats(&trace);
+        // Events overwritten since the last report leave a gap in the
+        // sequence numbers, which the decoder reports
+        if (trace.ulEvents - _event_seq > PYRO_MEM_TRACE_DEPTH)
+        {
+            _event_seq = trace.ulEvents - PYRO_MEM_TRACE_DEPTH;
+        }
+        begin_frame(FRAME_EVENT);
+        put_u32(_event_seq);
+        for (uint8_t i = 0; i < BATCH_NUM &&
+                            xPortMemTraceGetEvent(_event_seq, &ev) == pdTRUE;
+             ++i)
+        {
+            put_event(ev);
+            _event_seq++;
+        }
+        xTaskResumeAll();
+
+        if (_len == FRAME_HEADER_SIZE + 4)
+        {
+            break;
+        }
+        send_frame();
+    }
+#endif
+}
+
+void mem_report_t::report_live()
+{
+#if PYRO_MEM_TRACE_EN
+    size_t cursor  = 0;
+    uint32_t index = 0;
+    while (cursor < PYRO_MEM_TRACE_LIVE_NUM)
+    {
+        pyro_mem_trace_event_t blocks[BATCH_NUM];
+
+        vTaskSuspendAll();
+        const size_t num = xPortMemTraceCopyLive(&cursor, blocks, BATCH_NUM);
+        xTaskResumeAll();
+
+        if (0 == num)
+        {
+            break;
+        }
+        begin_frame(FRAME_LIVE);
+        put_u32(index);
+        for (size_t i = 0; i < num; ++i)
+        {
+            put_event(blocks[i]);
+        }
+        index += num;
+        send_frame();
+    }
+#endif
+}
+
+void mem_report_t::report()
+{
+    begin_frame(FRAME_BEGIN);
+    put_u32(xTaskGetTickCount() * portTICK_PERIOD_MS);
+#if PYRO_MEM_TRACE_EN
+    put_u16(PYRO_MEM_TRACE_DEPTH);
+    put_u16(PYRO_MEM_TRACE_LIVE_NUM);
+#else
+    put_u16(0);
+    put_u16(0);
+#endif
+    send_frame();
+
+    report_heaps();
+    report_tasks();
+    report_events();
+    report_live();
+
+    pyro_mem_trace_stats_t trace = {};
+#if PYRO_MEM_TRACE_EN
+    vTaskSuspendAll();
+    vPortMemTraceGetStats(&trace);
+    xTaskResumeAll();
+#endif
+    begin_frame(FRAME_END);
+    put_u32(trace.ulEvents);
+    put_u32(trace.ulLive);
+    put_u32(trace.ulLiveOverflow);
+    put_u32(trace.ulFailures);
+    send_frame();
+}
+
+void mem_report_t::thread()
+{
+    _task                = xTaskGetCurrentTaskHandle();
+    TickType_t last_tick = xTaskGetTickCount();
+    while (true)
+    {
+        if (_buf)
+        {
+            report();
+        }
+        vTaskDelayUntil(&last_tick, pdMS_TO_TICKS(MEM_REPORT_PERIOD_MS));
+    }
+}
+
+} // namespace pyro
+
+extern "C" void pyro_mem_report_task(void *arg)
+{
+    pyro::mem_report_t &report = pyro::mem_report_t::get_instance();
+    report.thread();
+}
@@ -0,0 +1,81 @@
+#ifndef __PYRO_MEM_REPORT_H__
+#define __PYRO_MEM_REPORT_H__
+
+#include "pyro_dma_buffer.h"
+#include "pyro_mem_trace.h"
+#include "pyro_uart_drv.h"
+#include "task.h"
+
+#include <cstdint>
+
+namespace pyro
+{
+/**
+ * @brief Periodic memory report over the debug UART.
+ *
+ * Every period the task sends one report as a burst of frames:
+ *   0xA5 | type | seq | len (u16 LE) | payload | CRC16 (LE, header + payload)
+ * BEGIN, one HEAP per heap, one TASK per task, EVENT batches with the
+ * allocation events since the previous report, LIVE batches with the blocks
+ * still allocated, then END. All fields are little-endian; the layout is
+ * mirrored by mem_report.py.
+ */
+class mem_report_t
+{
+  public:
+    enum frame_type_t : uint8_t
+    {
+        FRAME_BEGIN = 0x01,
+        FRAME_HEAP  = 0x02,
+        FRAME_TASK  = 0x03,
+        FRAME_EVENT = 0x04,
+        FRAME_LIVE  = 0x05,
+        FRAME_END   = 0x06,
+    };
+
+    static constexpr uint8_t FRAME_SOF          = 0xA5;
+    static constexpr uint16_t FRAME_HEADER_SIZE = 5;
+    static constexpr uint8_t BATCH_NUM          = 8; // events / blocks per frame
+    static constexpr uint16_t FRAME_MAX_PAYLOAD =
+        4 + BATCH_NUM * sizeof(pyro_mem_trace_event_t);
+    static constexpr uint16_t FRAME_MAX_SIZE =
+        FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + 2;
+    // uxTaskGetSystemState() reports nothing if there are more tasks
+    static constexpr uint8_t MAX_TASK_NUM  = 24;
+    static constexpr uint8_t TASK_NAME_LEN = 16;
+
+    static mem_report_t &get_instance();
+    void thread();
+
+  private:
+    explicit mem_report_t(uart_drv_t *uart);
+
+    void report();
+    void report_heaps();
+    void report_tasks();
+    void report_events();
+    void report_live();
+
+    void begin_frame(frame_type_t type);
+    void put_u8(uint8_t v);
+    void put_u16(uint16_t v);
+    void put_u32(uint32_t v);
+    void put_heap(uint8_t id, uint32_t total, const HeapStats_t &stats);
+    void put_event(const pyro_mem_trace_event_t &ev);
+    void send_frame();
+    void on_tx_done(BaseType_t &woken);
+
+    uart_drv_t *_uart;
+    dma_buffer_t _buf;
+    uint16_t _len;
+    uint8_t _seq;
+    uint32_t _event_seq; // first trace event not yet sent
+    TaskHandle_t _task;
+#if configUSE_TRACE_FACILITY == 1
+    TaskStatus_t _tasks[MAX_TASK_NUM];
+    char _names[MAX_TASK_NUM][TASK_NAME_LEN]; // copied while tasks can't die
+#endif
+};
+} // namespace pyro
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "cstdint"
 #include "pyro_uart_drv.h"
+#include "atomic"
 #include "vector"
 
 namespace pyro
@@ -12,7 +13,9 @@ class vofa_drv_t
   public:
     explicit vofa_drv_t(uint8_t max_length, uart_drv_t *uart);
     ~vofa_drv_t();
-    static vofa_drv_t &get_instance(uint8_t max_length);
+    static constexpr uint8_t DEFAULT_LENGTH = 15;
+
+    static vofa_drv_t &get_instance(uint8_t max_length = DEFAULT_LENGTH);
     void thread();
 
   private:
@@ -22,6 +25,7 @@ class vofa_drv_t
     void remove_data(const float *data);
     void update_data();
     void send();
+    void on_tx_done(BaseType_t &woken);
 
     typedef struct
     {
@@ -33,6 +37,7 @@ class vofa_drv_t
     float *_data_pack;
     uint8_t _length;
     uart_drv_t *_vofa_uart;
+    std::atomic<bool> _busy;
 };
 
 
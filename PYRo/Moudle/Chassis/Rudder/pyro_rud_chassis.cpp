@@ -41,6 +41,12 @@ void rud_chassis_t::init()
     _rudder_motor[3] = new dji_gm_6020_motor_drv_t(dji_motor_tx_frame_t::id_4,
                                                    can_hub_t::can2);
 
+    for (int i = 0; i < 4; ++i)
+    {
+        _wheel_motor[i]->join_rx_group(_feedback_group);
+        _rudder_motor[i]->join_rx_group(_feedback_group);
+    }
+
     _wheel_speed_pid[0]  = new pid_t(18.0f, 0.0f, 0.0f, 1.0f, 20.0f); // FL
     _wheel_speed_pid[1]  = new pid_t(18.0f, 0.0f, 0.0f, 1.0f, 20.0f); // FR
     _wheel_speed_pid[2]  = new pid_t(18.0f, 0.0f, 0.0f, 1.0f, 20.0f); // BL
@@ -1,5 +1,7 @@
 #include "pyro_chassis_base.h"
 
+#include "pyro_core_config.h"
+
 extern "C" void chassis_task(void *argument);
 extern "C" void chassis_init(void *argument);
 
@@ -9,11 +11,28 @@ namespace pyro
 chassis_base_t::chassis_base_t() : chassis_base_t(type_t::UNKNOWN)
 {
 }
+/**
+ * @brief init() is virtual, so it runs later from the chassis_init task. With
+ *        PYRO_STATIC_ALLOC_EN the heap is locked when pyro_init_thread ends,
+ *        so the owner calls start() from there instead.
+ */
 chassis_base_t::chassis_base_t(const type_t type)
 {
     _type = type;
-    xTaskCreate(chassis_init, "chassis_init", 512, this, tskIDLE_PRIORITY + 1,
-                &_chassis_init_handle);
+#if !PYRO_STATIC_ALLOC_EN
+    _chassis_init_storage.create(chassis_init, "chassis_init", this,
+                                 tskIDLE_PRIORITY + 1, &_chassis_init_handle);
+#endif
+}
+
+/**
+ * @brief Runs init() and creates the control task.
+ */
+void chassis_base_t::start()
+{
+    init();
+    _chassis_task_storage.create(chassis_task, "chassis_thread", this,
+                                 tskIDLE_PRIORITY + 2, &_chassis_task_handle);
 }
 
 void chassis_base_t::thread()
@@ -26,6 +45,21 @@ void chassis_base_t::thread()
     send_motor_command();
 }
 
+/**
+ * @brief Blocks until the next control cycle: until all motors of
+ *        _feedback_group have reported, or one tick if the group is empty.
+ *        Waiting is bounded so the loop keeps running if a motor drops out.
+ */
+void chassis_base_t::wait_cycle()
+{
+    if (0 == _feedback_group.size())
+    {
+        vTaskDelay(1);
+        return;
+    }
+    _feedback_group.wait(FEEDBACK_TIMEOUT_TICKS);
+}
+
 } // namespace pyro
 
 extern "C" void chassis_init(void *argument)
@@ -33,9 +67,7 @@ extern "C" void chassis_init(void *argument)
     auto *chassis = static_cast<pyro::chassis_base_t *>(argument);
     if (chassis)
     {
-        chassis->init();
-        xTaskCreate(chassis_task, "chassis_thread", 256, chassis,
-                    tskIDLE_PRIORITY + 2, &chassis->_chassis_task_handle);
+        chassis->start();
         vTaskDelete(nullptr);
     }
     while (true)
@@ -51,7 +83,7 @@ extern "C" void chassis_task(void *argument)
         while (true)
         {
             chassis->thread();
-            vTaskDelay(1);
+            chassis->wait_cycle();
         }
     }
     vTaskDelete(nullptr);
@@ -2,7 +2,9 @@
 #define __PYRO_CHASSIS_BASE_H__
 
 #include "FreeRTOS.h"
+#include "pyro_can_rx_group.h"
 #include "pyro_mutex.h"
+#include "pyro_static_alloc.h"
 #include "task.h"
 
 
@@ -53,7 +55,9 @@ class chassis_base_t
     };
     virtual void init()                             = 0;
     virtual void set_command(const cmd_base_t &cmd) = 0;
+    void start();
     void thread();
+    void wait_cycle();
     virtual ~chassis_base_t() = default;
     /**
      * @brief Get the chassis type
@@ -69,6 +73,7 @@ class chassis_base_t
         return _mutex;
     }
 
+    task_storage_t<256> _chassis_task_storage;
     TaskHandle_t _chassis_task_handle{};
 
   protected:
@@ -77,8 +82,15 @@ class chassis_base_t
     virtual void chassis_control()                  = 0;
     virtual void power_control()                    = 0;
     virtual void send_motor_command()               = 0;
+    static constexpr TickType_t FEEDBACK_TIMEOUT_TICKS = 2;
+
     mutex_t _mutex;
+    // Motors joined here pace the control loop; left empty, it runs per tick
+    can_rx_group_t _feedback_group;
+#if !PYRO_STATIC_ALLOC_EN
+    task_storage_t<512> _chassis_init_storage;
     TaskHandle_t _chassis_init_handle{};
+#endif
     chassis_base_t();
     explicit chassis_base_t(type_t type);
 
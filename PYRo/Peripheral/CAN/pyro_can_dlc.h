@@ -0,0 +1,63 @@
+#ifndef __PYRO_CAN_DLC_H__
+#define __PYRO_CAN_DLC_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+static constexpr size_t CAN_CLASSIC_MAX_LEN = 8;
+static constexpr size_t CAN_FD_MAX_LEN      = 64;
+static constexpr uint8_t CAN_MAX_DLC        = 15;
+
+/**
+ * @brief Payload length in bytes of a 4-bit CAN/CAN FD DLC code.
+ *
+ * Codes above 15 are clamped to 15 (64 bytes).
+ */
+constexpr size_t can_dlc_to_len(const uint8_t dlc)
+{
+    return dlc <= 8    ? dlc
+           : dlc == 9  ? 12
+           : dlc == 10 ? 16
+           : dlc == 11 ? 20
+           : dlc == 12 ? 24
+           : dlc == 13 ? 32
+           : dlc == 14 ? 48
+                       : 64;
+}
+
+/**
+ * @brief Smallest DLC code whose payload holds `len` bytes.
+ *
+ * Lengths above 64 are clamped to DLC 15.
+ */
+constexpr uint8_t can_len_to_dlc(const size_t len)
+{
+    return len <= 8    ? static_cast<uint8_t>(len)
+           : len <= 12 ? 9
+           : len <= 16 ? 10
+           : len <= 20 ? 11
+           : len <= 24 ? 12
+           : len <= 32 ? 13
+           : len <= 48 ? 14
+                       : 15;
+}
+
+/**
+ * @brief Length actually put on the bus for a payload of `len` bytes,
+ *        i.e. `len` rounded up to the next valid CAN FD size.
+ */
+constexpr size_t can_len_round_up(const size_t len)
+{
+    return can_dlc_to_len(can_len_to_dlc(len));
+}
+
+static_assert(can_dlc_to_len(can_len_to_dlc(CAN_FD_MAX_LEN)) ==
+                  CAN_FD_MAX_LEN,
+              "DLC codec mismatch");
+static_assert(can_len_round_up(13) == 16 && can_len_round_up(8) == 8,
+              "DLC codec mismatch");
+}; // namespace pyro
+
+#endif
@@ -1,68 +1,134 @@
 #include "pyro_can_drv.h"
 #include "main.h"
+#include "pyro_dwt_drv.h"
 
+#include <algorithm>
 #include <cstring>
 
 
 
 namespace pyro
 {
-can_msg_buffer_t::can_msg_buffer_t(uint32_t id)
-    : _id(id), _is_fresh(false), _last_update_time(0)
+static_assert(sizeof(can_msg_buffer_t) <= CAN_MSG_POOL_SLOT_SIZE,
+              "can_msg_buffer_t must fit a pool slot");
+#if CAN_FD_EN
+static_assert(sizeof(canfd_msg_buffer_t) <= CAN_MSG_POOL_SLOT_SIZE,
+              "canfd_msg_buffer_t must fit a pool slot");
+#endif
+
+can_msg_buffer_base_t::can_msg_buffer_base_t(uint32_t id)
+    : _id(id), _is_fresh(false), _last_update_time(0), _online(false),
+      _nominal_period(0), _last_stamp(0),
+      _timing(), _group(nullptr), _group_index(0)
 {
-    _buffer.fill(0);
-    //_mtx = xSemaphoreCreateMutex();
 }
 
-can_msg_buffer_t::~can_msg_buffer_t(void)
+can_msg_buffer_base_t::~can_msg_buffer_base_t(void)
 {
-    // vSemaphoreDelete(_mtx);
 }
 
-uint32_t can_msg_buffer_t::get_id(void)
+uint32_t can_msg_buffer_base_t::get_id(void)
 {
     return _id;
 }
 
-bool can_msg_buffer_t::is_fresh(void)
+bool can_msg_buffer_base_t::is_fresh(void)
 {
     return _is_fresh;
 }
 
-void can_msg_buffer_t::mark_read(void)
+void can_msg_buffer_base_t::mark_read(void)
 {
-    // if(xSemaphoreTake(_mtx,portMAX_DELAY)==pdTRUE){
     _is_fresh = false;
-    // xSemaphoreGive(_mtx);
-    //}
 }
 
-void can_msg_buffer_t::update_data(const uint8_t *data) // Mutex or not
+TickType_t can_msg_buffer_base_t::get_last_update_time(void)
 {
-    // if(xSemaphoreTake(_mtx,portMAX_DELAY)==pdTRUE){
-    memcpy(_buffer.data(), data, 8);
-    _last_update_time = xTaskGetTickCount();
-    _is_fresh         = true;
-    // xSemaphoreGive(_mtx);
-    // }
+    return _last_update_time;
 }
 
-bool can_msg_buffer_t::get_data(std::array<uint8_t, 8> &data)
+/**
+ * @brief Inter-arrival statistics of this ID, in DWT ticks.
+ */
+can_rx_timing_t can_msg_buffer_base_t::get_rx_timing(void)
 {
-    // if(xSemaphoreTake(_mtx,portMAX_DELAY)==pdTRUE){
-    memcpy(data.data(), _buffer.data(), 8);
-    // xSemaphoreGive(_mtx);
-    return true;
-    // }
-    // return false;
+    taskENTER_CRITICAL();
+    const can_rx_timing_t timing = _timing;
+    taskEXIT_CRITICAL();
+    return timing;
+}
+
+/**
+ * @brief Sets the expected update period used by the online monitor.
+ *        A period of 0 leaves the buffer unmonitored.
+ */
+void can_msg_buffer_base_t::set_nominal_period(TickType_t period_ticks)
+{
+    _nominal_period = period_ticks;
 }
 
+bool can_msg_buffer_base_t::is_online(void)
+{
+    return _online;
+}
 
+/**
+ * @brief Flags the buffer offline if it missed `timeout_factor` nominal
+ *        periods. Unmonitored buffers always count as online.
+ * @return the online state after the check.
+ */
+bool can_msg_buffer_base_t::check_online(TickType_t now,
+                                         uint32_t timeout_factor)
+{
+    if (0 == _nominal_period)
+        return true;
+    if (now - _last_update_time > _nominal_period * timeout_factor)
+        _online = false;
+    return _online;
+}
+
+/**
+ * @brief Makes this buffer member `index` of an RX notification group.
+ *        A buffer belongs to at most one group.
+ */
+status_t can_msg_buffer_base_t::attach_group(can_rx_group_t *group,
+                                             uint8_t index)
+{
+    if (nullptr != _group)
+        return PYRO_ERROR;
+    _group_index = index;
+    _group       = group;
+    return PYRO_OK;
+}
+
+void can_msg_buffer_base_t::notify_group(BaseType_t *woken)
+{
+    if (nullptr != _group)
+        _group->member_updated(_group_index, woken);
+}
+
+/**
+ * @brief Stamps a payload published by the RX ISR.
+ */
+void can_msg_buffer_base_t::mark_updated(void)
+{
+    const uint32_t now = dwt_drv_t::get_current_ticks();
+    if (0 != _last_stamp)
+        can_rx_timing_add(_timing, now - _last_stamp);
+    _last_stamp       = now;
+    _last_update_time = xTaskGetTickCountFromISR();
+    _is_fresh         = true;
+    _online           = true;
+}
 
 can_drv_t::can_drv_t(FDCAN_HandleTypeDef *hfdcan)
+    : _register_count(0), _rx_batch_stats(), _stats(),
+      _nominal_bps(0), _data_bps(0), _offline_mask(0)
 {
     _hfdcan = hfdcan;
-    _registerlist.clear();
+    _registerlist.fill(nullptr);
+    _rx_table.clear();
+    _rx_ext_table.clear();
     //_registermtx = xSemaphoreCreateMutex();
 }
 
@@ -73,15 +139,15 @@ can_drv_t::~can_drv_t(void)
 
 pyro::status_t can_drv_t::init(void)
 {
-    FDCAN_FilterTypeDef fdcan_filter;
-    fdcan_filter.IdType       = FDCAN_STANDARD_ID;
-    fdcan_filter.FilterIndex  = 0;
-    fdcan_filter.FilterType   = FDCAN_FILTER_MASK;
-    fdcan_filter.FilterConfig = FDCAN_FILTER_TO_RXFIFO0;
-    fdcan_filter.FilterID1    = 0x00;
-    fdcan_filter.FilterID2    = 0x00;
-
-    if (HAL_OK != HAL_FDCAN_ConfigFilter(_hfdcan, &fdcan_filter))
+    const uint32_t kernel_hz = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_FDCAN);
+    _nominal_bps = kernel_hz / (_hfdcan->Init.NominalPrescaler *
+                                (1 + _hfdcan->Init.NominalTimeSeg1 +
+                                 _hfdcan->Init.NominalTimeSeg2));
+    _data_bps    = kernel_hz / (_hfdcan->Init.DataPrescaler *
+                             (1 + _hfdcan->Init.DataTimeSeg1 +
+                              _hfdcan->Init.DataTimeSeg2));
+
+    if (pyro::PYRO_OK != program_filters())
         return pyro::PYRO_ERROR;
     if (HAL_OK !=
         HAL_FDCAN_ConfigGlobalFilter(_hfdcan, FDCAN_REJECT, FDCAN_REJECT,
@@ -100,136 +166,477 @@ pyro::status_t can_drv_t::start(void)
 {
     if (HAL_OK != HAL_FDCAN_Start(_hfdcan))
         return pyro::PYRO_ERROR;
+    const uint32_t tx_elements =
+        _hfdcan->Init.TxBuffersNbr + _hfdcan->Init.TxFifoQueueElmtsNbr;
+    const uint32_t tx_buffers =
+        tx_elements >= 32 ? 0xFFFFFFFFU : (1U << tx_elements) - 1U;
+
+    if (HAL_OK != HAL_FDCAN_ActivateNotification(
+                      _hfdcan,
+                      FDCAN_IT_RX_FIFO0_NEW_MESSAGE |
+                          FDCAN_IT_RX_FIFO0_MESSAGE_LOST | FDCAN_IT_BUS_OFF |
+                          FDCAN_IT_ERROR_PASSIVE,
+                      0))
+        return pyro::PYRO_ERROR;
     if (HAL_OK != HAL_FDCAN_ActivateNotification(
-                      _hfdcan, FDCAN_IT_RX_FIFO0_NEW_MESSAGE, 0))
+                      _hfdcan, FDCAN_IT_TX_COMPLETE, tx_buffers))
         return pyro::PYRO_ERROR;
     return pyro::PYRO_OK;
 }
 
-pyro::status_t can_drv_t::send_msg(uint32_t id, uint8_t *data)
+/**
+ * @brief Sends a classic 8-byte frame, or queues it by priority when the
+ *        hardware FIFO is busy. Queued frames are moved to the hardware from
+ *        the TX-complete interrupt.
+ * @return PYRO_OK if sent or queued, PYRO_BUSY if the queue level is full.
+ */
+pyro::status_t can_drv_t::send_msg(uint32_t id, uint8_t *data,
+                                   tx_priority_t prio)
+{
+    tx_frame_t frame;
+    frame.id  = id;
+    frame.len = CAN_CLASSIC_MAX_LEN;
+    frame.fd  = false;
+    memcpy(frame.data.data(), data, CAN_CLASSIC_MAX_LEN);
+    return transmit(frame, prio);
+}
+
+/**
+ * @brief Sends a CAN FD frame of up to 64 bytes, with bit-rate switching if
+ *        the bus is configured for it. The payload is zero-padded to the
+ *        next valid FD length.
+ * @return PYRO_PARAM_ERROR if the bus or the build is not FD-capable.
+ */
+pyro::status_t can_drv_t::send_fd_msg(uint32_t id, const uint8_t *data,
+                                      size_t len, tx_priority_t prio)
+{
+    tx_frame_t frame;
+    if (FDCAN_FRAME_CLASSIC == _hfdcan->Init.FrameFormat || len > TX_MAX_LEN)
+        return pyro::PYRO_PARAM_ERROR;
+
+    frame.id  = id;
+    frame.len = static_cast<uint8_t>(can_len_round_up(len));
+    frame.fd  = true;
+    memcpy(frame.data.data(), data, len);
+    memset(frame.data.data() + len, 0, frame.len - len);
+    return transmit(frame, prio);
+}
+
+pyro::status_t can_drv_t::transmit(tx_frame_t &frame, tx_priority_t prio)
+{
+    tx_port_t port{*this};
+
+    taskENTER_CRITICAL();
+    const pyro::status_t status = _tx_queue.send(port, prio, frame);
+    taskEXIT_CRITICAL();
+    return status;
+}
+
+bool can_drv_t::tx_port_t::has_room() const
+{
+    return HAL_FDCAN_GetTxFifoFreeLevel(drv._hfdcan) > 0;
+}
+
+bool can_drv_t::tx_port_t::write(const tx_frame_t &frame)
+{
+    return pyro::PYRO_OK == drv.write_tx_fifo(frame);
+}
+
+uint32_t can_drv_t::tx_port_t::now() const
+{
+    return dwt_drv_t::get_current_ticks();
+}
+
+pyro::status_t can_drv_t::write_tx_fifo(const tx_frame_t &frame)
 {
     FDCAN_TxHeaderTypeDef tx_header;
-    // if(xSemaphoreTake(_registermtx,portMAX_DELAY)==pdTRUE){
-    tx_header.IdType              = FDCAN_STANDARD_ID;
-    tx_header.Identifier          = id;
+    const bool brs =
+        frame.fd && FDCAN_FRAME_FD_BRS == _hfdcan->Init.FrameFormat;
+
+    tx_header.IdType              = can_is_ext_id(frame.id) ? FDCAN_EXTENDED_ID
+                                                            : FDCAN_STANDARD_ID;
+    tx_header.Identifier          = frame.id & CAN_EXT_ID_MASK;
     tx_header.TxFrameType         = FDCAN_DATA_FRAME;
-    tx_header.DataLength          = 8;
+    tx_header.DataLength          = can_len_to_dlc(frame.len);
     tx_header.ErrorStateIndicator = FDCAN_ESI_ACTIVE;
-    tx_header.BitRateSwitch       = FDCAN_BRS_OFF;
-    tx_header.FDFormat            = FDCAN_CLASSIC_CAN;
+    tx_header.BitRateSwitch       = brs ? FDCAN_BRS_ON : FDCAN_BRS_OFF;
+    tx_header.FDFormat            = frame.fd ? FDCAN_FD_CAN : FDCAN_CLASSIC_CAN;
     tx_header.TxEventFifoControl  = FDCAN_NO_TX_EVENTS;
     tx_header.MessageMarker       = 0;
 
-    if (HAL_OK != HAL_FDCAN_AddMessageToTxFifoQ(_hfdcan, &tx_header, data))
-    {
-        // xSemaphoreGive(_registermtx);
+    if (HAL_OK != HAL_FDCAN_AddMessageToTxFifoQ(
+                      _hfdcan, &tx_header,
+                      const_cast<uint8_t *>(frame.data.data())))
         return pyro::PYRO_ERROR;
-    }
-
-    // xSemaphoreGive(_registermtx);
+    _stats.tx_frames++;
+    account_frame(frame.len, can_is_ext_id(frame.id), frame.fd, brs);
     return pyro::PYRO_OK;
-    // }
-    // return pyro::PYRO_ERROR;
 }
 
-pyro::status_t can_drv_t::register_rx_msg(can_msg_buffer_t *msg_buffer)
+/**
+ * @brief Adds the bus time of one frame to the load estimate.
+ *        Called from the RX ISR or with the TX queue held.
+ */
+void can_drv_t::account_frame(size_t len, bool extended, bool fd, bool brs)
+{
+    _load_meter.add(can_frame_bits(len, extended, fd, brs), _nominal_bps,
+                    _data_bps);
+    _load_meter.update(dwt_drv_t::get_current_ticks(),
+                       SystemCoreClock / LOAD_WINDOW_DIV, SystemCoreClock);
+}
+
+/**
+ * @brief Counts error-state transitions. EP and BO flag a change in either
+ *        direction, so the protocol status decides whether the node entered
+ *        the state or left it.
+ */
+void can_drv_t::handle_error_status(uint32_t error_status_its)
+{
+    FDCAN_ProtocolStatusTypeDef protocol_status;
+    if (HAL_OK != HAL_FDCAN_GetProtocolStatus(_hfdcan, &protocol_status))
+        return;
+    if ((error_status_its & FDCAN_IT_ERROR_PASSIVE) &&
+        protocol_status.ErrorPassive)
+        _stats.error_passive++;
+    if ((error_status_its & FDCAN_IT_BUS_OFF) && protocol_status.BusOff)
+        _stats.bus_off++;
+}
+
+/**
+ * @brief Snapshot of the bus counters. Also closes the bus-load window, so
+ *        an idle bus decays towards 0 % while it is being observed.
+ */
+can_drv_t::can_stats_t can_drv_t::get_stats()
+{
+    taskENTER_CRITICAL();
+    _load_meter.update(dwt_drv_t::get_current_ticks(),
+                       SystemCoreClock / LOAD_WINDOW_DIV, SystemCoreClock);
+    _stats.tx_dropped = _tx_queue.stats().dropped_count;
+    _stats.bus_load   = _load_meter.get_load_percent();
+    const can_stats_t stats = _stats;
+    taskEXIT_CRITICAL();
+    return stats;
+}
+
+/**
+ * @brief Moves queued frames into the hardware FIFO while it has room.
+ */
+void can_drv_t::handle_tx_complete()
+{
+    tx_port_t port{*this};
+
+    const UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    _tx_queue.refill(port);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+}
+
+/**
+ * @brief Snapshot of the TX queue counters. The TX ISR updates them and
+ *        total_latency is 64-bit, so copy them in one critical section.
+ */
+can_drv_t::tx_stats_t can_drv_t::get_tx_stats() const
+{
+    taskENTER_CRITICAL();
+    const tx_stats_t stats = _tx_queue.stats();
+    taskEXIT_CRITICAL();
+    return stats;
+}
+
+pyro::status_t can_drv_t::register_rx_msg(can_msg_buffer_base_t *msg_buffer)
 {
     // if(xSemaphoreTake(_registermtx,portMAX_DELAY)==pdTRUE)
     // {
-    uint32_t id = msg_buffer->get_id();
-    if (this->_registerlist.exist(id))
+    const uint32_t id = msg_buffer->get_id();
+    const auto &table = can_is_ext_id(id) ? _rx_ext_table : _rx_table;
+    if (_register_count >= MAX_ID_REGIST_NUM ||
+        table.find(id & CAN_EXT_ID_MASK))
     {
         // xSemaphoreGive(_registermtx);
         return pyro::PYRO_ERROR;
     }
-    this->_registerlist[id] = msg_buffer;
+    _registerlist[_register_count++] = msg_buffer;
+    if (pyro::PYRO_OK != rebuild_rx_table())
+    {
+        _registerlist[--_register_count] = nullptr;
+        // xSemaphoreGive(_registermtx);
+        return pyro::PYRO_ERROR;
+    }
     // xSemaphoreGive(_registermtx);
-    return pyro::PYRO_OK;
+    return program_filters();
     // }
     // return pyro::PYRO_ERROR;
 }
 
-pyro::status_t can_drv_t::handle_rx_msg(uint32_t id,
-                                        uint8_t *data) // mutex or not
+/**
+ * @brief Collects the bare IDs (and buffers) of one identifier type.
+ * @return number of registered buffers of that type.
+ */
+size_t can_drv_t::collect_ids(bool extended, uint32_t *ids,
+                              can_msg_buffer_base_t **buffers)
 {
-    // if(xSemaphoreTake(_registermtx,portMAX_DELAY)==pdTRUE)
-    // {
-    if (!this->_registerlist.exist(id))
+    size_t count = 0;
+    for (uint8_t i = 0; i < _register_count; i++)
+    {
+        const uint32_t id = _registerlist[i]->get_id();
+        if (can_is_ext_id(id) != extended)
+            continue;
+        ids[count] = id & CAN_EXT_ID_MASK;
+        if (buffers)
+            buffers[count] = _registerlist[i];
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Regenerates the perfect-hash RX tables from the registered buffers.
+ *
+ * Standard and extended IDs get separate tables. The seed search runs with
+ * interrupts enabled, only the table rewrite is done inside a critical
+ * section so the RX ISR never sees a half-built table.
+ */
+pyro::status_t can_drv_t::rebuild_rx_table()
+{
+    std::array<uint32_t, MAX_ID_REGIST_NUM> std_ids{};
+    std::array<uint32_t, MAX_ID_REGIST_NUM> ext_ids{};
+    std::array<can_msg_buffer_base_t *, MAX_ID_REGIST_NUM> std_buffers{};
+    std::array<can_msg_buffer_base_t *, MAX_ID_REGIST_NUM> ext_buffers{};
+    uint32_t std_seed = 0;
+    uint32_t ext_seed = 0;
+
+    const size_t std_num =
+        collect_ids(false, std_ids.data(), std_buffers.data());
+    const size_t ext_num = collect_ids(true, ext_ids.data(), ext_buffers.data());
+    if (!decltype(_rx_table)::plan(std_ids.data(), std_num, std_seed) ||
+        !decltype(_rx_ext_table)::plan(ext_ids.data(), ext_num, ext_seed))
+    {
+        return pyro::PYRO_ERROR;
+    }
+
+    taskENTER_CRITICAL();
+    _rx_table.commit(std_seed, std_ids.data(), std_buffers.data(), std_num);
+    _rx_ext_table.commit(ext_seed, ext_ids.data(), ext_buffers.data(),
+                         ext_num);
+    taskEXIT_CRITICAL();
+    return pyro::PYRO_OK;
+}
+
+/**
+ * @brief Reprograms the acceptance filters from the registered IDs, so
+ *        unregistered traffic is dropped by the FDCAN before it can raise an
+ *        interrupt. Unused filter elements are disabled.
+ */
+pyro::status_t can_drv_t::program_filters()
+{
+    if (pyro::PYRO_OK != program_filters(false))
+        return pyro::PYRO_ERROR;
+    return program_filters(true);
+}
+
+pyro::status_t can_drv_t::program_filters(bool extended)
+{
+    std::array<uint32_t, MAX_ID_REGIST_NUM> ids{};
+    std::array<can_filter_elem_t, MAX_STD_FILTER_NUM> plan{};
+    FDCAN_FilterTypeDef fdcan_filter;
+    const uint32_t filter_num =
+        extended ? std::min<uint32_t>(_hfdcan->Init.ExtFiltersNbr,
+                                      MAX_EXT_FILTER_NUM)
+                 : std::min<uint32_t>(_hfdcan->Init.StdFiltersNbr,
+                                      MAX_STD_FILTER_NUM);
+
+    const size_t id_num = collect_ids(extended, ids.data(), nullptr);
+    const size_t plan_num =
+        can_filter_plan(ids.data(), id_num, plan.data(), filter_num);
+    if (id_num > 0 && 0 == plan_num)
+        return pyro::PYRO_ERROR;
+
+    fdcan_filter.IdType = extended ? FDCAN_EXTENDED_ID : FDCAN_STANDARD_ID;
+    for (uint32_t i = 0; i < filter_num; i++)
+    {
+        fdcan_filter.FilterIndex = i;
+        if (i < plan_num)
+        {
+            fdcan_filter.FilterType   = can_filter_elem_t::range == plan[i].type
+                                            ? FDCAN_FILTER_RANGE
+                                            : FDCAN_FILTER_DUAL;
+            fdcan_filter.FilterConfig = FDCAN_FILTER_TO_RXFIFO0;
+            fdcan_filter.FilterID1    = plan[i].id1;
+            fdcan_filter.FilterID2    = plan[i].id2;
+        }
+        else
+        {
+            fdcan_filter.FilterType   = FDCAN_FILTER_DUAL;
+            fdcan_filter.FilterConfig = FDCAN_FILTER_DISABLE;
+            fdcan_filter.FilterID1    = 0x00;
+            fdcan_filter.FilterID2    = 0x00;
+        }
+        if (HAL_OK != HAL_FDCAN_ConfigFilter(_hfdcan, &fdcan_filter))
+            return pyro::PYRO_ERROR;
+    }
+    return pyro::PYRO_OK;
+}
+
+pyro::status_t can_drv_t::handle_rx_msg(uint32_t id, uint8_t *data,
+                                        size_t len, BaseType_t *woken)
+{
+    can_msg_buffer_base_t *msg = can_is_ext_id(id)
+                                     ? _rx_ext_table.find(id & CAN_EXT_ID_MASK)
+                                     : _rx_table.find(id);
+    if (nullptr == msg)
     {
-        // xSemaphoreGive(_registermtx);
         return pyro::PYRO_NOT_FOUND;
     }
-    can_msg_buffer_t *msg = this->_registerlist[id];
-    msg->update_data(data);
-    // xSemaphoreGive(_registermtx);
+    msg->update_data(data, len);
+    msg->notify_group(woken);
     return pyro::PYRO_OK;
-    // }
-    // return pyro::PYRO_ERROR;
+}
+
+/**
+ * @brief Drains RX FIFO0 completely and dispatches every frame in one pass.
+ *
+ * Called from the FIFO0 new-message interrupt. Frames that arrive while the
+ * FIFO is being drained are picked up by the same call, so a burst of motor
+ * feedback costs one interrupt entry instead of one per frame.
+ */
+void can_drv_t::handle_rx_fifo0(uint32_t rx_fifo0_its)
+{
+    FDCAN_RxHeaderTypeDef rx_header;
+    uint8_t data[CAN_FD_MAX_LEN];
+    BaseType_t woken = pdFALSE;
+    uint32_t frames  = 0;
+    uint32_t level  = HAL_FDCAN_GetRxFifoFillLevel(_hfdcan, FDCAN_RX_FIFO0);
+
+    if (rx_fifo0_its & FDCAN_IT_RX_FIFO0_MESSAGE_LOST)
+        _stats.fifo_overruns++;
+    if (level > _rx_batch_stats.fifo_high_water)
+        _rx_batch_stats.fifo_high_water = level;
+
+    while (level > 0)
+    {
+        if (HAL_OK !=
+            HAL_FDCAN_GetRxMessage(_hfdcan, FDCAN_RX_FIFO0, &rx_header, data))
+            break;
+        frames++;
+        if (FDCAN_DATA_FRAME == rx_header.RxFrameType)
+        {
+            const uint32_t id = FDCAN_EXTENDED_ID == rx_header.IdType
+                                    ? can_ext_id(rx_header.Identifier)
+                                    : rx_header.Identifier;
+            const size_t len = can_dlc_to_len(rx_header.DataLength);
+            _stats.rx_frames++;
+            account_frame(len, can_is_ext_id(id),
+                          FDCAN_FD_CAN == rx_header.FDFormat,
+                          FDCAN_BRS_ON == rx_header.BitRateSwitch);
+            if (pyro::PYRO_NOT_FOUND == handle_rx_msg(id, data, len, &woken))
+                _stats.rx_unmatched++;
+        }
+        level = HAL_FDCAN_GetRxFifoFillLevel(_hfdcan, FDCAN_RX_FIFO0);
+    }
+
+    _rx_batch_stats.irq_count++;
+    _rx_batch_stats.frame_count += frames;
+    if (frames > _rx_batch_stats.max_frames_per_irq)
+        _rx_batch_stats.max_frames_per_irq = frames;
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief Runs the online check of every registered buffer.
+ * @return bitmask of offline buffers, bit i being registration slot i.
+ */
+uint32_t can_drv_t::scan_online(TickType_t now, uint32_t timeout_factor)
+{
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < _register_count; i++)
+    {
+        if (!_registerlist[i]->check_online(now, timeout_factor))
+            mask |= 1U << i;
+    }
+    _offline_mask = mask;
+    return mask;
+}
+
+uint32_t can_drv_t::get_offline_mask() const
+{
+    return _offline_mask;
+}
+
+/**
+ * @brief Snapshot of the RX drain counters, consistent with each other.
+ */
+can_drv_t::rx_batch_stats_t can_drv_t::get_rx_batch_stats() const
+{
+    taskENTER_CRITICAL();
+    const rx_batch_stats_t stats = _rx_batch_stats;
+    taskEXIT_CRITICAL();
+    return stats;
 }
 
 can_hub_t::can_hub_t() : _can_drv_map()
 { // Log
-    this->_can_drv_map.clear();
+    this->_can_drv_map.fill(nullptr);
 }
 
-can_hub_t *can_hub_t::_instancePtr = nullptr;
-can_hub_t *_instancePtr_copy       = nullptr;
 can_hub_t *can_hub_t::get_instance(void)
 {
-    if (_instancePtr == nullptr) // Mutex
-    {
-        _instancePtr      = new can_hub_t();
-        _instancePtr_copy = _instancePtr;
-    }
-    return _instancePtr;
+    static can_hub_t instance;
+    return &instance;
+}
+
+int8_t can_hub_t::which_of(const FDCAN_HandleTypeDef *hfdcan)
+{
+    if (hfdcan == &hfdcan1)
+        return can1;
+    if (hfdcan == &hfdcan2)
+        return can2;
+    if (hfdcan == &hfdcan3)
+        return can3;
+    return -1;
 }
+
 pyro::status_t can_hub_t::hub_register_can_obj(FDCAN_HandleTypeDef *hfdcan,
                                                can_drv_t *can_drv)
 {
-    if (this->_can_drv_map.exist(hfdcan))
+    const int8_t which = which_of(hfdcan);
+    if (which < 0 || this->_can_drv_map[which] != nullptr)
         return PYRO_ERROR;
-    this->_can_drv_map[hfdcan] = can_drv;
+    this->_can_drv_map[which] = can_drv;
     return pyro::PYRO_OK;
 }
 
 status_t can_hub_t::hub_unregister_can_obj(FDCAN_HandleTypeDef *hfdcan)
 {
-    if (!this->_can_drv_map.exist(hfdcan))
+    const int8_t which = which_of(hfdcan);
+    if (which < 0 || this->_can_drv_map[which] == nullptr)
         return pyro::PYRO_ERROR;
-    this->_can_drv_map.erase(hfdcan);
+    this->_can_drv_map[which] = nullptr;
     return pyro::PYRO_OK;
 }
 
 can_drv_t *can_hub_t::hub_get_can_obj(which_can which_can)
 {
-    FDCAN_HandleTypeDef *hfdcan = nullptr;
-    switch (which_can)
-    {
-        case can1:
-            hfdcan = &hfdcan1;
-            break;
-        case can2:
-            hfdcan = &hfdcan2;
-            break;
-        case can3:
-            hfdcan = &hfdcan3;
-            break;
-        default:
-            return nullptr;
-    }
-    can_drv_t *can_drv = this->_can_drv_map[hfdcan];
-    return can_drv;
+    if (which_can < can1 || which_can >= can_num)
+        return nullptr;
+    return this->_can_drv_map[which_can];
+}
+
+can_drv_t *can_hub_t::hub_get_can_obj(const FDCAN_HandleTypeDef *hfdcan)
+{
+    const int8_t which = which_of(hfdcan);
+    if (which < 0)
+        return nullptr;
+    return this->_can_drv_map[which];
 }
 //    pyro::status_t hub_unregister_can_client(which_can which_can,uint32_t id);
 
 pyro::status_t can_hub_t::hub_handle_callback(FDCAN_HandleTypeDef *hfdcan,
                                               uint32_t identifier,
-                                              uint8_t *data)
+                                              uint8_t *data, size_t len)
 {
-    if (!this->_can_drv_map.exist(hfdcan))
+    can_drv_t *can_drv = hub_get_can_obj(hfdcan);
+    if (nullptr == can_drv)
         return pyro::PYRO_ERROR;
-    // return this->_can_drv_map[hfdcan]->hub_handle_callback(hfdcan, data);
-    return this->_can_drv_map[hfdcan]->handle_rx_msg(identifier, data);
+    return can_drv->handle_rx_msg(identifier, data, len);
 }
 
 }; // namespace pyro
@@ -241,28 +648,32 @@ void can_global_handle(FDCAN_HandleTypeDef *hfdcan, uint32_t identifier,
                                                          data);
 }
 
-FDCAN_RxHeaderTypeDef rx_header;
-uint32_t a;
+extern "C" void HAL_FDCAN_TxBufferCompleteCallback(FDCAN_HandleTypeDef *hfdcan,
+                                                  uint32_t BufferIndexes)
+{
+    pyro::can_drv_t *can_drv =
+        pyro::can_hub_t::get_instance()->hub_get_can_obj(hfdcan);
+    if (nullptr == can_drv)
+        return;
+    can_drv->handle_tx_complete();
+}
+
 extern "C" void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef *hfdcan,
                                           uint32_t RxFifo0ITs)
 {
+    pyro::can_drv_t *can_drv =
+        pyro::can_hub_t::get_instance()->hub_get_can_obj(hfdcan);
+    if (nullptr == can_drv)
+        return;
+    can_drv->handle_rx_fifo0(RxFifo0ITs);
+}
 
-    uint8_t data[8];
-    if (HAL_OK !=
-        HAL_FDCAN_GetRxMessage(hfdcan, FDCAN_RX_FIFO0, &rx_header, data))
-    {
+extern "C" void HAL_FDCAN_ErrorStatusCallback(FDCAN_HandleTypeDef *hfdcan,
+                                              uint32_t ErrorStatusITs)
+{
+    pyro::can_drv_t *can_drv =
+        pyro::can_hub_t::get_instance()->hub_get_can_obj(hfdcan);
+    if (nullptr == can_drv)
         return;
-    }
-    if (FDCAN_FRAME_CLASSIC == rx_header.RxFrameType &&
-        FDCAN_STANDARD_ID == rx_header.IdType)
-    {
-        if (hfdcan == &hfdcan1)
-            a++;
-        else if (hfdcan == &hfdcan2)
-            a--;
-        else if (hfdcan == &hfdcan3)
-            a;
-
-        can_global_handle(hfdcan, rx_header.Identifier, data);
-    }
-}
\ No newline at end of file
+    can_drv->handle_error_status(ErrorStatusITs);
+}
@@ -2,55 +2,283 @@
 #define CAN_DRV_H
 
 #include "fdcan.h"
+#include "pyro_core_config.h"
 #include "pyro_core_def.h"
 
 #include <array>
 #include <cmsis_os.h>
+#include <cstring>
 
-#include "map.h"
+#include "id_table.h"
+#include "pyro_seqlock.h"
+#include "pyro_pool.h"
+#include "pyro_can_dlc.h"
+#include "pyro_can_filter.h"
+#include "pyro_can_rx_group.h"
+#include "pyro_can_stats.h"
+#include "pyro_can_tx_queue.h"
 
 namespace pyro
 {
-class can_msg_buffer_t
+/**
+ * @brief Marks a 29-bit identifier. IDs carrying this flag are sent and
+ *        matched as extended frames everywhere in the CAN stack, IDs without
+ *        it as standard frames.
+ */
+static constexpr uint32_t CAN_EXT_ID_FLAG = 0x80000000U;
+static constexpr uint32_t CAN_EXT_ID_MASK = 0x1FFFFFFFU;
+
+constexpr uint32_t can_ext_id(const uint32_t id)
+{
+    return (id & CAN_EXT_ID_MASK) | CAN_EXT_ID_FLAG;
+}
+
+constexpr bool can_is_ext_id(const uint32_t id)
+{
+    return 0 != (id & CAN_EXT_ID_FLAG);
+}
+
+/**
+ * @brief Pool slot for RX buffers created with new. FD-sized buffers only fit
+ *        when CAN_FD_EN is set; otherwise they come from the heap.
+ */
+static constexpr size_t CAN_MSG_POOL_SLOT_SIZE =
+    (CAN_FD_EN ? 40 : 24) * sizeof(void *);
+
+/**
+ * @brief Length-independent part of a registered RX buffer. The driver
+ *        dispatches to this interface, so classic and FD buffers can share
+ *        one bus. Construct with `can_ext_id(id)` to receive a 29-bit ID.
+ */
+class can_msg_buffer_base_t
+    : public pool_new_t<can_msg_buffer_base_t, PYRO_POOL_CAN_MSG_NUM,
+                        CAN_MSG_POOL_SLOT_SIZE>
 {
   public:
-    explicit can_msg_buffer_t(uint32_t id);
-    ~can_msg_buffer_t();
+    explicit can_msg_buffer_base_t(uint32_t id);
+    virtual ~can_msg_buffer_base_t();
 
     uint32_t get_id();
     bool is_fresh();
     void mark_read();
-    void update_data(const uint8_t *data);
-    bool get_data(std::array<uint8_t, 8> &data);
     TickType_t get_last_update_time();
+    can_rx_timing_t get_rx_timing();
+    void set_nominal_period(TickType_t period_ticks);
+    bool is_online();
+    bool check_online(TickType_t now, uint32_t timeout_factor);
+    status_t attach_group(can_rx_group_t *group, uint8_t index);
+    void notify_group(BaseType_t *woken);
+    virtual void update_data(const uint8_t *data, size_t len) = 0;
+    virtual uint32_t get_torn_read_count()                    = 0;
+
+  protected:
+    void mark_updated();
 
   private:
     uint32_t _id;
-    std::array<uint8_t, 8> _buffer;
     volatile bool _is_fresh;
-    TickType_t _last_update_time;
-    SemaphoreHandle_t _mtx;
+    volatile TickType_t _last_update_time;
+    volatile bool _online;
+    TickType_t _nominal_period; // 0: not monitored
+    uint32_t _last_stamp; // DWT ticks of the previous update
+    can_rx_timing_t _timing;
+    can_rx_group_t *_group;
+    uint8_t _group_index;
 };
 
+/**
+ * @brief RX buffer holding the latest payload of up to N bytes.
+ *
+ * The payload is published through a seqlock: the RX ISR writes without
+ * waiting, get_data() retries a bounded number of times and returns false
+ * rather than a half-updated frame. Shorter frames are zero-padded.
+ */
+template <size_t N> class basic_can_msg_buffer_t : public can_msg_buffer_base_t
+{
+    static_assert(N > 0 && N <= CAN_FD_MAX_LEN, "invalid CAN payload size");
+
+  public:
+    explicit basic_can_msg_buffer_t(uint32_t id) : can_msg_buffer_base_t(id)
+    {
+    }
+
+    void update_data(const uint8_t *data)
+    {
+        update_data(data, N);
+    }
+
+    void update_data(const uint8_t *data, size_t len) override
+    {
+        payload_t payload{};
+        payload.len = static_cast<uint8_t>(len < N ? len : N);
+        memcpy(payload.data.data(), data, payload.len);
+        _buffer.write(payload);
+        mark_updated();
+    }
+
+    bool get_data(std::array<uint8_t, N> &data)
+    {
+        uint8_t len;
+        return get_data(data, len);
+    }
+
+    bool get_data(std::array<uint8_t, N> &data, uint8_t &len)
+    {
+        payload_t payload;
+        if (!_buffer.read(payload))
+            return false;
+        data = payload.data;
+        len  = payload.len;
+        return true;
+    }
+
+    uint32_t get_torn_read_count() override
+    {
+        return _buffer.get_torn_count();
+    }
+
+  private:
+    struct payload_t
+    {
+        std::array<uint8_t, N> data;
+        uint8_t len;
+    };
+
+    seqlock_t<payload_t> _buffer;
+};
+
+using can_msg_buffer_t   = basic_can_msg_buffer_t<CAN_CLASSIC_MAX_LEN>;
+using canfd_msg_buffer_t = basic_can_msg_buffer_t<CAN_FD_MAX_LEN>;
+
 class can_drv_t
 {
-    const uint8_t MAX_ID_REGIST_NUM = 32;
-    using can_id_regist_t           = uint16_t;
+    static constexpr uint8_t MAX_ID_REGIST_NUM = 32;
+    // 4x MAX_ID_REGIST_NUM: at 2x the seed search fails for about half of
+    // random 32-ID sets
+    static constexpr size_t RX_TABLE_SLOTS     = 128;
+    static constexpr uint8_t MAX_STD_FILTER_NUM = 28;
+    static constexpr uint8_t MAX_EXT_FILTER_NUM = 8;
+    static constexpr size_t TX_QUEUE_DEPTH      = 16;
+    static constexpr uint32_t LOAD_WINDOW_DIV   = 100; // 10 ms windows
+    using can_id_regist_t                      = uint16_t;
+#if CAN_FD_EN
+    static constexpr size_t TX_MAX_LEN = CAN_FD_MAX_LEN;
+#else
+    static constexpr size_t TX_MAX_LEN = CAN_CLASSIC_MAX_LEN;
+#endif
 
   public:
+    /**
+     * @brief Per-bus counters of the batched RX FIFO0 drain.
+     */
+    struct rx_batch_stats_t
+    {
+        uint32_t irq_count;          // RX FIFO0 interrupts serviced
+        uint32_t frame_count;        // frames drained in total
+        uint32_t max_frames_per_irq; // largest batch drained at once
+        uint32_t fifo_high_water;    // highest fill level seen on entry
+    };
+
+    /**
+     * @brief Priority of a transmitted frame, most urgent first.
+     */
+    enum tx_priority_t : uint8_t
+    {
+        tx_prio_control,   // motor commands
+        tx_prio_normal,    // configuration, enable/disable
+        tx_prio_telemetry, // everything that may be late
+        tx_prio_num
+    };
+
+    /**
+     * @brief Counters of the software TX queue; latencies in DWT cycles.
+     */
+    using tx_stats_t = can_tx_stats_t;
+
+    /**
+     * @brief Per-bus traffic and error counters.
+     */
+    struct can_stats_t
+    {
+        uint32_t rx_frames;     // frames drained from RX FIFO0
+        uint32_t rx_unmatched;  // received frames without a registered buffer
+        uint32_t tx_frames;     // frames handed to the hardware TX FIFO
+        uint32_t tx_dropped;    // frames rejected by the software TX queue
+        uint32_t fifo_overruns; // RX FIFO0 message-lost events
+        uint32_t error_passive; // transitions to error-passive
+        uint32_t bus_off;       // transitions to bus-off
+        float bus_load;         // smoothed bus load, percent
+    };
+
     explicit can_drv_t(FDCAN_HandleTypeDef *hfdcan);
     ~can_drv_t();
 
     status_t init();
     status_t start();
-    status_t send_msg(uint32_t id, uint8_t *data);
-    status_t register_rx_msg(can_msg_buffer_t *msg_buffer);
-    status_t handle_rx_msg(uint32_t id, uint8_t *data);
+    status_t send_msg(uint32_t id, uint8_t *data,
+                      tx_priority_t prio = tx_prio_normal);
+    status_t send_fd_msg(uint32_t id, const uint8_t *data, size_t len,
+                         tx_priority_t prio = tx_prio_normal);
+    status_t register_rx_msg(can_msg_buffer_base_t *msg_buffer);
+    status_t handle_rx_msg(uint32_t id, uint8_t *data,
+                           size_t len = CAN_CLASSIC_MAX_LEN,
+                           BaseType_t *woken = nullptr);
+    void handle_rx_fifo0(uint32_t rx_fifo0_its);
+    rx_batch_stats_t get_rx_batch_stats() const;
+    void handle_tx_complete();
+    tx_stats_t get_tx_stats() const;
+    void handle_error_status(uint32_t error_status_its);
+    can_stats_t get_stats();
+    uint32_t scan_online(TickType_t now, uint32_t timeout_factor);
+    uint32_t get_offline_mask() const;
 
   private:
+    /**
+     * @brief Frame waiting in the software TX queue.
+     */
+    struct tx_frame_t
+    {
+        uint32_t id;
+        uint32_t stamp; // DWT ticks at enqueue
+        uint8_t len;    // already rounded up to a valid DLC size
+        bool fd;
+        std::array<uint8_t, TX_MAX_LEN> data;
+    };
+
+    /**
+     * @brief Hardware side of the TX queue: the TX FIFO and the DWT clock.
+     */
+    struct tx_port_t
+    {
+        can_drv_t &drv;
+
+        bool has_room() const;
+        bool write(const tx_frame_t &frame);
+        uint32_t now() const;
+    };
+
+    size_t collect_ids(bool extended, uint32_t *ids,
+                       can_msg_buffer_base_t **buffers);
+    status_t rebuild_rx_table();
+    status_t program_filters();
+    status_t program_filters(bool extended);
+    status_t transmit(tx_frame_t &frame, tx_priority_t prio);
+    status_t write_tx_fifo(const tx_frame_t &frame);
+    void account_frame(size_t len, bool extended, bool fd, bool brs);
+
     FDCAN_HandleTypeDef *_hfdcan;
-    map_t<uint32_t, can_msg_buffer_t *> _registerlist;
+    std::array<can_msg_buffer_base_t *, MAX_ID_REGIST_NUM> _registerlist;
+    uint8_t _register_count;
+    id_table_t<can_msg_buffer_base_t *, RX_TABLE_SLOTS> _rx_table;
+    id_table_t<can_msg_buffer_base_t *, RX_TABLE_SLOTS> _rx_ext_table;
     SemaphoreHandle_t _registermtx;
+    rx_batch_stats_t _rx_batch_stats;
+    can_tx_queue_t<tx_frame_t, TX_QUEUE_DEPTH, tx_prio_num> _tx_queue;
+    can_stats_t _stats;
+    can_load_meter_t _load_meter;
+    uint32_t _nominal_bps;
+    uint32_t _data_bps;
+    volatile uint32_t _offline_mask;
 };
 
 class can_hub_t
@@ -61,7 +289,8 @@ class can_hub_t
     {
         can1,
         can2,
-        can3
+        can3,
+        can_num
     };
 
     static can_hub_t *get_instance(void);
@@ -71,15 +300,17 @@ class can_hub_t
                                   can_drv_t *can_drv);
     status_t hub_unregister_can_obj(FDCAN_HandleTypeDef *hfdcan);
     can_drv_t *hub_get_can_obj(which_can which_can);
+    can_drv_t *hub_get_can_obj(const FDCAN_HandleTypeDef *hfdcan);
     status_t hub_handle_callback(FDCAN_HandleTypeDef *hfdcan,
-                                 uint32_t identifier, uint8_t *data);
+                                 uint32_t identifier, uint8_t *data,
+                                 size_t len = CAN_CLASSIC_MAX_LEN);
 
   private:
     can_hub_t();
     can_hub_t(const can_hub_t &)            = delete;
     can_hub_t &operator=(const can_hub_t &) = delete;
-    static can_hub_t *_instancePtr;
-    map_t<FDCAN_HandleTypeDef *, can_drv_t *> _can_drv_map;
+    static int8_t which_of(const FDCAN_HandleTypeDef *hfdcan);
+    std::array<can_drv_t *, can_num> _can_drv_map;
 };
 }; // namespace pyro
 
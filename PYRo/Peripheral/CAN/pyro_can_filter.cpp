@@ -0,0 +1,102 @@
+#include "pyro_can_filter.h"
+
+#include <algorithm>
+#include <array>
+
+namespace pyro
+{
+namespace
+{
+struct id_group_t
+{
+    uint32_t lo;
+    uint32_t hi;
+};
+
+size_t elems_needed(const id_group_t *groups, const size_t group_count)
+{
+    size_t singles = 0;
+    size_t ranges  = 0;
+    for (size_t i = 0; i < group_count; i++)
+    {
+        if (groups[i].lo == groups[i].hi)
+            singles++;
+        else
+            ranges++;
+    }
+    return ranges + (singles + 1) / 2;
+}
+} // namespace
+
+size_t can_filter_plan(const uint32_t *ids, const size_t count,
+                       can_filter_elem_t *out, const size_t max_elems)
+{
+    std::array<uint32_t, CAN_FILTER_MAX_IDS> sorted{};
+    std::array<id_group_t, CAN_FILTER_MAX_IDS> groups{};
+    size_t group_count = 0;
+
+    if (0 == count || count > CAN_FILTER_MAX_IDS || 0 == max_elems)
+        return 0;
+
+    std::copy(ids, ids + count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + count);
+    const size_t unique =
+        std::unique(sorted.begin(), sorted.begin() + count) - sorted.begin();
+
+    // group runs of consecutive IDs
+    for (size_t i = 0; i < unique; i++)
+    {
+        if (group_count > 0 && groups[group_count - 1].hi + 1 == sorted[i])
+        {
+            groups[group_count - 1].hi = sorted[i];
+        }
+        else
+        {
+            groups[group_count++] = {sorted[i], sorted[i]};
+        }
+    }
+
+    // merge the closest neighbours until the plan fits
+    while (group_count > 1 &&
+           elems_needed(groups.data(), group_count) > max_elems)
+    {
+        size_t best = 0;
+        for (size_t i = 1; i + 1 < group_count; i++)
+        {
+            if (groups[i + 1].lo - groups[i].hi <
+                groups[best + 1].lo - groups[best].hi)
+                best = i;
+        }
+        groups[best].hi = groups[best + 1].hi;
+        std::copy(groups.begin() + best + 2, groups.begin() + group_count,
+                  groups.begin() + best + 1);
+        group_count--;
+    }
+
+    size_t n           = 0;
+    int32_t pending_id = -1;
+    for (size_t i = 0; i < group_count; i++)
+    {
+        if (groups[i].lo != groups[i].hi)
+        {
+            out[n++] = {can_filter_elem_t::range, groups[i].lo, groups[i].hi};
+        }
+        else if (pending_id < 0)
+        {
+            pending_id = static_cast<int32_t>(groups[i].lo);
+        }
+        else
+        {
+            out[n++]   = {can_filter_elem_t::dual,
+                          static_cast<uint32_t>(pending_id), groups[i].lo};
+            pending_id = -1;
+        }
+    }
+    if (pending_id >= 0)
+    {
+        out[n++] = {can_filter_elem_t::dual, static_cast<uint32_t>(pending_id),
+                    static_cast<uint32_t>(pending_id)};
+    }
+    return n;
+}
+}; // namespace pyro
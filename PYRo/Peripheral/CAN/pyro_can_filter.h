@@ -0,0 +1,49 @@
+#ifndef __PYRO_CAN_FILTER_H__
+#define __PYRO_CAN_FILTER_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/**
+ * @brief One planned acceptance-filter element.
+ *
+ * `range` accepts every ID in [id1, id2]; `dual` accepts exactly id1 and id2.
+ */
+struct can_filter_elem_t
+{
+    enum type_t : uint8_t
+    {
+        range,
+        dual
+    };
+
+    type_t type;
+    uint32_t id1;
+    uint32_t id2;
+};
+
+/**
+ * @brief Coalesces a set of CAN IDs into at most `max_elems` filter elements.
+ *
+ * Consecutive IDs are grouped into range elements and isolated IDs are paired
+ * into dual elements. While the result still exceeds `max_elems`, the two
+ * neighbouring groups separated by the smallest gap are merged, which keeps
+ * the number of unregistered IDs let through as low as possible.
+ *
+ * Pure function without HAL dependencies.
+ *
+ * @param ids        registered IDs, any order, duplicates allowed
+ * @param count      number of entries in `ids` (at most CAN_FILTER_MAX_IDS)
+ * @param out        destination for the planned elements
+ * @param max_elems  capacity of `out`
+ * @return number of elements written to `out`, 0 if `count` is 0 or invalid
+ */
+size_t can_filter_plan(const uint32_t *ids, size_t count,
+                       can_filter_elem_t *out, size_t max_elems);
+
+static constexpr size_t CAN_FILTER_MAX_IDS = 64;
+}; // namespace pyro
+
+#endif
@@ -0,0 +1,68 @@
+#include "pyro_can_monitor.h"
+
+namespace pyro
+{
+can_monitor_t::can_monitor_t() : _task(nullptr)
+{
+    for (auto &mask : _offline_mask)
+    {
+        mask = 0;
+    }
+}
+
+can_monitor_t *can_monitor_t::get_instance(void)
+{
+    static can_monitor_t instance;
+    return &instance;
+}
+
+status_t can_monitor_t::start()
+{
+    if (nullptr != _task)
+        return PYRO_OK;
+    if (pdPASS != _task_storage.create(monitor_task, "can_monitor", this,
+                                       tskIDLE_PRIORITY + 1, &_task))
+        return PYRO_NO_MEMORY;
+    return PYRO_OK;
+}
+
+void can_monitor_t::scan()
+{
+    const TickType_t now = xTaskGetTickCount();
+    for (uint8_t which = can_hub_t::can1; which < can_hub_t::can_num; which++)
+    {
+        can_drv_t *can_drv = can_hub_t::get_instance()->hub_get_can_obj(
+            static_cast<can_hub_t::which_can>(which));
+        _offline_mask[which] =
+            can_drv ? can_drv->scan_online(now, CAN_MONITOR_TIMEOUT_FACTOR) : 0;
+    }
+}
+
+uint32_t can_monitor_t::get_offline_mask(can_hub_t::which_can which) const
+{
+    if (which < can_hub_t::can1 || which >= can_hub_t::can_num)
+        return 0;
+    return _offline_mask[which];
+}
+
+bool can_monitor_t::all_online() const
+{
+    for (const auto &mask : _offline_mask)
+    {
+        if (mask)
+            return false;
+    }
+    return true;
+}
+
+void can_monitor_t::monitor_task(void *argument)
+{
+    auto *monitor        = static_cast<can_monitor_t *>(argument);
+    TickType_t last_wake = xTaskGetTickCount();
+    while (true)
+    {
+        monitor->scan();
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(CAN_MONITOR_PERIOD_MS));
+    }
+}
+}; // namespace pyro
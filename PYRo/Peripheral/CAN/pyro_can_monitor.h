@@ -0,0 +1,43 @@
+#ifndef __PYRO_CAN_MONITOR_H__
+#define __PYRO_CAN_MONITOR_H__
+
+#include "pyro_can_drv.h"
+#include "pyro_core_config.h"
+#include "pyro_static_alloc.h"
+
+#include <array>
+
+namespace pyro
+{
+/**
+ * @brief Centralised online watchdog for registered CAN RX buffers.
+ *
+ * A low-priority task scans every registered buffer each
+ * CAN_MONITOR_PERIOD_MS. A buffer with a nominal period that has not been
+ * updated for CAN_MONITOR_TIMEOUT_FACTOR periods is flagged offline; the next
+ * received frame flags it online again from the RX ISR. Each bus publishes
+ * an offline bitmask indexed by registration order.
+ */
+class can_monitor_t
+{
+  public:
+    static can_monitor_t *get_instance(void);
+
+    status_t start();
+    void scan();
+    uint32_t get_offline_mask(can_hub_t::which_can which) const;
+    bool all_online() const;
+
+  private:
+    can_monitor_t();
+    can_monitor_t(const can_monitor_t &)            = delete;
+    can_monitor_t &operator=(const can_monitor_t &) = delete;
+    static void monitor_task(void *argument);
+
+    task_storage_t<128> _task_storage;
+    TaskHandle_t _task;
+    std::array<volatile uint32_t, can_hub_t::can_num> _offline_mask;
+};
+}; // namespace pyro
+
+#endif
@@ -0,0 +1,59 @@
+#include "pyro_can_rx_group.h"
+#include "pyro_can_drv.h"
+
+namespace pyro
+{
+can_rx_group_t::can_rx_group_t()
+    : _task(nullptr), _all_mask(0), _pending_mask(0), _cycle_count(0),
+      _member_num(0)
+{
+}
+
+status_t can_rx_group_t::add(can_msg_buffer_base_t *buffer)
+{
+    if (nullptr == buffer || _member_num >= MAX_MEMBER_NUM)
+        return PYRO_PARAM_ERROR;
+    if (PYRO_OK != buffer->attach_group(this, _member_num))
+        return PYRO_ERROR;
+
+    taskENTER_CRITICAL();
+    _all_mask |= 1U << _member_num;
+    _pending_mask = 0;
+    _member_num++;
+    taskEXIT_CRITICAL();
+    return PYRO_OK;
+}
+
+void can_rx_group_t::set_task(TaskHandle_t task)
+{
+    _task = task;
+}
+
+uint8_t can_rx_group_t::size() const
+{
+    return _member_num;
+}
+
+bool can_rx_group_t::wait(TickType_t timeout_ticks)
+{
+    if (nullptr == _task)
+        _task = xTaskGetCurrentTaskHandle();
+    return ulTaskNotifyTake(pdTRUE, timeout_ticks) > 0;
+}
+
+void can_rx_group_t::member_updated(uint8_t index, BaseType_t *woken)
+{
+    _pending_mask |= 1U << index;
+    if (_pending_mask != _all_mask)
+        return;
+    _pending_mask = 0;
+    _cycle_count++;
+    if (nullptr != _task)
+        vTaskNotifyGiveFromISR(_task, woken);
+}
+
+uint32_t can_rx_group_t::get_cycle_count() const
+{
+    return _cycle_count;
+}
+}; // namespace pyro
@@ -0,0 +1,58 @@
+#ifndef __PYRO_CAN_RX_GROUP_H__
+#define __PYRO_CAN_RX_GROUP_H__
+
+#include "pyro_core_def.h"
+
+#include <cmsis_os.h>
+#include <cstdint>
+
+namespace pyro
+{
+class can_msg_buffer_base_t;
+
+/**
+ * @brief Set of RX buffers whose owner task is woken once all of them have
+ *        been refreshed.
+ *
+ * The RX ISR marks each member as it is updated. When the last outstanding
+ * member arrives, the owner task receives a direct-to-task notification and
+ * the marks are cleared for the next cycle, so a control loop can run
+ * synchronously to its feedback instead of the RTOS tick. A group with a
+ * single member notifies on every frame of that ID.
+ */
+class can_rx_group_t
+{
+  public:
+    static constexpr uint8_t MAX_MEMBER_NUM = 32;
+
+    can_rx_group_t();
+    can_rx_group_t(const can_rx_group_t &)            = delete;
+    can_rx_group_t &operator=(const can_rx_group_t &) = delete;
+
+    status_t add(can_msg_buffer_base_t *buffer);
+    void set_task(TaskHandle_t task);
+    uint8_t size() const;
+
+    /**
+     * @brief Blocks the calling task until the whole group was refreshed.
+     * @return false on timeout.
+     */
+    bool wait(TickType_t timeout_ticks);
+
+    /**
+     * @brief Called from the RX ISR when member `index` was updated.
+     */
+    void member_updated(uint8_t index, BaseType_t *woken);
+
+    uint32_t get_cycle_count() const;
+
+  private:
+    TaskHandle_t _task;
+    uint32_t _all_mask;
+    uint32_t _pending_mask;
+    uint32_t _cycle_count;
+    uint8_t _member_num;
+};
+}; // namespace pyro
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef __PYRO_CAN_STATS_H__
+#define __PYRO_CAN_STATS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/**
+ * @brief Bus time of one frame, split by bit rate phase.
+ */
+struct can_frame_bits_t
+{
+    uint32_t nominal; // bits sent at the nominal (arbitration) rate
+    uint32_t data;    // bits sent at the data rate (FD with BRS only)
+};
+
+/**
+ * @brief Worst-case length in bits of a data frame, including stuff bits,
+ *        the 3-bit intermission and, for CAN FD, the fixed stuff bits and
+ *        stuff count. Used for bus-load estimation only.
+ */
+constexpr can_frame_bits_t can_frame_bits(const size_t len,
+                                          const bool extended, const bool fd,
+                                          const bool brs)
+{
+    // classic: SOF..CRC is 34 (std) / 54 (ext) bits + payload, stuffed
+    // every 4 bits in the worst case, then CRC delimiter, ACK, EOF and IFS
+    const uint32_t head    = extended ? 54 : 34;
+    const uint32_t payload = static_cast<uint32_t>(len) * 8;
+    if (!fd)
+    {
+        return {head + payload + (head + payload - 1) / 4 + 13, 0};
+    }
+    // FD: arbitration field up to BRS, then ESI/DLC, payload, stuff count
+    // and CRC (17 or 21 bits) with one fixed stuff bit every 4 bits
+    const uint32_t arb  = extended ? 33 : 14;
+    const uint32_t crc  = len <= 16 ? 17 : 21;
+    const uint32_t data = 5 + payload + (arb + 5 + payload - 1) / 4 + 4 + crc +
+                          (4 + crc) / 4;
+    const uint32_t tail = 13; // CRC delimiter, ACK, EOF, IFS
+    return brs ? can_frame_bits_t{arb + tail, data}
+               : can_frame_bits_t{arb + data + tail, 0};
+}
+
+/**
+ * @brief Rolling bus-load estimator.
+ *
+ * Frames add their bus time; once a window has elapsed the busy fraction of
+ * that window is folded into an exponential moving average. Time is given in
+ * caller ticks, so the estimator is independent of any clock source.
+ */
+class can_load_meter_t
+{
+  public:
+    static constexpr float DEFAULT_ALPHA = 0.2f;
+
+    can_load_meter_t()
+        : _busy_ns(0), _window_start(0), _load(0.0f), _alpha(DEFAULT_ALPHA),
+          _started(false)
+    {
+    }
+
+    void add(const can_frame_bits_t &bits, const uint32_t nominal_bps,
+             const uint32_t data_bps)
+    {
+        if (0 == nominal_bps)
+            return;
+        _busy_ns += 1000000000ULL * bits.nominal / nominal_bps;
+        if (bits.data > 0)
+            _busy_ns += 1000000000ULL * bits.data /
+                        (data_bps ? data_bps : nominal_bps);
+    }
+
+    /**
+     * @brief Closes the current window if at least `window_ticks` elapsed.
+     */
+    void update(const uint32_t now, const uint32_t window_ticks,
+                const uint32_t tick_hz)
+    {
+        if (!_started)
+        {
+            _window_start = now;
+            _busy_ns      = 0;
+            _started      = true;
+            return;
+        }
+        const uint32_t elapsed = now - _window_start;
+        if (elapsed < window_ticks || 0 == tick_hz)
+            return;
+        const float window_ns = 1.0e9f * elapsed / tick_hz;
+        float sample          = _busy_ns / window_ns;
+        sample                = sample > 1.0f ? 1.0f : sample;
+        _load += _alpha * (sample - _load);
+        _busy_ns      = 0;
+        _window_start = now;
+    }
+
+    /**
+     * @brief Smoothed bus load in percent.
+     */
+    float get_load_percent() const
+    {
+        return _load * 100.0f;
+    }
+
+  private:
+    uint64_t _busy_ns;
+    uint32_t _window_start;
+    float _load;
+    float _alpha;
+    bool _started;
+};
+
+/**
+ * @brief Inter-arrival statistics of one periodic message, in ticks.
+ *
+ * `jitter` is the moving average of the absolute deviation of each interval
+ * from the moving average interval.
+ */
+struct can_rx_timing_t
+{
+    uint32_t last_interval;
+    uint32_t min_interval;
+    uint32_t max_interval;
+    float mean_interval;
+    float jitter;
+};
+
+inline void can_rx_timing_add(can_rx_timing_t &timing,
+                              const uint32_t interval)
+{
+    constexpr float alpha = 1.0f / 16.0f;
+    timing.last_interval  = interval;
+    if (0 == timing.max_interval)
+    {
+        timing.min_interval  = interval;
+        timing.max_interval  = interval;
+        timing.mean_interval = static_cast<float>(interval);
+        timing.jitter        = 0.0f;
+        return;
+    }
+    if (interval < timing.min_interval)
+        timing.min_interval = interval;
+    if (interval > timing.max_interval)
+        timing.max_interval = interval;
+    const float dev = static_cast<float>(interval) - timing.mean_interval;
+    timing.mean_interval += alpha * dev;
+    timing.jitter += alpha * ((dev < 0.0f ? -dev : dev) - timing.jitter);
+}
+}; // namespace pyro
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef __PYRO_CAN_TX_QUEUE_H__
+#define __PYRO_CAN_TX_QUEUE_H__
+
+#include "pyro_core_def.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/**
+ * @brief Counters of a TX queue. Latencies are ticks of the port clock
+ *        between queueing a frame and its hand-off to the hardware FIFO.
+ */
+struct can_tx_stats_t
+{
+    uint32_t direct_count;  // frames written straight to hardware
+    uint32_t queued_count;  // frames that had to wait in the queue
+    uint32_t dropped_count; // frames rejected: queue full or write failed
+    uint32_t queue_high_water;
+    uint32_t max_latency;
+    uint64_t total_latency; // sum over all queued frames
+};
+
+/**
+ * @brief Fixed-capacity multi-level TX queue of frames of type T.
+ *
+ * Every priority level owns a ring of DEPTH frames; `pop` always returns the
+ * oldest frame of the most urgent non-empty level (level 0 first). Frames of
+ * one level keep their order. The queue neither locks nor reads any clock,
+ * so it can drive a host-side bus-load simulation unchanged; the caller is
+ * responsible for mutual exclusion.
+ *
+ * `send` and `refill` run the TX path against a `Port`, the hardware side:
+ * `bool has_room()`, `bool write(const T &)` and `uint32_t now()`. T then
+ * needs a `uint32_t stamp` member.
+ */
+template <typename T, size_t DEPTH, size_t LEVELS> class can_tx_queue_t
+{
+    static_assert(DEPTH > 0 && LEVELS > 0, "empty can_tx_queue_t");
+
+  public:
+    can_tx_queue_t() : _rings(), _stats()
+    {
+    }
+
+    /**
+     * @brief Writes `frame` straight to the hardware if nothing waits and
+     *        there is room, else queues it at `level`.
+     * @return PYRO_BUSY if the level is full, PYRO_ERROR if the write failed.
+     */
+    template <typename Port>
+    status_t send(Port &port, const size_t level, T &frame)
+    {
+        if (empty() && port.has_room())
+        {
+            if (!port.write(frame))
+                return PYRO_ERROR;
+            _stats.direct_count++;
+            return PYRO_OK;
+        }
+        frame.stamp = port.now();
+        if (!push(level, frame))
+        {
+            _stats.dropped_count++;
+            return PYRO_BUSY;
+        }
+        _stats.queued_count++;
+        if (size() > _stats.queue_high_water)
+            _stats.queue_high_water = size();
+        // the FIFO may have drained between the check and the push
+        refill(port);
+        return PYRO_OK;
+    }
+
+    /**
+     * @brief Moves queued frames to the hardware while it has room, most
+     *        urgent first. Called on TX complete.
+     */
+    template <typename Port> void refill(Port &port)
+    {
+        T frame;
+        while (port.has_room() && pop(frame))
+        {
+            if (!port.write(frame))
+            {
+                _stats.dropped_count++;
+                continue;
+            }
+            const uint32_t latency = port.now() - frame.stamp;
+            _stats.total_latency += latency;
+            if (latency > _stats.max_latency)
+                _stats.max_latency = latency;
+        }
+    }
+
+    const can_tx_stats_t &stats() const
+    {
+        return _stats;
+    }
+
+    bool push(const size_t level, const T &frame)
+    {
+        if (level >= LEVELS || _rings[level].count >= DEPTH)
+            return false;
+        ring_t &ring = _rings[level];
+        ring.frames[(ring.head + ring.count) % DEPTH] = frame;
+        ring.count++;
+        return true;
+    }
+
+    bool pop(T &frame)
+    {
+        for (auto &ring : _rings)
+        {
+            if (ring.count > 0)
+            {
+                frame     = ring.frames[ring.head];
+                ring.head = (ring.head + 1) % DEPTH;
+                ring.count--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t size() const
+    {
+        size_t n = 0;
+        for (const auto &ring : _rings)
+        {
+            n += ring.count;
+        }
+        return n;
+    }
+
+    size_t size(const size_t level) const
+    {
+        return level < LEVELS ? _rings[level].count : 0;
+    }
+
+    bool empty() const
+    {
+        return 0 == size();
+    }
+
+  private:
+    struct ring_t
+    {
+        std::array<T, DEPTH> frames;
+        size_t head;
+        size_t count;
+    };
+
+    std::array<ring_t, LEVELS> _rings;
+    can_tx_stats_t _stats;
+};
+}; // namespace pyro
+
+#endif
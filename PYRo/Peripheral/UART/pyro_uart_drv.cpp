@@ -3,8 +3,8 @@
  * @brief Implementation file for the PYRO C++ UART Driver class.
  *
  * This file implements the `pyro::uart_drv_t` methods, including DMA buffer
- * allocation, transmission logic, and the critical static map mechanism
- * to link HAL ISR callbacks to the correct C++ driver instance.
+ * allocation, transmission logic, and the static instance table that links
+ * HAL ISR callbacks to the correct C++ driver instance.
  *
  * @author Lucky
  * @version 1.0.0
@@ -17,29 +17,32 @@
 #include "stm32h7xx_hal_dma.h"
 
 #include <cstring>
-#include <map>
 
-#include "pyro_core_dma_heap.h"
 #include "pyro_uart_drv.h"
+#include "task.h"
 #include "usart.h"
 
-#include <stdexcept>
-
 namespace pyro
 {
 /* Constructor and Destructor ------------------------------------------------*/
 /**
  * @brief Constructor for the UART driver.
  *
- * Allocates two DMA-capable buffers, registers the instance in the static map,
- * and initializes state flags.
+ * Allocates two cache-line aligned DMA buffers, registers the instance in
+ * the static table, and initializes state flags.
  */
 uart_drv_t::uart_drv_t(UART_HandleTypeDef *huart, const uint16_t buf_length)
     : rx_buf{nullptr, nullptr}, _huart(huart)
 {
-    uart_map()[huart] = this;
-    rx_buf[0]         = static_cast<uint8_t *>(pvPortDmaMalloc(buf_length));
-    rx_buf[1]         = static_cast<uint8_t *>(pvPortDmaMalloc(buf_length));
+    const int8_t which = which_of(huart);
+    if (which >= 0)
+    {
+        _instances[which] = this;
+    }
+    _rx_mem[0].allocate(buf_length);
+    _rx_mem[1].allocate(buf_length);
+    rx_buf[0] = _rx_mem[0].data();
+    rx_buf[1] = _rx_mem[1].data();
     if (rx_buf[0] && rx_buf[1])
     {
         state.init_flag = true;
@@ -53,21 +56,18 @@ uart_drv_t::uart_drv_t(UART_HandleTypeDef *huart, const uint16_t buf_length)
 /**
  * @brief Destructor.
  *
- * Frees DMA-allocated buffers and removes the instance from the static map.
+ * Removes the instance from the static table; the DMA buffers release
+ * themselves.
  */
 uart_drv_t::~uart_drv_t()
 {
-    if (rx_buf[0])
+    rx_buf[0] = nullptr;
+    rx_buf[1] = nullptr;
+    const int8_t which = which_of(_huart);
+    if (which >= 0 && _instances[which] == this)
     {
-        vPortFree(rx_buf[0]);
-        rx_buf[0] = nullptr;
+        _instances[which] = nullptr;
     }
-    if (rx_buf[1])
-    {
-        vPortFree(rx_buf[1]);
-        rx_buf[1] = nullptr;
-    }
-    uart_map().erase(_huart);
 }
 
 /**
@@ -96,15 +96,32 @@ uart_drv_t *uart_drv_t::get_instance(const which_uart uart)
             return nullptr;
     }
 }
-/* Static Map Management -----------------------------------------------------*/
+/* Static Instance Table -----------------------------------------------------*/
+std::array<uart_drv_t *, uart_drv_t::uart_num> uart_drv_t::_instances{};
+
+/**
+ * @brief Maps a HAL handle to its `which_uart` index, -1 if unknown.
+ */
+int8_t uart_drv_t::which_of(const UART_HandleTypeDef *huart)
+{
+    if (huart == &huart1)
+        return uart1;
+    if (huart == &huart5)
+        return uart5;
+    if (huart == &huart7)
+        return uart7;
+    if (huart == &huart10)
+        return uart10;
+    return -1;
+}
+
 /**
- * @brief Provides access to the static map linking HAL handles to driver
- * instances.
+ * @brief Looks up the driver instance owning a HAL handle in O(1).
  */
-std::map<UART_HandleTypeDef *, uart_drv_t *> &uart_drv_t::uart_map()
+uart_drv_t *uart_drv_t::find(const UART_HandleTypeDef *huart)
 {
-    static std::map<UART_HandleTypeDef *, uart_drv_t *> instance;
-    return instance;
+    const int8_t which = which_of(huart);
+    return which >= 0 ? _instances[which] : nullptr;
 }
 
 /* Transmission Methods ------------------------------------------------------*/
@@ -134,29 +151,160 @@ status_t uart_drv_t::write(const uint8_t *p, const uint16_t size,
 }
 
 /**
- * @brief Non-blocking write using HAL DMA. Updates state flags on busy status.
+ * @brief Non-blocking write using HAL DMA.
+ *
+ * The buffer is queued as a one-segment frame, so it must stay valid until
+ * it has been sent. Returns PYRO_BUSY only when the TX queue is full.
  */
 status_t uart_drv_t::write(const uint8_t *p, const uint16_t size)
 {
-    const uint8_t ret = HAL_UART_Transmit_DMA(_huart, p, size);
-    if (ret == HAL_OK)
+    const uart_tx_seg_t seg{p, size};
+    return write_frame(&seg, 1);
+}
+
+/**
+ * @brief Queues a scatter-gather frame for DMA transmission.
+ *
+ * Segments are sent back-to-back from the caller's memory without copying;
+ * they must be DMA-reachable and stay untouched until `done` runs. If the
+ * DMA is idle the first segment starts immediately.
+ */
+status_t uart_drv_t::write_frame(const uart_tx_seg_t *segs,
+                                 const uint8_t seg_num,
+                                 const tx_done_func &done)
+{
+    if (nullptr == segs || 0 == seg_num || nullptr == _huart->hdmatx)
     {
-        return PYRO_OK;
+        return PYRO_PARAM_ERROR;
     }
-    if (ret == HAL_BUSY)
+    status_t status = PYRO_OK;
+    taskENTER_CRITICAL();
+    if (!_tx_queue.push(segs, seg_num, done))
+    {
+        if (_tx_queue.size() >= TX_QUEUE_DEPTH)
+        {
+            _tx_stats.queue_full++;
+            state.tx_busy = 0x01U;
+            status        = PYRO_BUSY;
+        }
+        else
+        {
+            status = PYRO_PARAM_ERROR;
+        }
+    }
+    else
+    {
+        if (_tx_queue.size() > _tx_stats.queue_high_water)
+        {
+            _tx_stats.queue_high_water = _tx_queue.size();
+        }
+        if (!_tx_active)
+        {
+            _tx_active = start_tx(_tx_queue.current());
+        }
+    }
+    taskEXIT_CRITICAL();
+    return status;
+}
+
+/**
+ * @brief Hands one segment to the TX DMA.
+ */
+bool uart_drv_t::start_tx(const uart_tx_seg_t *seg)
+{
+    if (nullptr == seg)
+    {
+        return false;
+    }
+    dma_cache_clean(seg->data, seg->size);
+    if (HAL_OK != HAL_UART_Transmit_DMA(_huart, seg->data, seg->size))
     {
         state.tx_busy = 0x01U;
-        return PYRO_BUSY;
+        return false;
     }
-    return PYRO_ERROR;
+    state.tx_busy = 0;
+    return true;
+}
+
+/**
+ * @brief Retires the segment that just finished and chains the next one.
+ *
+ * Called from the TX-complete interrupt. The frame's `done` callback runs
+ * after its last segment, once the next transfer is already started.
+ */
+void uart_drv_t::handle_tx_complete(BaseType_t &woken)
+{
+    const UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    const uart_tx_seg_t *seg = _tx_queue.current();
+    if (nullptr == seg || !_tx_active)
+    {
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        return;
+    }
+    _tx_stats.bytes_sent += seg->size;
+    _tx_window_bytes += seg->size;
+
+    const uint32_t now = xTaskGetTickCountFromISR();
+    if (now - _tx_window_start >= pdMS_TO_TICKS(1000))
+    {
+        _tx_stats.bytes_per_sec = _tx_window_bytes;
+        _tx_window_bytes        = 0;
+        _tx_window_start        = now;
+    }
+
+    const tx_queue_t::frame_t *finished;
+    const uart_tx_seg_t *next = _tx_queue.advance(finished);
+    tx_done_func done;
+    if (finished)
+    {
+        _tx_stats.frames_sent++;
+        done = finished->done;
+    }
+    _tx_active = start_tx(next);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    if (done)
+    {
+        done(woken);
+    }
+}
+
+/**
+ * @brief Restarts the current segment after the HAL aborted the transfer.
+ */
+void uart_drv_t::handle_tx_error()
+{
+    const UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    if (_tx_active && HAL_UART_STATE_READY == _huart->gState)
+    {
+        _tx_active = start_tx(_tx_queue.current());
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+}
+
+/**
+ * @brief Snapshot of the TX counters.
+ */
+uart_drv_t::tx_stats_t uart_drv_t::get_tx_stats() const
+{
+    taskENTER_CRITICAL();
+    tx_stats_t stats = _tx_stats;
+    if (xTaskGetTickCount() - _tx_window_start >= pdMS_TO_TICKS(2000))
+    {
+        stats.bytes_per_sec = 0; // Idle for a whole window
+    }
+    taskEXIT_CRITICAL();
+    return stats;
 }
 
 /* Reception Control Methods -------------------------------------------------*/
 /**
  * @brief Starts DMA reception, typically using ReceiveToIdle mode.
  *
- * It uses the currently selected RX buffer and disables the Half Transfer
- * interrupt, relying on the full RX Event (IDLE) interrupt.
+ * In double-buffer mode it uses the currently selected RX buffer and disables
+ * the Half Transfer interrupt, relying on the full RX Event (IDLE) interrupt.
+ * In circular mode the whole ring is handed to the DMA once; HT stays enabled
+ * so a long burst is published before the ring can overrun it.
  */
 status_t uart_drv_t::enable_rx_dma()
 {
@@ -165,8 +313,22 @@ status_t uart_drv_t::enable_rx_dma()
     {
         return PYRO_ERROR;
     }
-    const uint8_t ret = HAL_UARTEx_ReceiveToIdle_DMA(
-        _huart, rx_buf[rx_buf_switch], _rx_buf_size);
+    // Drop any cached copy before the DMA owns the buffer, so no dirty line
+    // is evicted on top of received data later
+    if (state.rx_circular)
+    {
+        _rx_ring.invalidate();
+    }
+    else
+    {
+        _rx_mem[rx_buf_switch].invalidate();
+    }
+    const uint8_t ret =
+        state.rx_circular
+            ? HAL_UARTEx_ReceiveToIdle_DMA(_huart, _rx_ring.data(),
+                                           _ring.size())
+            : HAL_UARTEx_ReceiveToIdle_DMA(_huart, rx_buf[rx_buf_switch],
+                                           _rx_buf_size);
     if (ret != HAL_OK)
     {
         state.rx_dma_enable = 0;
@@ -180,13 +342,58 @@ status_t uart_drv_t::enable_rx_dma()
         }
         return PYRO_ERROR;
     }
-    __HAL_DMA_DISABLE_IT(_huart->hdmarx, DMA_IT_HT);
+    if (state.rx_circular)
+    {
+        _ring.reset();
+        _frame_start = 0;
+    }
+    else
+    {
+        __HAL_DMA_DISABLE_IT(_huart->hdmarx, DMA_IT_HT);
+    }
     state.rx_dma_enable = 1;
     state.rx_error      = 0;
     state.rx_busy       = 0;
     return PYRO_OK;
 }
 
+/**
+ * @brief Switches reception to a circular DMA ring.
+ *
+ * The ring is allocated once from the DMA heap and the RX stream is
+ * re-initialized in circular mode, so reception never has to be re-armed
+ * from the ISR. Double-buffer callbacks keep working: they are called on
+ * every IDLE event with the bytes received since the previous one.
+ */
+status_t uart_drv_t::enable_rx_circular(const uint16_t ring_size)
+{
+    if (!state.init_flag || nullptr == _huart->hdmarx || 0 == ring_size)
+    {
+        return PYRO_PARAM_ERROR;
+    }
+    if (!_rx_ring)
+    {
+        if (!_rx_ring.allocate(ring_size))
+        {
+            return PYRO_NO_MEMORY;
+        }
+        _ring.attach(_rx_ring.data(), ring_size);
+    }
+    else if (ring_size != _ring.size())
+    {
+        return PYRO_PARAM_ERROR;
+    }
+
+    HAL_UART_AbortReceive(_huart);
+    _huart->hdmarx->Init.Mode = DMA_CIRCULAR;
+    if (HAL_OK != HAL_DMA_Init(_huart->hdmarx))
+    {
+        return PYRO_ERROR;
+    }
+    state.rx_circular = 1;
+    return enable_rx_dma();
+}
+
 /**
  * @brief Aborts the ongoing DMA reception.
  */
@@ -235,14 +442,22 @@ status_t uart_drv_t::reset(const uint32_t BaudRate, const uint32_t WordLength,
 /* Custom RX Event Callback Management ---------------------------------------*/
 /**
  * @brief Registers a custom C++ RX event callback with an owner ID.
+ * @return PYRO_NO_MEMORY if all callback slots are in use.
  */
-void uart_drv_t::add_rx_event_callback(const rx_event_func &func,
-                                       const uint32_t owner)
+status_t uart_drv_t::add_rx_event_callback(const rx_event_func &func,
+                                           const uint32_t owner)
 {
-    rx_event_callback_t callback;
-    callback.owner = owner;
-    callback.func  = func;
-    rx_event_callbacks.push_back(callback);
+    status_t status = PYRO_NO_MEMORY;
+    taskENTER_CRITICAL();
+    if (_rx_callback_num < MAX_RX_CALLBACK_NUM)
+    {
+        _rx_callbacks[_rx_callback_num].owner = owner;
+        _rx_callbacks[_rx_callback_num].func  = func;
+        _rx_callback_num++;
+        status = PYRO_OK;
+    }
+    taskEXIT_CRITICAL();
+    return status;
 }
 
 /**
@@ -250,16 +465,140 @@ void uart_drv_t::add_rx_event_callback(const rx_event_func &func,
  */
 status_t uart_drv_t::remove_rx_event_callback(const uint32_t owner)
 {
-    for (auto it = rx_event_callbacks.begin(); it != rx_event_callbacks.end();
-         ++it)
+    status_t status = PYRO_NOT_FOUND;
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < _rx_callback_num; i++)
+    {
+        if (_rx_callbacks[i].owner == owner)
+        {
+            for (uint8_t j = i; j + 1 < _rx_callback_num; j++)
+            {
+                _rx_callbacks[j] = _rx_callbacks[j + 1];
+            }
+            _rx_callback_num--;
+            status = PYRO_OK;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return status;
+}
+
+/**
+ * @brief Registers a zero-copy RX span callback with an owner ID.
+ * @return PYRO_NO_MEMORY if all callback slots are in use.
+ */
+status_t uart_drv_t::add_rx_span_callback(const rx_span_func &func,
+                                          const uint32_t owner)
+{
+    status_t status = PYRO_NO_MEMORY;
+    taskENTER_CRITICAL();
+    if (_rx_span_callback_num < MAX_RX_CALLBACK_NUM)
     {
-        if (it->owner == owner)
+        _rx_span_callbacks[_rx_span_callback_num].owner = owner;
+        _rx_span_callbacks[_rx_span_callback_num].func  = func;
+        _rx_span_callback_num++;
+        status = PYRO_OK;
+    }
+    taskEXIT_CRITICAL();
+    return status;
+}
+
+/**
+ * @brief Removes an RX span callback based on the owner ID.
+ */
+status_t uart_drv_t::remove_rx_span_callback(const uint32_t owner)
+{
+    status_t status = PYRO_NOT_FOUND;
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < _rx_span_callback_num; i++)
+    {
+        if (_rx_span_callbacks[i].owner == owner)
         {
-            rx_event_callbacks.erase(it);
-            return PYRO_OK;
+            for (uint8_t j = i; j + 1 < _rx_span_callback_num; j++)
+            {
+                _rx_span_callbacks[j] = _rx_span_callbacks[j + 1];
+            }
+            _rx_span_callback_num--;
+            status = PYRO_OK;
+            break;
         }
     }
-    return PYRO_NOT_FOUND;
+    taskEXIT_CRITICAL();
+    return status;
+}
+
+/**
+ * @brief Offers the active RX buffer to the registered callbacks in order.
+ *
+ * The first callback that consumes the data switches the double buffer.
+ * Runs at most MAX_RX_CALLBACK_NUM calls, then restarts DMA reception.
+ * In circular mode the event is forwarded to handle_rx_ring_event().
+ */
+void uart_drv_t::handle_rx_event(const uint16_t size, BaseType_t &woken)
+{
+    if (state.rx_circular)
+    {
+        handle_rx_ring_event(size, woken);
+        return;
+    }
+    _rx_mem[rx_buf_switch].invalidate(0, size);
+    for (uint8_t i = 0; i < _rx_callback_num; i++)
+    {
+        if (_rx_callbacks[i].func(rx_buf[rx_buf_switch], size, woken))
+        {
+            rx_buf_switch ^= 0x01U;
+            break;
+        }
+    }
+    enable_rx_dma();
+}
+
+/**
+ * @brief Publishes a circular DMA write position (HT, TC or IDLE).
+ *
+ * Span callbacks see every new byte in place. Double-buffer callbacks only
+ * run on IDLE and get the bytes since the previous IDLE, in pieces of at
+ * most one RX buffer (back-to-back frames on a shared line can exceed it);
+ * a piece that wraps the ring end is first gathered into the active RX
+ * buffer. DMA keeps running, so nothing is restarted here.
+ */
+void uart_drv_t::handle_rx_ring_event(const uint16_t head, BaseType_t &woken)
+{
+    const uart_rx_span_t fresh = _ring.publish(head);
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        _rx_ring.invalidate(fresh.data[i] - _rx_ring.data(), fresh.size[i]);
+    }
+    if (fresh.total())
+    {
+        for (uint8_t i = 0; i < _rx_span_callback_num; i++)
+        {
+            _rx_span_callbacks[i].func(fresh, woken);
+        }
+    }
+
+    if (HAL_UART_RXEVENT_IDLE != _huart->RxEventType)
+    {
+        return;
+    }
+    const uart_rx_span_t frame = _ring.span(_frame_start, _ring.tail());
+    _frame_start               = _ring.tail();
+    for (uint16_t offset = 0; offset < frame.total();)
+    {
+        // In place where possible, a wrapping piece goes via the RX buffer
+        const uint8_t *p = nullptr;
+        const uint16_t n =
+            frame.chunk(offset, _rx_buf_size, rx_buf[rx_buf_switch], p);
+        for (uint8_t i = 0; i < _rx_callback_num; i++)
+        {
+            if (_rx_callbacks[i].func(const_cast<uint8_t *>(p), n, woken))
+            {
+                break;
+            }
+        }
+        offset += n;
+    }
 }
 
 /* HAL Callback Registration -------------------------------------------------*/
@@ -321,52 +660,53 @@ uart_drv_t::unregister_callback(const HAL_UART_CallbackIDTypeDef CB_ID) const
 /**
  * @brief HAL Extended RX Event Callback (triggered by DMA IDLE detection).
  *
- * This ISR-context function looks up the C++ driver instance and executes
- * registered C++ callbacks. If a callback consumes the data, the RX buffer
+ * This ISR-context function looks up the C++ driver instance in the static
+ * table and executes its registered C++ callbacks. If a callback consumes the data, the RX buffer
  * is switched and DMA reception is restarted. A FreeRTOS yield is performed
  * if a higher-priority task was woken.
  */
 extern "C" void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart,
                                            uint16_t Size)
 {
-    const auto it = pyro::uart_drv_t::uart_map().find(huart);
-    static BaseType_t xHigherPriorityTaskWoken;
-    if (it != pyro::uart_drv_t::uart_map().end() && it->second)
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    pyro::uart_drv_t *drv               = pyro::uart_drv_t::find(huart);
+    if (drv)
     {
-        const auto drv = it->second;
-        for (auto &cb : drv->rx_event_callbacks)
-        {
-            if (cb.func(drv->rx_buf[drv->rx_buf_switch], Size,
-                        xHigherPriorityTaskWoken))
-            {
-                drv->rx_buf_switch ^= 0x01U;
-                break;
-            }
-        }
-        drv->enable_rx_dma();
+        drv->handle_rx_event(Size, xHigherPriorityTaskWoken);
     }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
 
-    if (xHigherPriorityTaskWoken)
+/**
+ * @brief HAL UART TX Complete Callback: chains the next queued segment.
+ */
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    pyro::uart_drv_t *drv               = pyro::uart_drv_t::find(huart);
+    if (drv)
     {
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        drv->handle_tx_complete(xHigherPriorityTaskWoken);
     }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 /**
  * @brief HAL UART Error Callback.
  *
  * This ISR-context function clears all pending error flags (Parity, Framing,
- * Overrun, etc.) and restarts DMA reception to recover the peripheral.
+ * Overrun, etc.), restarts DMA reception and resumes an aborted TX queue
+ * to recover the peripheral.
  */
 extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
-    const auto it = pyro::uart_drv_t::uart_map().find(huart);
-    if (it != pyro::uart_drv_t::uart_map().end() && it->second)
+    pyro::uart_drv_t *drv = pyro::uart_drv_t::find(huart);
+    if (drv)
     {
-        const auto drv = it->second;
         __HAL_UART_CLEAR_FLAG(huart, UART_CLEAR_PEF | UART_CLEAR_FEF |
                                          UART_CLEAR_NEF | UART_CLEAR_OREF |
                                          UART_CLEAR_RTOF);
         drv->enable_rx_dma();
+        drv->handle_tx_error();
     }
 }
\ No newline at end of file
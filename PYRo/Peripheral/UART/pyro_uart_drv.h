@@ -23,9 +23,12 @@
 
 #include "FreeRTOS.h"
 
-#include "functional"
-#include "map"
-#include "vector"
+#include "delegate.h"
+#include "pyro_dma_buffer.h"
+#include "pyro_uart_ring.h"
+#include "pyro_uart_tx_queue.h"
+
+#include <array>
 
 namespace pyro
 {
@@ -36,22 +39,60 @@ class uart_drv_t;
  * @brief C++ class to encapsulate the STM32 HAL UART driver functionality.
  *
  * It manages double-buffering for DMA reception, integrates with FreeRTOS
- * for yielding from ISRs, and uses a static map to dispatch HAL callbacks
- * to the correct C++ instance.
+ * for yielding from ISRs, and uses a fixed instance table indexed by UART
+ * number to dispatch HAL callbacks to the correct C++ instance.
  *
  * This class uses a Singleton pattern via `get_instance()` for access.
  */
 class uart_drv_t
 {
 
-    /* Private Types ---------------------------------------------------------*/
+  public:
+    /* Public Types ----------------------------------------------------------*/
     /**
-     * @brief Type alias for the RX event callback signature (for ISR context).
+     * @brief RX event callback (ISR context). Set `woken` to pdTRUE if a
+     * higher-priority task was unblocked.
      * @return true if the data was consumed and the RX buffer should switch.
      */
-    using rx_event_func = std::function<bool(
-        uint8_t *p, uint16_t size, BaseType_t xHigherPriorityTaskWoken)>;
+    using rx_event_func =
+        delegate_t<bool(uint8_t *p, uint16_t size, BaseType_t &woken)>;
+
+    /**
+     * @brief RX span callback (ISR context, circular mode only). The span
+     * points into the DMA ring and is valid until the callback returns.
+     */
+    using rx_span_func =
+        delegate_t<void(const uart_rx_span_t &span, BaseType_t &woken)>;
 
+    /**
+     * @brief TX frame completion callback (ISR context).
+     */
+    using tx_done_func = delegate_t<void(BaseType_t &woken)>;
+
+    /**
+     * @brief Maximum number of RX callbacks per UART.
+     */
+    static constexpr uint8_t MAX_RX_CALLBACK_NUM = 4;
+    /**
+     * @brief Frames that may wait for the TX DMA, and segments per frame.
+     */
+    static constexpr size_t TX_QUEUE_DEPTH = 8;
+    static constexpr size_t TX_MAX_SEG_NUM = 4;
+
+    /**
+     * @brief TX counters; throughput covers the last full one-second window.
+     */
+    typedef struct tx_stats_t
+    {
+        uint32_t frames_sent;
+        uint32_t bytes_sent;
+        uint32_t queue_full;
+        uint32_t queue_high_water;
+        uint32_t bytes_per_sec;
+    } tx_stats_t;
+
+  private:
+    /* Private Types ---------------------------------------------------------*/
     /**
      * @brief Structure to store registered RX callbacks with an owner ID.
      */
@@ -61,6 +102,18 @@ class uart_drv_t
         rx_event_func func;
     } rx_event_callback_t;
 
+    /**
+     * @brief Structure to store registered RX span callbacks with an owner ID.
+     */
+    typedef struct rx_span_callback_t
+    {
+        uint32_t owner;
+        rx_span_func func;
+    } rx_span_callback_t;
+
+    using tx_queue_t =
+        uart_tx_queue_t<tx_done_func, TX_QUEUE_DEPTH, TX_MAX_SEG_NUM>;
+
     /**
      * @brief Internal state flags (bit-field) for tracking driver status.
      */
@@ -72,6 +125,7 @@ class uart_drv_t
         volatile uint8_t rx_dma_enable : 1;
         volatile uint8_t rx_busy       : 1;
         volatile uint8_t rx_error      : 1;
+        volatile uint8_t rx_circular   : 1;
     } state_t;
 
   public:
@@ -84,6 +138,7 @@ class uart_drv_t
         uart5,
         uart7,
         uart10,
+        uart_num
     };
 
     /* Public Methods - Initialization and De-initialization
@@ -117,6 +172,15 @@ class uart_drv_t
      * @brief Non-blocking (DMA) write.
      */
     status_t write(const uint8_t *p, uint16_t size); // DMA
+    /**
+     * @brief Queues a scatter-gather frame for DMA transmission.
+     */
+    status_t write_frame(const uart_tx_seg_t *segs, uint8_t seg_num,
+                         const tx_done_func &done = tx_done_func());
+    /**
+     * @brief Snapshot of the TX counters.
+     */
+    tx_stats_t get_tx_stats() const;
 
     /* Public Methods - Reception Control
      * --------------------------------------*/
@@ -124,6 +188,10 @@ class uart_drv_t
      * @brief Starts DMA reception (ReceiveToIdle).
      */
     status_t enable_rx_dma();
+    /**
+     * @brief Switches reception to a circular DMA ring of `ring_size` bytes.
+     */
+    status_t enable_rx_circular(uint16_t ring_size);
     /**
      * @brief Aborts DMA reception.
      */
@@ -134,11 +202,19 @@ class uart_drv_t
     /**
      * @brief Adds a C++ RX event callback.
      */
-    void add_rx_event_callback(const rx_event_func &func, uint32_t owner);
+    status_t add_rx_event_callback(const rx_event_func &func, uint32_t owner);
     /**
      * @brief Removes a C++ RX event callback by its owner ID.
      */
     status_t remove_rx_event_callback(uint32_t);
+    /**
+     * @brief Adds a zero-copy RX span callback (circular mode).
+     */
+    status_t add_rx_span_callback(const rx_span_func &func, uint32_t owner);
+    /**
+     * @brief Removes an RX span callback by its owner ID.
+     */
+    status_t remove_rx_span_callback(uint32_t owner);
 
     /* Public Methods - HAL Callback Registration
      * ------------------------------*/
@@ -163,14 +239,27 @@ class uart_drv_t
     /* Public Methods - Static Access
      * ----------------------------------------*/
     /**
-     * @brief Provides access to the static map linking HAL handles to
-     * instances.
+     * @brief Looks up the driver instance owning a HAL handle.
      */
-    static std::map<UART_HandleTypeDef *, uart_drv_t *> &uart_map();
+    static uart_drv_t *find(const UART_HandleTypeDef *huart);
+
+    /* Public Methods - ISR Dispatch
+     * -------------------------------------------*/
+    /**
+     * @brief Runs the RX callbacks for a completed reception (ISR context).
+     */
+    void handle_rx_event(uint16_t size, BaseType_t &woken);
+    /**
+     * @brief Starts the next queued TX segment (ISR context).
+     */
+    void handle_tx_complete(BaseType_t &woken);
+    /**
+     * @brief Restarts a queued segment aborted by a TX error (ISR context).
+     */
+    void handle_tx_error();
 
     /* Public Members - State/Data
      * ------------------------------------*/
-    std::vector<rx_event_callback_t> rx_event_callbacks;
     uint8_t *rx_buf[2];      // Double buffers for DMA reception
     uint8_t rx_buf_switch{}; // Index of the currently active buffer
     state_t state{};
@@ -179,8 +268,27 @@ class uart_drv_t
   private:
     /* Private Members
      * ---------------------------------------------------------*/
+    static int8_t which_of(const UART_HandleTypeDef *huart);
+    void handle_rx_ring_event(uint16_t head, BaseType_t &woken);
+    bool start_tx(const uart_tx_seg_t *seg);
+
     UART_HandleTypeDef *_huart; // HAL handle for the peripheral
     uint16_t _rx_buf_size{};    // Size of each RX buffer
+    std::array<rx_event_callback_t, MAX_RX_CALLBACK_NUM> _rx_callbacks{};
+    uint8_t _rx_callback_num{};
+    std::array<rx_span_callback_t, MAX_RX_CALLBACK_NUM> _rx_span_callbacks{};
+    uint8_t _rx_span_callback_num{};
+    dma_buffer_t _rx_mem[2]; // Cache-line aligned storage of rx_buf
+    dma_buffer_t _rx_ring;   // Circular DMA ring (circular mode)
+    uart_rx_ring_t _ring;    // Index bookkeeping of _rx_ring
+    uint16_t _frame_start{}; // Ring position of the last IDLE event
+    tx_queue_t _tx_queue;
+    volatile bool _tx_active{}; // A queued segment is on the wire
+    tx_stats_t _tx_stats{};
+    uint32_t _tx_window_start{}; // Tick of the current throughput window
+    uint32_t _tx_window_bytes{};
+
+    static std::array<uart_drv_t *, uart_num> _instances;
 };
 
 } // namespace pyro
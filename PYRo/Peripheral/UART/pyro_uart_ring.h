@@ -0,0 +1,184 @@
+/**
+ * @file pyro_uart_ring.h
+ * @brief Zero-copy view of a circular DMA receive buffer.
+ *
+ * The DMA writes the ring continuously; every IDLE/HT/TC event reports the
+ * write position. `uart_rx_ring_t` turns consecutive positions into spans of
+ * newly received bytes that point straight into the ring, split in two
+ * parts when the new data wraps around the end. The class only does index
+ * arithmetic, so a simulated DMA producer can drive it on a host.
+ *
+ * @author Lucky
+ * @version 1.0.0
+ * @date 2025-10-09
+ */
+
+#ifndef __PYRO_UART_RING_H__
+#define __PYRO_UART_RING_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/**
+ * @brief Newly received bytes, as up to two contiguous pieces of the ring.
+ */
+struct uart_rx_span_t
+{
+    const uint8_t *data[2];
+    uint16_t size[2];
+
+    uint16_t total() const
+    {
+        return size[0] + size[1];
+    }
+
+    /**
+     * @brief Byte `i` of the span, 0 <= i < total().
+     */
+    uint8_t operator[](const uint16_t i) const
+    {
+        return i < size[0] ? data[0][i] : data[1][i - size[0]];
+    }
+
+    /**
+     * @brief Copies up to `max` bytes starting at `offset` into `dst`.
+     * @return number of bytes copied.
+     */
+    uint16_t copy(uint8_t *dst, uint16_t offset, uint16_t max) const
+    {
+        uint16_t n = 0;
+        for (; n < max && offset + n < total(); n++)
+        {
+            dst[n] = (*this)[offset + n];
+        }
+        return n;
+    }
+
+    /**
+     * @brief Up to `max` bytes from `offset` as one contiguous block: in place
+     *        when they lie in one piece, else gathered into `scratch`.
+     * @param out set to the first byte of the block.
+     * @return number of bytes in the block, 0 past the end.
+     */
+    uint16_t chunk(const uint16_t offset, const uint16_t max, uint8_t *scratch,
+                   const uint8_t *&out) const
+    {
+        const uint16_t left = offset < total() ? total() - offset : 0;
+        const uint16_t n    = left < max ? left : max;
+        if (offset + n <= size[0])
+        {
+            out = data[0] + offset;
+        }
+        else if (offset >= size[0])
+        {
+            out = data[1] + (offset - size[0]);
+        }
+        else
+        {
+            out = scratch;
+            copy(scratch, offset, n);
+        }
+        return n;
+    }
+};
+
+class uart_rx_ring_t
+{
+  public:
+    uart_rx_ring_t() : _buf(nullptr), _size(0), _tail(0), _total(0)
+    {
+    }
+
+    void attach(const uint8_t *buf, const uint16_t size)
+    {
+        _buf  = buf;
+        _size = size;
+        reset();
+    }
+
+    void reset()
+    {
+        _tail = 0;
+    }
+
+    bool attached() const
+    {
+        return nullptr != _buf && 0 != _size;
+    }
+
+    uint16_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Bytes between two ring positions, wrapping if `to` < `from`.
+     */
+    uart_rx_span_t span(const uint16_t from, const uint16_t to) const
+    {
+        uart_rx_span_t span{{_buf, _buf}, {0, 0}};
+        if (!attached() || from == to)
+            return span;
+        span.data[0] = _buf + from;
+        if (to > from)
+        {
+            span.size[0] = to - from;
+        }
+        else
+        {
+            span.size[0] = _size - from;
+            span.size[1] = to;
+        }
+        return span;
+    }
+
+    /**
+     * @brief Publishes the DMA write position and returns the bytes written
+     *        since the previous call.
+     *
+     * A full lap between two calls cannot be told from no data at all; HT
+     * and TC events keep the gap at half a ring. `head` == `size` (TC) is
+     * taken as the ring end, so a ring filled from 0 is published whole.
+     *
+     * @param head write position in [0, size]; `size` means the DMA wrapped.
+     */
+    uart_rx_span_t publish(const uint16_t head)
+    {
+        const uart_rx_span_t fresh = span(_tail, head < _size ? head : _size);
+        _tail                      = wrap(head);
+        _total += fresh.total();
+        return fresh;
+    }
+
+    /**
+     * @brief Current read position, i.e. the last published head.
+     */
+    uint16_t tail() const
+    {
+        return _tail;
+    }
+
+    uint16_t wrap(const uint16_t pos) const
+    {
+        return pos >= _size ? 0 : pos;
+    }
+
+    /**
+     * @brief Total number of bytes published since power-up.
+     */
+    uint32_t total() const
+    {
+        return _total;
+    }
+
+  private:
+    const uint8_t *_buf;
+    uint16_t _size;
+    uint16_t _tail;
+    uint32_t _total;
+};
+} // namespace pyro
+
+#endif // __PYRO_UART_RING_H__
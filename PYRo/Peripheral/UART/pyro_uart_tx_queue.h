@@ -0,0 +1,124 @@
+/**
+ * @file pyro_uart_tx_queue.h
+ * @brief Fixed-capacity queue of scatter-gather UART TX frames.
+ *
+ * A frame is a short list of segments (e.g. header + payload + CRC) that are
+ * sent back-to-back straight from the caller's memory. The queue only keeps
+ * descriptors and a cursor to the segment on the wire; it neither locks nor
+ * touches the HAL, so a host can drive it with a simulated TX-complete.
+ *
+ * @author Lucky
+ * @version 1.0.0
+ * @date 2025-10-09
+ */
+
+#ifndef __PYRO_UART_TX_QUEUE_H__
+#define __PYRO_UART_TX_QUEUE_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro
+{
+/**
+ * @brief One contiguous piece of a TX frame.
+ */
+struct uart_tx_seg_t
+{
+    const uint8_t *data;
+    uint16_t size;
+};
+
+template <typename DONE, size_t DEPTH, size_t MAX_SEG> class uart_tx_queue_t
+{
+    static_assert(DEPTH > 0 && MAX_SEG > 0, "empty uart_tx_queue_t");
+
+  public:
+    /**
+     * @brief Frame descriptor; `done` runs once the last segment is sent.
+     */
+    struct frame_t
+    {
+        std::array<uart_tx_seg_t, MAX_SEG> segs;
+        uint8_t seg_num;
+        DONE done;
+    };
+
+    uart_tx_queue_t() : _frames(), _head(0), _count(0), _seg(0)
+    {
+    }
+
+    /**
+     * @brief Copies `seg_num` descriptors in; empty segments are dropped.
+     * @return false if the queue is full or the frame has no payload.
+     */
+    bool push(const uart_tx_seg_t *segs, const size_t seg_num,
+              const DONE &done)
+    {
+        if (_count >= DEPTH || seg_num > MAX_SEG)
+            return false;
+        frame_t &frame = _frames[(_head + _count) % DEPTH];
+        frame.seg_num  = 0;
+        for (size_t i = 0; i < seg_num; i++)
+        {
+            if (segs[i].data && segs[i].size)
+            {
+                frame.segs[frame.seg_num++] = segs[i];
+            }
+        }
+        if (0 == frame.seg_num)
+            return false;
+        frame.done = done;
+        _count++;
+        return true;
+    }
+
+    /**
+     * @brief Segment to put on the wire now, nullptr if the queue is empty.
+     */
+    const uart_tx_seg_t *current() const
+    {
+        return _count ? &_frames[_head].segs[_seg] : nullptr;
+    }
+
+    /**
+     * @brief Retires the current segment.
+     * @param finished set to the completed frame when its last segment is
+     *        retired, nullptr otherwise. Valid until the next push.
+     * @return the next segment to send, nullptr if the queue ran empty.
+     */
+    const uart_tx_seg_t *advance(const frame_t *&finished)
+    {
+        finished = nullptr;
+        if (0 == _count)
+            return nullptr;
+        if (++_seg >= _frames[_head].seg_num)
+        {
+            finished = &_frames[_head];
+            _head    = (_head + 1) % DEPTH;
+            _seg     = 0;
+            _count--;
+        }
+        return current();
+    }
+
+    size_t size() const
+    {
+        return _count;
+    }
+
+    bool empty() const
+    {
+        return 0 == _count;
+    }
+
+  private:
+    std::array<frame_t, DEPTH> _frames;
+    size_t _head;
+    size_t _count;
+    uint8_t _seg;
+};
+}; // namespace pyro
+
+#endif
@@ -0,0 +1,87 @@
+#include "pyro_can_dlc.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+// ISO 11898-1 DLC table; on the H7 the FDCAN_DLC_BYTES_x codes are these
+// same values
+constexpr size_t DLC_LEN[16] = {0, 1,  2,  3,  4,  5,  6,  7,
+                                8, 12, 16, 20, 24, 32, 48, 64};
+} // namespace
+
+TEST(can_dlc, EveryCodeToLength)
+{
+    for (uint8_t dlc = 0; dlc <= pyro::CAN_MAX_DLC; dlc++)
+    {
+        EXPECT_EQ(DLC_LEN[dlc], pyro::can_dlc_to_len(dlc)) << "dlc " << +dlc;
+    }
+}
+
+TEST(can_dlc, CodesAbove15Clamp)
+{
+    for (unsigned dlc = 16; dlc <= 0xFF; dlc++)
+    {
+        EXPECT_EQ(pyro::CAN_FD_MAX_LEN,
+                  pyro::can_dlc_to_len(static_cast<uint8_t>(dlc)));
+    }
+}
+
+// Each length maps to the smallest code whose payload holds it
+TEST(can_dlc, EveryLengthToSmallestCode)
+{
+    for (size_t len = 0; len <= pyro::CAN_FD_MAX_LEN; len++)
+    {
+        const uint8_t dlc = pyro::can_len_to_dlc(len);
+        ASSERT_LE(dlc, pyro::CAN_MAX_DLC) << "len " << len;
+        EXPECT_GE(DLC_LEN[dlc], len) << "len " << len;
+        if (dlc > 0)
+        {
+            EXPECT_LT(DLC_LEN[dlc - 1], len) << "len " << len;
+        }
+    }
+}
+
+TEST(can_dlc, ExactLengthsRoundTrip)
+{
+    for (uint8_t dlc = 0; dlc <= pyro::CAN_MAX_DLC; dlc++)
+    {
+        EXPECT_EQ(dlc, pyro::can_len_to_dlc(DLC_LEN[dlc])) << "dlc " << +dlc;
+        EXPECT_EQ(DLC_LEN[dlc], pyro::can_len_round_up(DLC_LEN[dlc]));
+    }
+}
+
+TEST(can_dlc, EveryLengthRoundsUp)
+{
+    for (size_t len = 0; len <= pyro::CAN_FD_MAX_LEN; len++)
+    {
+        size_t expected = 0;
+        for (size_t dlc = 0; DLC_LEN[dlc] < len; dlc++)
+        {
+            expected = DLC_LEN[dlc + 1];
+        }
+        const size_t up = pyro::can_len_round_up(len);
+        EXPECT_EQ(expected, up) << "len " << len;
+        // Classic lengths are never padded
+        if (len <= pyro::CAN_CLASSIC_MAX_LEN)
+        {
+            EXPECT_EQ(len, up);
+        }
+    }
+    EXPECT_EQ(12u, pyro::can_len_round_up(9));
+    EXPECT_EQ(32u, pyro::can_len_round_up(25));
+    EXPECT_EQ(48u, pyro::can_len_round_up(33));
+    EXPECT_EQ(64u, pyro::can_len_round_up(49));
+}
+
+TEST(can_dlc, LengthsAbove64Clamp)
+{
+    for (size_t len = pyro::CAN_FD_MAX_LEN + 1; len <= 1024; len++)
+    {
+        EXPECT_EQ(pyro::CAN_MAX_DLC, pyro::can_len_to_dlc(len));
+        EXPECT_EQ(pyro::CAN_FD_MAX_LEN, pyro::can_len_round_up(len));
+    }
+}
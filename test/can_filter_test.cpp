@@ -0,0 +1,173 @@
+#include "pyro_can_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+// hfdcanN.Init.StdFiltersNbr in fdcan.c
+constexpr size_t STD_FILTERS = 4;
+constexpr uint32_t STD_ID_MAX = 0x7FF;
+
+using elem_t = pyro::can_filter_elem_t;
+using plan_t = std::vector<elem_t>;
+
+plan_t plan(const std::vector<uint32_t> &ids,
+            const size_t max_elems = STD_FILTERS)
+{
+    std::array<elem_t, pyro::CAN_FILTER_MAX_IDS> out{};
+    const size_t n = pyro::can_filter_plan(
+        ids.data(), ids.size(), out.data(), std::min(max_elems, out.size()));
+    return plan_t(out.begin(), out.begin() + n);
+}
+
+// What the FDCAN filter would let through for this plan
+bool accepts(const plan_t &elems, const uint32_t id)
+{
+    for (const elem_t &e : elems)
+    {
+        if (elem_t::range == e.type ? (id >= e.id1 && id <= e.id2)
+                                    : (id == e.id1 || id == e.id2))
+            return true;
+    }
+    return false;
+}
+
+void expect_elem(const elem_t &e, const elem_t::type_t type,
+                 const uint32_t id1, const uint32_t id2)
+{
+    EXPECT_EQ(type, e.type);
+    EXPECT_EQ(id1, e.id1);
+    EXPECT_EQ(id2, e.id2);
+}
+} // namespace
+
+TEST(can_filter_plan, RejectsEmptyAndInvalidInput)
+{
+    std::array<elem_t, STD_FILTERS> out{};
+    const uint32_t id = 0x201;
+    EXPECT_EQ(0u, pyro::can_filter_plan(&id, 0, out.data(), out.size()));
+    EXPECT_EQ(0u, pyro::can_filter_plan(&id, 1, out.data(), 0));
+
+    const std::vector<uint32_t> too_many(pyro::CAN_FILTER_MAX_IDS + 1, 0x10);
+    EXPECT_EQ(0u, pyro::can_filter_plan(too_many.data(), too_many.size(),
+                                        out.data(), out.size()));
+}
+
+TEST(can_filter_plan, SingleIdIsADualWithItself)
+{
+    const plan_t p = plan({0x7FF});
+    ASSERT_EQ(1u, p.size());
+    expect_elem(p[0], elem_t::dual, 0x7FF, 0x7FF);
+}
+
+TEST(can_filter_plan, ConsecutiveRunsBecomeRanges)
+{
+    const plan_t p = plan({0x204, 0x201, 0x203, 0x202, 0x7FE, 0x7FF});
+    ASSERT_EQ(2u, p.size());
+    expect_elem(p[0], elem_t::range, 0x201, 0x204);
+    expect_elem(p[1], elem_t::range, 0x7FE, 0x7FF);
+}
+
+TEST(can_filter_plan, DuplicatesCollapse)
+{
+    const plan_t p = plan({0x205, 0x205, 0x206, 0x205});
+    ASSERT_EQ(1u, p.size());
+    expect_elem(p[0], elem_t::range, 0x205, 0x206);
+}
+
+TEST(can_filter_plan, IsolatedIdsArePairedIntoDuals)
+{
+    const plan_t p = plan({0x500, 0x100, 0x300});
+    ASSERT_EQ(2u, p.size());
+    expect_elem(p[0], elem_t::dual, 0x100, 0x300);
+    expect_elem(p[1], elem_t::dual, 0x500, 0x500);
+}
+
+TEST(can_filter_plan, SinglesPairAcrossARange)
+{
+    const plan_t p = plan({0x000, 0x201, 0x202, STD_ID_MAX});
+    ASSERT_EQ(2u, p.size());
+    expect_elem(p[0], elem_t::range, 0x201, 0x202);
+    expect_elem(p[1], elem_t::dual, 0x000, STD_ID_MAX);
+}
+
+TEST(can_filter_plan, MergesTheSmallestGapFirst)
+{
+    // Three ranges into two slots: 0x12..0x14 is the narrowest gap
+    const plan_t p = plan({0x10, 0x11, 0x12, 0x14, 0x15, 0x100, 0x101}, 2);
+    ASSERT_EQ(2u, p.size());
+    expect_elem(p[0], elem_t::range, 0x10, 0x15);
+    expect_elem(p[1], elem_t::range, 0x100, 0x101);
+}
+
+TEST(can_filter_plan, MergesDownToOneRange)
+{
+    const plan_t p = plan({0x000, 0x001, 0x400, STD_ID_MAX}, 1);
+    ASSERT_EQ(1u, p.size());
+    expect_elem(p[0], elem_t::range, 0x000, STD_ID_MAX);
+}
+
+TEST(can_filter_plan, DjiFeedbackIdsFitTheFilterBank)
+{
+    // 0x201..0x20B feedback plus a DM motor and the power meter
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0x201; id <= 0x20B; id++)
+    {
+        ids.push_back(id);
+    }
+    ids.push_back(0x004);
+    ids.push_back(0x211);
+    const plan_t p = plan(ids);
+    ASSERT_EQ(2u, p.size());
+    expect_elem(p[0], elem_t::range, 0x201, 0x20B);
+    expect_elem(p[1], elem_t::dual, 0x004, 0x211);
+}
+
+TEST(can_filter_plan, RandomSetsFitAndAcceptEveryId)
+{
+    std::mt19937 rng(0x5EED);
+    for (int round = 0; round < 2000; round++)
+    {
+        const size_t count     = 1 + rng() % 32;
+        const size_t max_elems = 1 + rng() % STD_FILTERS;
+        // narrow windows give runs and duplicates, the full range gives gaps
+        const uint32_t span = round % 2 ? STD_ID_MAX + 1 : 48;
+        const uint32_t base = rng() % (STD_ID_MAX + 2 - span);
+
+        std::vector<uint32_t> ids(count);
+        for (uint32_t &id : ids)
+        {
+            id = base + rng() % span;
+        }
+
+        const plan_t p = plan(ids, max_elems);
+        ASSERT_GE(p.size(), 1u);
+        ASSERT_LE(p.size(), max_elems);
+        for (const uint32_t id : ids)
+        {
+            ASSERT_TRUE(accepts(p, id)) << "round " << round << " id " << id;
+        }
+        for (const elem_t &e : p)
+        {
+            ASSERT_LE(e.id1, e.id2);
+            ASSERT_LE(e.id2, STD_ID_MAX);
+        }
+
+        // With enough slots nothing unregistered gets through
+        const std::set<uint32_t> registered(ids.begin(), ids.end());
+        if (plan(ids, pyro::CAN_FILTER_MAX_IDS).size() <= max_elems)
+        {
+            for (uint32_t id = 0; id <= STD_ID_MAX; id++)
+            {
+                ASSERT_EQ(registered.count(id) != 0, accepts(p, id)) << id;
+            }
+        }
+    }
+}
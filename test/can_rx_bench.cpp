@@ -0,0 +1,137 @@
+// CAN RX dispatch: id_table_t against the map_t lookup it replaced.
+//
+// Replays one recorded-like frame trace through both lookups for a growing
+// number of registered standard IDs. Most frames carry a registered ID; a
+// share do not, as the range filters let some neighbours through. Reports
+// ns per frame over the whole trace.
+//
+//   can_rx_bench [frames]
+
+#include "can_rx_map_ref.h"
+#include "id_table.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+// can_drv_t::MAX_ID_REGIST_NUM and RX_TABLE_SLOTS
+constexpr size_t MAX_IDS    = 32;
+constexpr size_t SLOTS      = 128;
+constexpr uint32_t MISS_PCT = 10;
+
+struct buffer_t
+{
+    uint32_t id;
+};
+
+// DJI feedback IDs first, then random standard IDs
+std::vector<uint32_t> registered_ids(std::mt19937 &rng, const size_t count)
+{
+    std::vector<uint32_t> ids;
+    std::set<uint32_t> seen;
+    for (uint32_t id = 0x201; id <= 0x20B && ids.size() < count; id++)
+    {
+        ids.push_back(id);
+        seen.insert(id);
+    }
+    while (ids.size() < count)
+    {
+        const uint32_t id = rng() & 0x7FF;
+        if (seen.insert(id).second)
+        {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+std::vector<uint32_t> make_trace(std::mt19937 &rng,
+                                 const std::vector<uint32_t> &ids,
+                                 const size_t frames)
+{
+    const std::set<uint32_t> seen(ids.begin(), ids.end());
+    std::vector<uint32_t> trace(frames);
+    for (uint32_t &id : trace)
+    {
+        if (rng() % 100 < MISS_PCT)
+        {
+            do
+            {
+                id = rng() & 0x7FF;
+            } while (seen.count(id));
+        }
+        else
+        {
+            id = ids[rng() % ids.size()];
+        }
+    }
+    return trace;
+}
+
+template <typename F>
+double ns_per_frame(const std::vector<uint32_t> &trace, F &&lookup)
+{
+    size_t hits   = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (const uint32_t id : trace)
+    {
+        const buffer_t *buf = lookup(id);
+        hits += nullptr != buf && buf->id == id;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    // Keeps the loop from being optimised away
+    if (hits > trace.size())
+    {
+        std::printf("?\n");
+    }
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() /
+           static_cast<double>(trace.size());
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t frames =
+        argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000;
+    std::mt19937 rng(1);
+
+    std::printf("%zu frames, %u%% unregistered (ns per frame)\n", frames,
+                MISS_PCT);
+    for (const size_t count : {size_t{4}, size_t{8}, size_t{16}, MAX_IDS})
+    {
+        const std::vector<uint32_t> ids = registered_ids(rng, count);
+        std::vector<buffer_t> buffers(count);
+        std::vector<const buffer_t *> values(count);
+        can_rx_map_ref_t<const buffer_t *, MAX_IDS> map;
+        for (size_t i = 0; i < count; i++)
+        {
+            buffers[i].id = ids[i];
+            values[i]     = &buffers[i];
+            map.insert(ids[i], &buffers[i]);
+        }
+
+        pyro::id_table_t<const buffer_t *, SLOTS> table;
+        uint32_t seed = 0;
+        if (!table.plan(ids.data(), count, seed))
+        {
+            std::printf("  %2zu ids: no seed found\n", count);
+            return 1;
+        }
+        table.commit(seed, ids.data(), values.data(), count);
+
+        const std::vector<uint32_t> trace = make_trace(rng, ids, frames);
+        const double map_ns =
+            ns_per_frame(trace, [&](uint32_t id) { return map.lookup(id); });
+        const double table_ns =
+            ns_per_frame(trace, [&](uint32_t id) { return table.find(id); });
+        std::printf("  %2zu ids: map_t %6.2f | id_table_t %6.2f\n", count,
+                    map_ns, table_ns);
+    }
+    return 0;
+}
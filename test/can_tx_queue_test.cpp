@@ -0,0 +1,280 @@
+#include "pyro_can_tx_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace
+{
+// can_drv_t: TX_QUEUE_DEPTH and the control/normal/telemetry levels
+constexpr size_t DEPTH  = 16;
+constexpr size_t LEVELS = 3;
+
+struct frame_t
+{
+    uint32_t id;
+    uint32_t stamp;
+};
+
+using queue_t = pyro::can_tx_queue_t<frame_t, DEPTH, LEVELS>;
+
+// The FDCAN side: a hardware TX FIFO of `slots` elements that the bus
+// empties one frame per tx_complete(), and a virtual tick counter
+struct fake_port_t
+{
+    size_t slots        = 3;
+    uint32_t ticks      = 1000;
+    bool fail_writes    = false;
+    std::deque<frame_t> fifo;
+    std::vector<uint32_t> on_bus;
+
+    bool has_room() const
+    {
+        return fifo.size() < slots;
+    }
+
+    bool write(const frame_t &frame)
+    {
+        if (fail_writes)
+            return false;
+        fifo.push_back(frame);
+        return true;
+    }
+
+    uint32_t now() const
+    {
+        return ticks;
+    }
+
+    void tx_complete(queue_t &queue)
+    {
+        on_bus.push_back(fifo.front().id);
+        fifo.pop_front();
+        queue.refill(*this);
+    }
+};
+
+struct can_tx_queue_fixture_t : ::testing::Test
+{
+    queue_t queue;
+    fake_port_t port;
+
+    pyro::status_t send(const uint32_t id, const size_t level)
+    {
+        frame_t frame{id, 0};
+        return queue.send(port, level, frame);
+    }
+
+    void drain_bus()
+    {
+        while (!port.fifo.empty())
+        {
+            port.tx_complete(queue);
+        }
+    }
+};
+} // namespace
+
+TEST(can_tx_queue_t, PopsTheMostUrgentLevelFirstAndKeepsOrder)
+{
+    queue_t q;
+    ASSERT_TRUE(q.push(2, {20, 0}));
+    ASSERT_TRUE(q.push(1, {10, 0}));
+    ASSERT_TRUE(q.push(2, {21, 0}));
+    ASSERT_TRUE(q.push(0, {0, 0}));
+    ASSERT_TRUE(q.push(1, {11, 0}));
+    EXPECT_EQ(5u, q.size());
+    EXPECT_EQ(2u, q.size(2));
+
+    std::vector<uint32_t> order;
+    frame_t f;
+    while (q.pop(f))
+    {
+        order.push_back(f.id);
+    }
+    EXPECT_EQ(std::vector<uint32_t>({0, 10, 11, 20, 21}), order);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(can_tx_queue_t, FullLevelRejectsWithoutTouchingOthers)
+{
+    queue_t q;
+    for (uint32_t i = 0; i < DEPTH; i++)
+    {
+        ASSERT_TRUE(q.push(1, {i, 0}));
+    }
+    EXPECT_FALSE(q.push(1, {99, 0}));
+    EXPECT_FALSE(q.push(LEVELS, {99, 0}));
+    EXPECT_TRUE(q.push(0, {100, 0}));
+    EXPECT_EQ(0u, q.size(LEVELS));
+
+    // The ring wraps: pop one, push one, order is kept
+    frame_t f;
+    ASSERT_TRUE(q.pop(f));
+    EXPECT_EQ(100u, f.id);
+    ASSERT_TRUE(q.pop(f));
+    EXPECT_EQ(0u, f.id);
+    ASSERT_TRUE(q.push(1, {16, 0}));
+    for (uint32_t i = 1; i <= DEPTH; i++)
+    {
+        ASSERT_TRUE(q.pop(f));
+        EXPECT_EQ(i, f.id);
+    }
+}
+
+TEST_F(can_tx_queue_fixture_t, WritesDirectlyWhileTheFifoHasRoom)
+{
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(pyro::PYRO_OK, send(i, 2));
+    }
+    EXPECT_EQ(3u, port.fifo.size());
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(3u, queue.stats().direct_count);
+    EXPECT_EQ(0u, queue.stats().queued_count);
+}
+
+TEST_F(can_tx_queue_fixture_t, QueuedFramesOvertakeByPriorityOnTxComplete)
+{
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        send(i, 2);
+    }
+    send(30, 2);
+    send(31, 2);
+    send(10, 1);
+    send(1000, 0);
+    EXPECT_EQ(4u, queue.size());
+    EXPECT_EQ(4u, queue.stats().queued_count);
+
+    drain_bus();
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 1000, 10, 30, 31}), port.on_bus);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(can_tx_queue_fixture_t, NothingOvertakesTheQueueOnceItHoldsFrames)
+{
+    // With frames waiting, a send never skips them, even if a slot is free
+    port.slots = 1;
+    send(0, 2);
+    send(1, 2);
+    port.slots = 3;
+    EXPECT_EQ(pyro::PYRO_OK, send(2, 2));
+    EXPECT_EQ(2u, queue.stats().queued_count);
+    drain_bus();
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}), port.on_bus);
+}
+
+TEST_F(can_tx_queue_fixture_t, FullQueueCountsDrops)
+{
+    port.slots = 0;
+    for (uint32_t i = 0; i < DEPTH; i++)
+    {
+        ASSERT_EQ(pyro::PYRO_OK, send(i, 2));
+    }
+    EXPECT_EQ(pyro::PYRO_BUSY, send(100, 2));
+    EXPECT_EQ(pyro::PYRO_BUSY, send(101, 2));
+    // Other levels still have room
+    EXPECT_EQ(pyro::PYRO_OK, send(200, 0));
+
+    EXPECT_EQ(2u, queue.stats().dropped_count);
+    EXPECT_EQ(DEPTH + 1, queue.stats().queued_count);
+    EXPECT_EQ(DEPTH + 1, queue.stats().queue_high_water);
+}
+
+TEST_F(can_tx_queue_fixture_t, FailedWritesCount)
+{
+    port.fail_writes = true;
+    EXPECT_EQ(pyro::PYRO_ERROR, send(1, 0));
+    EXPECT_EQ(0u, queue.stats().direct_count);
+
+    // A queued frame whose write fails on refill is a drop as well
+    port.fail_writes = false;
+    port.slots       = 0;
+    send(2, 0);
+    port.slots       = 1;
+    port.fail_writes = true;
+    queue.refill(port);
+    EXPECT_EQ(1u, queue.stats().dropped_count);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(can_tx_queue_fixture_t, LatencyIsQueueToFifo)
+{
+    port.slots = 1;
+    send(0, 1); // direct, no latency
+    port.ticks = 1100;
+    send(1, 1);
+    port.ticks = 1150;
+    send(2, 1);
+
+    port.ticks = 1400;
+    port.tx_complete(queue); // frame 1 waited 300
+    port.ticks = 1420;
+    port.tx_complete(queue); // frame 2 waited 270
+
+    EXPECT_EQ(300u, queue.stats().max_latency);
+    EXPECT_EQ(570u, queue.stats().total_latency);
+}
+
+TEST_F(can_tx_queue_fixture_t, LatencySurvivesTheTickWrap)
+{
+    port.slots = 0;
+    port.ticks = 0xFFFFFF00;
+    send(0, 0);
+    port.slots = 1;
+    port.ticks = 0x100;
+    queue.refill(port);
+    EXPECT_EQ(0x200u, queue.stats().max_latency);
+}
+
+TEST_F(can_tx_queue_fixture_t, RandomTrafficKeepsLevelOrderAndCounts)
+{
+    std::mt19937 rng(0xCA1);
+    std::vector<uint32_t> sent[LEVELS];
+    uint32_t next_id = 0;
+    uint32_t busy    = 0;
+    for (int step = 0; step < 20000; step++)
+    {
+        port.ticks += 1 + rng() % 50;
+        // The bus falls behind, so the queue fills up and drops
+        if (0 == rng() % 3 && !port.fifo.empty())
+        {
+            port.tx_complete(queue);
+            continue;
+        }
+        const size_t level = rng() % LEVELS;
+        const uint32_t id  = next_id++ * LEVELS + level;
+        if (pyro::PYRO_OK == send(id, level))
+        {
+            sent[level].push_back(id);
+        }
+        else
+        {
+            busy++;
+        }
+        ASSERT_LE(queue.size(), DEPTH * LEVELS);
+    }
+    drain_bus();
+
+    const pyro::can_tx_stats_t &stats = queue.stats();
+    EXPECT_GT(busy, 0u);
+    EXPECT_EQ(busy, stats.dropped_count);
+    EXPECT_EQ(stats.direct_count + stats.queued_count, port.on_bus.size());
+    EXPECT_LE(stats.queue_high_water, DEPTH * LEVELS);
+    EXPECT_GE(stats.total_latency, stats.max_latency);
+
+    // Within a level frames reach the bus in the order they were sent
+    std::vector<uint32_t> got[LEVELS];
+    for (const uint32_t id : port.on_bus)
+    {
+        got[id % LEVELS].push_back(id);
+    }
+    for (size_t level = 0; level < LEVELS; level++)
+    {
+        EXPECT_EQ(sent[level], got[level]) << "level " << level;
+    }
+}
@@ -0,0 +1,94 @@
+// CRC-8/CRC-16: the slice-by-N kernel of this build against the bytewise
+// referee code it replaced.
+//
+// Built once per PYRO_CRC_SLICE (crc_bench_slice1/4/8). Lengths cover a
+// referee header (CRC-8 over 4 bytes), a VT03 frame, typical referee frames
+// and a full UART ring. Reports ns per call and bytes per ns.
+//
+//   crc_bench_sliceN [bytes per length]
+
+#include "crc8_crc16_ref.h"
+#include "pyro_core_config.h"
+#include "pyro_crc.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+template <typename F>
+double ns_per_call(const std::vector<uint8_t> &buf, const uint32_t len,
+                   const size_t calls, F &&crc)
+{
+    uint32_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; i++)
+    {
+        // Chain the result into the next call so calls cannot overlap or be
+        // hoisted out of the loop
+        sink = crc(buf.data() + (i & 7), len, sink);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    if (sink == 0x12345678U)
+    {
+        std::printf("?\n");
+    }
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() /
+           static_cast<double>(calls);
+}
+
+void report(const char *name, const uint32_t len, const double ref_ns,
+            const double new_ns)
+{
+    std::printf("  %-5s %4u B: ref %8.1f ns %5.2f B/ns | slice %8.1f ns "
+                "%5.2f B/ns | x%.2f\n",
+                name, len, ref_ns, len / ref_ns, new_ns, len / new_ns,
+                ref_ns / new_ns);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t bytes =
+        argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 200000000;
+    std::mt19937 rng(1);
+    std::vector<uint8_t> buf(512 + 8);
+    for (uint8_t &b : buf)
+    {
+        b = static_cast<uint8_t>(rng());
+    }
+
+    std::printf("PYRO_CRC_SLICE %d, %zu bytes per length\n", PYRO_CRC_SLICE,
+                bytes);
+    for (const uint32_t len : {4u, 19u, 32u, 127u, 512u})
+    {
+        const size_t calls = bytes / len;
+        report("crc8", len,
+               ns_per_call(buf, len, calls,
+                           [](const uint8_t *p, uint32_t n, uint32_t c) {
+                               return uint32_t{crc8_ref(
+                                   p, n, static_cast<uint8_t>(c))};
+                           }),
+               ns_per_call(buf, len, calls,
+                           [](const uint8_t *p, uint32_t n, uint32_t c) {
+                               return uint32_t{pyro_crc8(
+                                   p, n, static_cast<uint8_t>(c))};
+                           }));
+        report("crc16", len,
+               ns_per_call(buf, len, calls,
+                           [](const uint8_t *p, uint32_t n, uint32_t c) {
+                               return uint32_t{crc16_ref(
+                                   p, n, static_cast<uint16_t>(c))};
+                           }),
+               ns_per_call(buf, len, calls,
+                           [](const uint8_t *p, uint32_t n, uint32_t c) {
+                               return uint32_t{pyro_crc16(
+                                   p, n, static_cast<uint16_t>(c))};
+                           }));
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "crc8_crc16_ref.h"
+#include "pyro_crc.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Built once per PYRO_CRC_SLICE (crc_test_slice1/4/8); every case compares
+// against the bytewise referee code the slice kernels replaced
+
+namespace
+{
+// Random data at a random misalignment, so the slice loop sees every
+// combination of head, body and bytewise tail
+struct sample_t
+{
+    std::vector<uint8_t> storage;
+    const uint8_t *data;
+    uint32_t len;
+};
+
+sample_t random_sample(std::mt19937 &rng, const uint32_t max_len)
+{
+    sample_t s;
+    const uint32_t offset = rng() % 8;
+    s.len                 = rng() % (max_len + 1);
+    s.storage.resize(offset + s.len + 1);
+    for (uint8_t &b : s.storage)
+    {
+        b = static_cast<uint8_t>(rng());
+    }
+    s.data = s.storage.data() + offset;
+    return s;
+}
+} // namespace
+
+TEST(crc, CheckString)
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(crc8_ref(check, sizeof(check), 0xff),
+              pyro_crc8(check, sizeof(check), 0xff));
+    EXPECT_EQ(crc16_ref(check, sizeof(check), 0xffff),
+              pyro_crc16(check, sizeof(check), 0xffff));
+}
+
+TEST(crc, EveryLengthUpTo64)
+{
+    std::mt19937 rng(1);
+    std::vector<uint8_t> buf(64 + 8);
+    for (uint8_t &b : buf)
+    {
+        b = static_cast<uint8_t>(rng());
+    }
+    for (uint32_t offset = 0; offset < 8; offset++)
+    {
+        for (uint32_t len = 0; len <= 64; len++)
+        {
+            const uint8_t *p = buf.data() + offset;
+            ASSERT_EQ(crc8_ref(p, len, 0xff), pyro_crc8(p, len, 0xff))
+                << "offset " << offset << " len " << len;
+            ASSERT_EQ(crc16_ref(p, len, 0xffff), pyro_crc16(p, len, 0xffff))
+                << "offset " << offset << " len " << len;
+        }
+    }
+}
+
+TEST(crc, RandomBuffersAndSeeds)
+{
+    std::mt19937 rng(2);
+    for (int i = 0; i < 200000; i++)
+    {
+        const sample_t s   = random_sample(rng, 300);
+        const uint8_t c8   = static_cast<uint8_t>(rng());
+        const uint16_t c16 = static_cast<uint16_t>(rng());
+        ASSERT_EQ(crc8_ref(s.data, s.len, c8), pyro_crc8(s.data, s.len, c8))
+            << "sample " << i;
+        ASSERT_EQ(crc16_ref(s.data, s.len, c16),
+                  pyro_crc16(s.data, s.len, c16))
+            << "sample " << i;
+    }
+}
+
+// Feeding a buffer in two pieces must give the same result as in one
+TEST(crc, ChainedCalls)
+{
+    std::mt19937 rng(3);
+    for (int i = 0; i < 10000; i++)
+    {
+        const sample_t s = random_sample(rng, 200);
+        const uint32_t k = s.len ? rng() % (s.len + 1) : 0;
+        EXPECT_EQ(crc8_ref(s.data, s.len, pyro::CRC8_INIT),
+                  pyro::crc8_calc(s.data + k, s.len - k,
+                                  pyro::crc8_calc(s.data, k)));
+        EXPECT_EQ(crc16_ref(s.data, s.len, pyro::CRC16_INIT),
+                  pyro::crc16_calc(s.data + k, s.len - k,
+                                   pyro::crc16_calc(s.data, k)));
+    }
+}
+
+TEST(crc, NullInput)
+{
+    EXPECT_EQ(0x5a, pyro_crc8(nullptr, 10, 0x5a));
+    EXPECT_EQ(crc16_ref(nullptr, 10, 0x1234), pyro_crc16(nullptr, 10, 0x1234));
+    EXPECT_FALSE(pyro::crc8_verify(nullptr, 10));
+    EXPECT_FALSE(pyro::crc16_verify(nullptr, 10));
+}
+
+// Frames appended by the new code verify with the old code and vice versa,
+// and a single flipped bit is caught by both
+TEST(crc, AppendAndVerifyAgreeWithReference)
+{
+    std::mt19937 rng(4);
+    for (int i = 0; i < 20000; i++)
+    {
+        sample_t s      = random_sample(rng, 128);
+        uint8_t *p      = const_cast<uint8_t *>(s.data);
+        const bool use8 = rng() % 2;
+        if (use8)
+        {
+            pyro::crc8_append(p, s.len);
+        }
+        else
+        {
+            pyro::crc16_append(p, s.len);
+        }
+        const bool ref_ok = use8 ? verify_crc8_ref(p, s.len)
+                                 : verify_crc16_ref(p, s.len);
+        const bool new_ok = use8 ? pyro::crc8_verify(p, s.len)
+                                 : pyro::crc16_verify(p, s.len);
+        ASSERT_EQ(ref_ok, new_ok) << "sample " << i;
+        ASSERT_EQ(s.len > 2, new_ok) << "sample " << i;
+
+        if (s.len > 2)
+        {
+            p[rng() % s.len] ^= static_cast<uint8_t>(1U << (rng() % 8));
+            ASSERT_FALSE(use8 ? pyro::crc8_verify(p, s.len)
+                              : pyro::crc16_verify(p, s.len));
+            ASSERT_FALSE(use8 ? verify_crc8_ref(p, s.len)
+                              : verify_crc16_ref(p, s.len));
+        }
+    }
+}
@@ -0,0 +1,240 @@
+#include "pyro_core_dma_heap.h"
+#include "pyro_dma_buffer.h"
+#include "stm32h7xx.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// pyro_dma_buffer.cpp runs against the stubbed SCB below: every maintenance
+// call is recorded, the DMA heap is aligned_alloc
+
+namespace
+{
+struct cache_op_t
+{
+    bool clean;
+    uintptr_t start;
+    int32_t size;
+};
+
+std::vector<cache_op_t> cache_ops;
+size_t heap_live      = 0;
+size_t heap_requested = 0;
+size_t heap_alignment = 0;
+
+constexpr uintptr_t LINE = pyro::DMA_CACHE_LINE;
+
+class dma_buffer_fixture_t : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        pyro_stub_scb.CCR = SCB_CCR_DC_Msk;
+        cache_ops.clear();
+        heap_live = 0;
+    }
+
+    void TearDown() override
+    {
+        EXPECT_EQ(0u, heap_live);
+    }
+
+    // The one recorded op must cover exactly the lines of [p, p + len)
+    static void expect_lines(const bool clean, const uint8_t *p,
+                             const size_t len)
+    {
+        ASSERT_EQ(1u, cache_ops.size());
+        const uintptr_t first = reinterpret_cast<uintptr_t>(p) & ~(LINE - 1);
+        const uintptr_t last =
+            (reinterpret_cast<uintptr_t>(p) + len + LINE - 1) & ~(LINE - 1);
+        EXPECT_EQ(clean, cache_ops[0].clean);
+        EXPECT_EQ(first, cache_ops[0].start);
+        EXPECT_EQ(static_cast<int32_t>(last - first), cache_ops[0].size);
+        cache_ops.clear();
+    }
+};
+} // namespace
+
+SCB_Type pyro_stub_scb;
+
+extern "C" void SCB_CleanDCache_by_Addr(uint32_t *addr, int32_t dsize)
+{
+    cache_ops.push_back({true, reinterpret_cast<uintptr_t>(addr), dsize});
+}
+
+extern "C" void SCB_InvalidateDCache_by_Addr(void *addr, int32_t dsize)
+{
+    cache_ops.push_back({false, reinterpret_cast<uintptr_t>(addr), dsize});
+}
+
+extern "C" void *pvPortDmaMallocAligned(size_t xWantedSize, size_t xAlignment)
+{
+    heap_requested = xWantedSize;
+    heap_alignment = xAlignment;
+    void *p        = std::aligned_alloc(xAlignment, xWantedSize);
+    heap_live += nullptr != p;
+    return p;
+}
+
+extern "C" void vPortDmaFree(void *pv)
+{
+    heap_live -= nullptr != pv;
+    std::free(pv);
+}
+
+/* Line arithmetic -----------------------------------------------------------*/
+// Every start within three lines and every size up to three lines: the range
+// is line aligned, covers the bytes and is no wider than needed
+TEST(dma_cache_range, CoversExactlyTheTouchedLines)
+{
+    for (uintptr_t base : {uintptr_t{0}, uintptr_t{0x30000000},
+                           uintptr_t{0x30007F00}})
+    {
+        for (uintptr_t addr = base; addr < base + 3 * LINE; addr++)
+        {
+            for (size_t size = 1; size <= 3 * LINE; size++)
+            {
+                const auto r = pyro::dma_cache_range(addr, size);
+                ASSERT_EQ(0u, r.start % LINE) << addr << "+" << size;
+                ASSERT_EQ(0u, r.size % LINE) << addr << "+" << size;
+                ASSERT_LE(r.start, addr) << addr << "+" << size;
+                ASSERT_GE(r.start + r.size, addr + size) << addr << "+" << size;
+                ASSERT_GT(r.start + LINE, addr) << addr << "+" << size;
+                ASSERT_LT(r.start + r.size - LINE, addr + size)
+                    << addr << "+" << size;
+            }
+        }
+    }
+}
+
+TEST(dma_cache_range, ZeroSizeIsEmpty)
+{
+    for (uintptr_t addr = 0; addr < 2 * LINE; addr++)
+    {
+        const auto r = pyro::dma_cache_range(addr, 0);
+        EXPECT_EQ(0u, r.size) << addr;
+        EXPECT_EQ(addr & ~(LINE - 1), r.start) << addr;
+    }
+}
+
+TEST(dma_cache_range, UnalignedStartCrossingLines)
+{
+    // One byte either side of a boundary touches both lines
+    EXPECT_EQ(2 * LINE, pyro::dma_cache_range(LINE - 1, 2).size);
+    // Within one line
+    EXPECT_EQ(LINE, pyro::dma_cache_range(1, LINE - 1).size);
+    // One line's worth from an unaligned start spans two
+    EXPECT_EQ(2 * LINE, pyro::dma_cache_range(1, LINE).size);
+    EXPECT_EQ(3 * LINE, pyro::dma_cache_range(LINE - 1, LINE + 2).size);
+}
+
+TEST(dma_cache_range, RoundAndAlign)
+{
+    for (size_t n = 0; n <= 4 * LINE; n++)
+    {
+        EXPECT_EQ((n + LINE - 1) / LINE * LINE, pyro::dma_cache_round_up(n));
+        EXPECT_EQ(n / LINE * LINE, pyro::dma_cache_align_down(n));
+        EXPECT_EQ((n + LINE - 1) / LINE * LINE, pyro::dma_cache_align_up(n));
+    }
+}
+
+/* Free maintenance calls ----------------------------------------------------*/
+TEST_F(dma_buffer_fixture_t, FreeCallsSkipEmptyRangesAndDisabledCache)
+{
+    alignas(LINE) uint8_t buf[4 * LINE] = {};
+    pyro::dma_cache_clean(buf + 5, 0);
+    pyro::dma_cache_invalidate(buf + 5, 0);
+    EXPECT_TRUE(cache_ops.empty());
+
+    pyro_stub_scb.CCR = 0;
+    pyro::dma_cache_clean(buf, sizeof(buf));
+    pyro::dma_cache_invalidate(buf, sizeof(buf));
+    EXPECT_TRUE(cache_ops.empty());
+
+    pyro_stub_scb.CCR = SCB_CCR_DC_Msk;
+    pyro::dma_cache_clean(buf + 5, 40);
+    expect_lines(true, buf + 5, 40);
+    pyro::dma_cache_invalidate(buf + LINE - 1, 2);
+    expect_lines(false, buf + LINE - 1, 2);
+}
+
+/* dma_buffer_t --------------------------------------------------------------*/
+TEST_F(dma_buffer_fixture_t, AllocateRoundsToLines)
+{
+    pyro::dma_buffer_t empty(0);
+    EXPECT_FALSE(empty);
+    EXPECT_EQ(0u, heap_live);
+
+    for (size_t n : {size_t{1}, LINE - 1, LINE, LINE + 1, size_t{127}})
+    {
+        pyro::dma_buffer_t buf(n);
+        ASSERT_TRUE(buf);
+        EXPECT_EQ(n, buf.size());
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(buf.data()) % LINE);
+        EXPECT_EQ(pyro::dma_cache_round_up(n), heap_requested);
+        EXPECT_EQ(LINE, heap_alignment);
+    }
+}
+
+TEST_F(dma_buffer_fixture_t, ReleaseAndReallocate)
+{
+    pyro::dma_buffer_t buf(100);
+    ASSERT_TRUE(buf.allocate(10));
+    EXPECT_EQ(1u, heap_live);
+    EXPECT_FALSE(buf.allocate(0));
+    EXPECT_FALSE(buf);
+    EXPECT_EQ(0u, buf.size());
+    EXPECT_EQ(0u, heap_live);
+}
+
+TEST_F(dma_buffer_fixture_t, UnallocatedBufferIsNoOp)
+{
+    pyro::dma_buffer_t buf;
+    buf.clean();
+    buf.invalidate();
+    buf.clean(0, 10);
+    buf.invalidate(0, 10);
+    EXPECT_TRUE(cache_ops.empty());
+}
+
+TEST_F(dma_buffer_fixture_t, WholeBufferCoversRoundedLines)
+{
+    pyro::dma_buffer_t buf(70);
+    buf.clean();
+    expect_lines(true, buf.data(), 70);
+    buf.invalidate();
+    expect_lines(false, buf.data(), 70);
+}
+
+// Offsets at or past the end do nothing; lengths past the end stop at size()
+TEST_F(dma_buffer_fixture_t, OffsetAndLengthClamp)
+{
+    constexpr size_t SIZE = 100;
+    pyro::dma_buffer_t buf(SIZE);
+    for (const bool clean : {true, false})
+    {
+        auto op = [&](size_t offset, size_t len) {
+            clean ? buf.clean(offset, len) : buf.invalidate(offset, len);
+        };
+
+        op(SIZE, 1);
+        op(SIZE + 1, 10);
+        op(SIZE * 10, SIZE);
+        op(SIZE - 1, 0);
+        EXPECT_TRUE(cache_ops.empty());
+
+        for (size_t offset = 0; offset < SIZE; offset++)
+        {
+            for (size_t len : {size_t{1}, size_t{31}, size_t{33}, SIZE,
+                               SIZE * 4, SIZE_MAX})
+            {
+                op(offset, len);
+                const size_t expect = len < SIZE - offset ? len : SIZE - offset;
+                expect_lines(clean, buf.data() + offset, expect);
+            }
+        }
+    }
+}
@@ -0,0 +1,201 @@
+#include "fifo.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+// The in-place consumer of the referee FIFO: fifo_s_peek_block lends the
+// contiguous used block at the read pointer, fifo_s_discard releases it
+
+namespace
+{
+constexpr int SIZE = 16;
+
+class fifo_fixture_t : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(0, fifo_s_init(&_fifo, _buf, SIZE));
+    }
+
+    void put(const int len)
+    {
+        std::vector<char> src(len);
+        for (char &c : src)
+        {
+            c = static_cast<char>(_next_in++);
+        }
+        ASSERT_EQ(len, fifo_s_puts(&_fifo, src.data(), len));
+    }
+
+    // The block must hold the next bytes of the stream
+    void expect_stream(const char *block, const int len)
+    {
+        for (int i = 0; i < len; i++)
+        {
+            ASSERT_EQ(static_cast<char>(_next_out + i), block[i]) << i;
+        }
+    }
+
+    void consume(const int len)
+    {
+        ASSERT_EQ(len, fifo_s_discard(&_fifo, len));
+        _next_out += len;
+    }
+
+    fifo_s_t _fifo;
+    char _buf[SIZE];
+    uint8_t _next_in  = 0;
+    uint8_t _next_out = 0;
+};
+} // namespace
+
+TEST_F(fifo_fixture_t, EmptyFifoLendsNothing)
+{
+    char *block = nullptr;
+    EXPECT_EQ(0, fifo_s_peek_block(&_fifo, &block));
+    EXPECT_EQ(0, fifo_s_discard(&_fifo, 5));
+    EXPECT_EQ(0, fifo_s_used(&_fifo));
+}
+
+TEST_F(fifo_fixture_t, BlockStopsAtTheWrapPoint)
+{
+    put(12);
+    consume(10);
+    put(10); // 4 bytes left to the end, 6 wrap to the start
+
+    char *block = nullptr;
+    int len     = fifo_s_peek_block(&_fifo, &block);
+    ASSERT_EQ(6, len);
+    EXPECT_EQ(_buf + 10, block);
+    expect_stream(block, len);
+    consume(len);
+
+    len = fifo_s_peek_block(&_fifo, &block);
+    ASSERT_EQ(6, len);
+    EXPECT_EQ(_buf, block);
+    expect_stream(block, len);
+    consume(len);
+    EXPECT_TRUE(fifo_s_isempty(&_fifo));
+}
+
+// Releasing more than the first block moves the read pointer over the end
+TEST_F(fifo_fixture_t, DiscardAcrossTheWrapPoint)
+{
+    put(14);
+    consume(12);
+    put(10);
+    consume(7); // 4 to the end + 3 from the start
+
+    char *block   = nullptr;
+    const int len = fifo_s_peek_block(&_fifo, &block);
+    ASSERT_EQ(5, len);
+    EXPECT_EQ(_buf + 3, block);
+    expect_stream(block, len);
+}
+
+// Read pointer exactly on the last byte, and exactly past it
+TEST_F(fifo_fixture_t, DiscardOntoAndPastTheEnd)
+{
+    put(SIZE);
+    consume(SIZE - 1);
+    char *block = nullptr;
+    ASSERT_EQ(1, fifo_s_peek_block(&_fifo, &block));
+    EXPECT_EQ(_buf + SIZE - 1, block);
+    expect_stream(block, 1);
+    consume(1);
+
+    put(3);
+    ASSERT_EQ(3, fifo_s_peek_block(&_fifo, &block));
+    EXPECT_EQ(_buf, block);
+    expect_stream(block, 3);
+}
+
+TEST_F(fifo_fixture_t, DiscardClampsToUsed)
+{
+    put(5);
+    EXPECT_EQ(5, fifo_s_discard(&_fifo, 100));
+    EXPECT_TRUE(fifo_s_isempty(&_fifo));
+    EXPECT_EQ(SIZE, fifo_s_free(&_fifo));
+}
+
+// A full FIFO lends the part up to the end, then the wrapped rest
+TEST_F(fifo_fixture_t, FullFifo)
+{
+    put(9);
+    consume(9);
+    put(SIZE);
+    EXPECT_TRUE(fifo_s_isfull(&_fifo));
+
+    char *block = nullptr;
+    ASSERT_EQ(SIZE - 9, fifo_s_peek_block(&_fifo, &block));
+    expect_stream(block, SIZE - 9);
+    consume(SIZE - 9);
+    ASSERT_EQ(9, fifo_s_peek_block(&_fifo, &block));
+    expect_stream(block, 9);
+    consume(9);
+    EXPECT_TRUE(fifo_s_isempty(&_fifo));
+}
+
+// Random spans in, random partial releases out, against a deque model; the
+// stream must come out whole and in order at every wrap position
+TEST(fifo_s_t, RandomProducerConsumer)
+{
+    for (const int size : {7, 16, 100, 1024})
+    {
+        std::vector<char> storage(size);
+        fifo_s_t fifo;
+        ASSERT_EQ(0, fifo_s_init(&fifo, storage.data(), size));
+        std::mt19937 rng(static_cast<uint32_t>(size));
+        std::deque<char> model;
+        uint8_t next = 0;
+
+        for (int op = 0; op < 200000; op++)
+        {
+            if (rng() % 2)
+            {
+                std::vector<char> span(1 + rng() % (size / 2 + 1));
+                for (char &c : span)
+                {
+                    c = static_cast<char>(next++);
+                }
+                const int room = size - static_cast<int>(model.size());
+                int put        = fifo_s_puts(&fifo, span.data(),
+                                             static_cast<int>(span.size()));
+                // A full FIFO refuses the whole span with -1
+                ASSERT_EQ(room ? std::min<int>(span.size(), room) : -1, put);
+                put = room ? put : 0;
+                model.insert(model.end(), span.begin(), span.begin() + put);
+                next = static_cast<uint8_t>(next - (span.size() - put));
+            }
+            else
+            {
+                char *block   = nullptr;
+                const int len = fifo_s_peek_block(&fifo, &block);
+                ASSERT_LE(len, static_cast<int>(model.size()));
+                ASSERT_EQ(model.empty(), 0 == len);
+                if (len)
+                {
+                    ASSERT_GE(block, storage.data());
+                    ASSERT_LE(block + len, storage.data() + size);
+                    for (int i = 0; i < len; i++)
+                    {
+                        ASSERT_EQ(model[i], block[i]) << "op " << op;
+                    }
+                }
+                // Release the block, part of it, or more than it
+                const int n    = static_cast<int>(rng() % (len + 3));
+                const int done = fifo_s_discard(&fifo, n);
+                ASSERT_EQ(std::min<int>(n, model.size()), done);
+                model.erase(model.begin(), model.begin() + done);
+            }
+            ASSERT_EQ(static_cast<int>(model.size()), fifo_s_used(&fifo));
+            ASSERT_EQ(size - static_cast<int>(model.size()),
+                      fifo_s_free(&fifo));
+        }
+    }
+}
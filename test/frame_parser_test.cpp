@@ -0,0 +1,456 @@
+#include "frame_parser.h"
+#include "pyro_crc.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using pyro::frame_format_t;
+using pyro::frame_parser_t;
+
+namespace
+{
+using bytes_t = std::vector<uint8_t>;
+
+// The formats mirror referee_drv.cpp, pyro_vt03_rc_drv.cpp and
+// pyro_dr16_rc_drv.cpp
+constexpr uint8_t REF_SOF        = 0xA5;
+constexpr uint16_t REF_HEADER    = 5; // SOF | data_length(2) | seq | CRC8
+constexpr uint16_t REF_OVERHEAD  = 9; // header + cmd_id(2) + CRC16
+constexpr uint16_t REF_MAX_FRAME = 128;
+
+bool crc8_check(const uint8_t *p, const uint16_t len)
+{
+    return pyro::crc8_verify(p, len);
+}
+
+bool crc16_check(const uint8_t *p, const uint16_t len)
+{
+    return pyro::crc16_verify(p, len);
+}
+
+constexpr frame_format_t referee_format = {
+    {REF_SOF, 0x00}, 1,           REF_HEADER,   1,          2,
+    REF_OVERHEAD,    0,           REF_OVERHEAD, crc8_check, crc16_check,
+};
+
+constexpr uint16_t VT03_LEN          = 21;
+constexpr frame_format_t vt03_format = {
+    {0xA9, 0x53}, 2, 2, 0, 0, 0, VT03_LEN, VT03_LEN, nullptr, crc16_check,
+};
+
+constexpr uint16_t DR16_LEN          = 18;
+constexpr frame_format_t dr16_format = {
+    {0x00, 0x00}, 0, 0, 0, 0, 0, DR16_LEN, DR16_LEN, nullptr, nullptr,
+};
+
+class stream_gen_t
+{
+  public:
+    explicit stream_gen_t(const uint32_t seed) : _rng(seed)
+    {
+    }
+
+    uint32_t uniform(const uint32_t lo, const uint32_t hi)
+    {
+        return std::uniform_int_distribution<uint32_t>(lo, hi)(_rng);
+    }
+
+    // Payload bytes are biased towards SOF values to provoke false starts
+    uint8_t byte()
+    {
+        switch (uniform(0, 7))
+        {
+            case 0:
+                return REF_SOF;
+            case 1:
+                return 0xA9;
+            case 2:
+                return 0x53;
+            default:
+                return static_cast<uint8_t>(uniform(0, 255));
+        }
+    }
+
+    bytes_t referee_frame()
+    {
+        const uint16_t data_len = uniform(0, REF_MAX_FRAME - REF_OVERHEAD);
+        bytes_t f(data_len + REF_OVERHEAD);
+        f[0] = REF_SOF;
+        f[1] = static_cast<uint8_t>(data_len);
+        f[2] = static_cast<uint8_t>(data_len >> 8);
+        f[3] = byte();
+        pyro::crc8_append(f.data(), REF_HEADER);
+        for (size_t i = REF_HEADER; i < f.size() - 2; i++)
+        {
+            f[i] = byte();
+        }
+        pyro::crc16_append(f.data(), f.size());
+        return f;
+    }
+
+    bytes_t vt03_frame()
+    {
+        bytes_t f(VT03_LEN);
+        f[0] = 0xA9;
+        f[1] = 0x53;
+        for (size_t i = 2; i < f.size() - 2; i++)
+        {
+            f[i] = byte();
+        }
+        pyro::crc16_append(f.data(), f.size());
+        return f;
+    }
+
+    bytes_t garbage()
+    {
+        bytes_t g(uniform(1, 40));
+        for (auto &b : g)
+        {
+            b = byte();
+        }
+        return g;
+    }
+
+    void flip_bit(bytes_t &f)
+    {
+        const size_t bit = uniform(0, f.size() * 8 - 1);
+        f[bit / 8] ^= static_cast<uint8_t>(1U << (bit % 8));
+    }
+
+    // A referee header that passes its CRC8 but announces another length
+    void wrong_length(bytes_t &f)
+    {
+        uint16_t len = f[1] | (f[2] << 8);
+        len          = static_cast<uint16_t>(len + uniform(1, 300));
+        f[1]         = static_cast<uint8_t>(len);
+        f[2]         = static_cast<uint8_t>(len >> 8);
+        pyro::crc8_append(f.data(), REF_HEADER);
+    }
+
+    void truncate(bytes_t &f)
+    {
+        f.resize(uniform(1, f.size() - 1));
+    }
+
+  private:
+    std::mt19937 _rng;
+};
+
+enum class fault_t
+{
+    none,
+    bit_flip,
+    truncated,
+    wrong_length,
+    garbage,
+};
+
+/**
+ * @brief Builds a stream of intact frames mixed with faults; `expect` gets
+ *        the intact frames in order.
+ */
+template <typename MAKE>
+bytes_t build_stream(stream_gen_t &gen, MAKE make, const bool has_length,
+                     const size_t frames, std::vector<bytes_t> &expect)
+{
+    bytes_t stream;
+    for (size_t n = 0; n < frames; n++)
+    {
+        bytes_t f = make();
+        fault_t fault =
+            static_cast<fault_t>(gen.uniform(0, 9) < 6 ? 0 : gen.uniform(1, 4));
+        if (fault_t::wrong_length == fault && !has_length)
+        {
+            fault = fault_t::bit_flip;
+        }
+        switch (fault)
+        {
+            case fault_t::none:
+                expect.push_back(f);
+                break;
+            case fault_t::bit_flip:
+                gen.flip_bit(f);
+                break;
+            case fault_t::truncated:
+                gen.truncate(f);
+                break;
+            case fault_t::wrong_length:
+                gen.wrong_length(f);
+                break;
+            case fault_t::garbage:
+                f = gen.garbage();
+                break;
+        }
+        stream.insert(stream.end(), f.begin(), f.end());
+    }
+    return stream;
+}
+
+/**
+ * @brief Reference parser: tries a frame at every SOF position of the
+ *        complete stream and skips one byte on rejection.
+ */
+std::vector<bytes_t> reference_parse(const frame_format_t &fmt,
+                                     const size_t max_len,
+                                     const bytes_t &stream)
+{
+    std::vector<bytes_t> out;
+    size_t pos = 0;
+    while (pos < stream.size())
+    {
+        const uint8_t *p  = stream.data() + pos;
+        const size_t left = stream.size() - pos;
+        bool ok           = true;
+        for (uint8_t i = 0; i < fmt.sof_len && ok; i++)
+        {
+            ok = i < left && p[i] == fmt.sof[i];
+        }
+        if (!ok)
+        {
+            pos++;
+            continue;
+        }
+        if (left < fmt.header_len)
+        {
+            break;
+        }
+        if (fmt.check_header && !fmt.check_header(p, fmt.header_len))
+        {
+            pos++;
+            continue;
+        }
+        size_t total = fmt.fixed_len;
+        if (fmt.len_size)
+        {
+            total = p[fmt.len_offset];
+            if (fmt.len_size > 1)
+            {
+                total |= static_cast<size_t>(p[fmt.len_offset + 1]) << 8;
+            }
+            total += fmt.len_extra;
+        }
+        if (total > max_len || total < fmt.header_len || total < fmt.min_len)
+        {
+            pos++;
+            continue;
+        }
+        if (left < total)
+        {
+            break; // would wait for more data
+        }
+        if (fmt.check_frame &&
+            !fmt.check_frame(p, static_cast<uint16_t>(total)))
+        {
+            pos++;
+            continue;
+        }
+        out.emplace_back(p, p + total);
+        pos += total;
+    }
+    return out;
+}
+
+/**
+ * @brief Intact frames missing from `got`, in order.
+ */
+size_t count_missing(const std::vector<bytes_t> &expect,
+                     const std::vector<bytes_t> &got)
+{
+    size_t missing = 0;
+    size_t j       = 0;
+    for (const auto &f : expect)
+    {
+        size_t k = j;
+        while (k < got.size() && got[k] != f)
+        {
+            k++;
+        }
+        if (k == got.size())
+        {
+            missing++;
+        }
+        else
+        {
+            j = k + 1;
+        }
+    }
+    return missing;
+}
+
+/**
+ * @brief Feeds `stream` in random chunk sizes (1..max_chunk) and collects
+ *        the delivered frames.
+ */
+template <size_t MAX_LEN>
+std::vector<bytes_t> parse(frame_parser_t<MAX_LEN> &parser, stream_gen_t &gen,
+                           const bytes_t &stream, const uint32_t max_chunk)
+{
+    std::vector<bytes_t> out;
+    size_t pos = 0;
+    while (pos < stream.size())
+    {
+        size_t n = gen.uniform(1, max_chunk);
+        n        = n < stream.size() - pos ? n : stream.size() - pos;
+        parser.feed(stream.data() + pos, n,
+                    [&](const uint8_t *frame, const uint16_t len)
+                    { out.emplace_back(frame, frame + len); });
+        pos += n;
+    }
+    return out;
+}
+} // namespace
+
+class frame_parser_fuzz : public ::testing::TestWithParam<uint32_t>
+{
+};
+
+TEST_P(frame_parser_fuzz, RefereeRecoversEveryIntactFrame)
+{
+    stream_gen_t gen(GetParam());
+    std::vector<bytes_t> expect;
+    const bytes_t stream = build_stream(
+        gen, [&] { return gen.referee_frame(); }, true, 2000, expect);
+
+    frame_parser_t<REF_MAX_FRAME> parser(referee_format);
+    const auto got = parse(parser, gen, stream, GetParam() % 2 ? 7 : 200);
+
+    EXPECT_EQ(reference_parse(referee_format, REF_MAX_FRAME, stream), got);
+    // CRC8 + CRC16: no false frame is expected, so the output is exact
+    ASSERT_EQ(expect.size(), got.size());
+    for (size_t i = 0; i < expect.size(); i++)
+    {
+        ASSERT_EQ(expect[i], got[i]) << "frame " << i;
+    }
+    EXPECT_EQ(expect.size(), parser.stats().frames);
+}
+
+TEST_P(frame_parser_fuzz, Vt03RecoversEveryIntactFrame)
+{
+    stream_gen_t gen(GetParam());
+    std::vector<bytes_t> expect;
+    const bytes_t stream = build_stream(
+        gen, [&] { return gen.vt03_frame(); }, false, 4000, expect);
+
+    frame_parser_t<VT03_LEN> parser(vt03_format);
+    const auto got = parse(parser, gen, stream, GetParam() % 2 ? 3 : 64);
+
+    EXPECT_EQ(reference_parse(vt03_format, VT03_LEN, stream), got);
+    // Only SOF + CRC16 guard a VT03 frame, and the payloads are full of SOF
+    // bytes: a rare false frame may pass and hide the intact one it overlaps
+    const size_t missing = count_missing(expect, got);
+    EXPECT_LE(missing, 2u);
+    EXPECT_LE(got.size() - (expect.size() - missing), 2u);
+}
+
+// Referee and VT03 interleaved, as on UART1: each parser picks its own frames
+TEST_P(frame_parser_fuzz, SharedLineKeepsBothStreams)
+{
+    stream_gen_t gen(GetParam());
+    std::vector<bytes_t> ref_expect, vt03_expect;
+    bytes_t stream;
+    for (size_t n = 0; n < 3000; n++)
+    {
+        const bool ref = gen.uniform(0, 1);
+        bytes_t f      = ref ? gen.referee_frame() : gen.vt03_frame();
+        (ref ? ref_expect : vt03_expect).push_back(f);
+        stream.insert(stream.end(), f.begin(), f.end());
+    }
+
+    frame_parser_t<REF_MAX_FRAME> ref_parser(referee_format);
+    frame_parser_t<VT03_LEN> vt03_parser(vt03_format);
+    EXPECT_EQ(ref_expect, parse(ref_parser, gen, stream, 42));
+    const auto vt03_got = parse(vt03_parser, gen, stream, 42);
+    EXPECT_EQ(reference_parse(vt03_format, VT03_LEN, stream), vt03_got);
+    EXPECT_LE(count_missing(vt03_expect, vt03_got), 2u);
+}
+
+// DR16 has no sync: every IDLE chunk is parsed from a reset parser
+TEST_P(frame_parser_fuzz, Dr16FramesPerIdleChunk)
+{
+    stream_gen_t gen(GetParam());
+    frame_parser_t<DR16_LEN> parser(dr16_format);
+    size_t expect_frames = 0;
+    size_t got_frames    = 0;
+
+    for (size_t n = 0; n < 5000; n++)
+    {
+        // Mostly whole frames, sometimes truncated or back-to-back ones
+        bytes_t chunk(DR16_LEN);
+        switch (gen.uniform(0, 5))
+        {
+            case 0:
+                chunk.resize(gen.uniform(1, DR16_LEN - 1));
+                break;
+            case 1:
+                chunk.resize(DR16_LEN * gen.uniform(2, 3) +
+                             gen.uniform(0, DR16_LEN - 1));
+                break;
+            default:
+                break;
+        }
+        for (auto &b : chunk)
+        {
+            b = gen.byte();
+        }
+
+        size_t offset = 0;
+        parser.reset();
+        parser.feed(chunk.data(), chunk.size(),
+                    [&](const uint8_t *frame, const uint16_t len)
+                    {
+                        ASSERT_EQ(DR16_LEN, len);
+                        ASSERT_LE(offset + len, chunk.size());
+                        EXPECT_EQ(0, memcmp(frame, chunk.data() + offset, len));
+                        offset += len;
+                        got_frames++;
+                    });
+        expect_frames += chunk.size() / DR16_LEN;
+    }
+    EXPECT_EQ(expect_frames, got_frames);
+}
+
+INSTANTIATE_TEST_SUITE_P(seeds, frame_parser_fuzz,
+                         ::testing::Values(1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u));
+
+// One-byte chunks: every frame is assembled in the internal buffer
+TEST(frame_parser_t, ByteWiseFeedMatchesBulkFeed)
+{
+    stream_gen_t gen(99);
+    std::vector<bytes_t> expect;
+    const bytes_t stream = build_stream(
+        gen, [&] { return gen.referee_frame(); }, true, 500, expect);
+
+    frame_parser_t<REF_MAX_FRAME> parser(referee_format);
+    EXPECT_EQ(expect, parse(parser, gen, stream, 1));
+
+    frame_parser_t<REF_MAX_FRAME> bulk(referee_format);
+    std::vector<bytes_t> got;
+    bulk.feed(stream.data(), stream.size(),
+              [&](const uint8_t *frame, const uint16_t len)
+              { got.emplace_back(frame, frame + len); });
+    EXPECT_EQ(expect, got);
+}
+
+TEST(frame_parser_t, OversizedLengthIsRejected)
+{
+    stream_gen_t gen(5);
+    bytes_t f = gen.referee_frame();
+    // 0xFFFF + overhead can never fit into the parser buffer
+    f[1] = 0xFF;
+    f[2] = 0xFF;
+    pyro::crc8_append(f.data(), REF_HEADER);
+    const bytes_t good = gen.referee_frame();
+    f.insert(f.end(), good.begin(), good.end());
+
+    frame_parser_t<REF_MAX_FRAME> parser(referee_format);
+    std::vector<bytes_t> got;
+    parser.feed(f.data(), f.size(),
+                [&](const uint8_t *frame, const uint16_t len)
+                { got.emplace_back(frame, frame + len); });
+    ASSERT_EQ(1u, got.size());
+    EXPECT_EQ(good, got[0]);
+    EXPECT_GE(parser.stats().rejected, 1u);
+}
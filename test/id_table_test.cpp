@@ -0,0 +1,137 @@
+#include "id_table.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+// can_drv_t::MAX_ID_REGIST_NUM and RX_TABLE_SLOTS
+constexpr size_t MAX_IDS = 32;
+constexpr size_t SLOTS   = 128;
+
+using table_t = pyro::id_table_t<const void *, SLOTS>;
+
+std::vector<uint32_t> random_ids(std::mt19937 &rng, const size_t count,
+                                 const uint32_t mask)
+{
+    std::set<uint32_t> ids;
+    while (ids.size() < count)
+    {
+        ids.insert(rng() & mask);
+    }
+    std::vector<uint32_t> out(ids.begin(), ids.end());
+    std::shuffle(out.begin(), out.end(), rng);
+    return out;
+}
+
+// Plans and commits the set, then checks every key hits its own value and
+// a sweep of other keys misses
+void expect_planned(const std::vector<uint32_t> &ids, const uint32_t mask,
+                    std::mt19937 &rng)
+{
+    uint32_t seed = 0;
+    ASSERT_TRUE(table_t::plan(ids.data(), ids.size(), seed))
+        << ids.size() << " ids, first " << ids.front();
+
+    std::vector<const void *> values(ids.size());
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        values[i] = &ids[i];
+    }
+    table_t table;
+    table.commit(seed, ids.data(), values.data(), ids.size());
+
+    const std::set<uint32_t> registered(ids.begin(), ids.end());
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        ASSERT_EQ(values[i], table.find(ids[i]));
+    }
+    for (int i = 0; i < 256; i++)
+    {
+        const uint32_t key = rng() & mask;
+        if (!registered.count(key))
+        {
+            ASSERT_EQ(nullptr, table.find(key)) << key;
+        }
+    }
+}
+} // namespace
+
+TEST(id_table_t, EmptyTableMissesEverything)
+{
+    table_t table;
+    uint32_t seed = 0;
+    ASSERT_TRUE(table_t::plan(nullptr, 0, seed));
+    table.commit(seed, nullptr, nullptr, 0);
+    for (uint32_t id = 0; id < 0x800; id++)
+    {
+        ASSERT_EQ(nullptr, table.find(id));
+    }
+    EXPECT_EQ(nullptr, table.find(table_t::INVALID_KEY));
+}
+
+TEST(id_table_t, RejectsOversizedAndDuplicateSets)
+{
+    std::vector<uint32_t> ids(SLOTS + 1);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        ids[i] = static_cast<uint32_t>(i);
+    }
+    uint32_t seed = 0;
+    EXPECT_FALSE(table_t::plan(ids.data(), ids.size(), seed));
+
+    const uint32_t dup[] = {0x201, 0x202, 0x201};
+    EXPECT_FALSE(table_t::plan(dup, 3, seed));
+}
+
+// DJI motor feedback IDs as the drivers register them
+TEST(id_table_t, PlansMotorFeedbackIds)
+{
+    std::mt19937 rng(1);
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0x201; id <= 0x20B; id++)
+    {
+        ids.push_back(id);
+    }
+    expect_planned(ids, 0x7FF, rng);
+}
+
+// The seed search must succeed for any full set of standard IDs, not just
+// for clustered ones
+TEST(id_table_t, PlansRandomFullStandardSets)
+{
+    std::mt19937 rng(2);
+    for (int set = 0; set < 2000; set++)
+    {
+        expect_planned(random_ids(rng, MAX_IDS, 0x7FF), 0x7FF, rng);
+    }
+}
+
+TEST(id_table_t, PlansRandomFullExtendedSets)
+{
+    std::mt19937 rng(3);
+    for (int set = 0; set < 500; set++)
+    {
+        expect_planned(random_ids(rng, MAX_IDS, 0x1FFFFFFF), 0x1FFFFFFF, rng);
+    }
+}
+
+// Registration grows the set one ID at a time; every prefix must plan
+TEST(id_table_t, PlansEveryPrefix)
+{
+    std::mt19937 rng(4);
+    for (int set = 0; set < 100; set++)
+    {
+        const std::vector<uint32_t> ids = random_ids(rng, MAX_IDS, 0x7FF);
+        for (size_t n = 1; n <= ids.size(); n++)
+        {
+            expect_planned(std::vector<uint32_t>(ids.begin(), ids.begin() + n),
+                           0x7FF, rng);
+        }
+    }
+}
@@ -0,0 +1,337 @@
+#include "pyro_core_config.h"
+#include "pyro_mem_region.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// pyro_mem_region.c and pyro_tlsf.c are built with the sizes CMakeLists.txt
+// sets: DTCM, D2 and D3 enabled, AXI disabled like in the firmware default.
+// The region heaps are process-wide, so every test frees what it allocates
+
+namespace
+{
+int suspend_depth  = 0;
+int suspend_calls  = 0;
+int suspend_unpair = 0;
+
+constexpr size_t REGION_SIZE[PYRO_MEM_REGION_NUM] = {
+    PYRO_MEM_DTCM_HEAP_SIZE, PYRO_MEM_AXI_HEAP_SIZE, PYRO_MEM_D2_HEAP_SIZE,
+    PYRO_MEM_D3_HEAP_SIZE};
+
+static_assert(PYRO_MEM_AXI_HEAP_SIZE == 0, "the tests expect AXI disabled");
+static_assert(PYRO_MEM_DTCM_HEAP_SIZE > 0 && PYRO_MEM_D2_HEAP_SIZE > 0 &&
+                  PYRO_MEM_D3_HEAP_SIZE > 0,
+              "the tests expect DTCM, D2 and D3 enabled");
+
+HeapStats_t stats_of(const pyro_mem_region_t region)
+{
+    HeapStats_t stats;
+    vPortGetRegionHeapStats(region, &stats);
+    return stats;
+}
+
+bool aligned(const void *p, const size_t alignment)
+{
+    return 0 == reinterpret_cast<uintptr_t>(p) % alignment;
+}
+
+struct mem_region_fixture_t : ::testing::Test
+{
+    std::vector<void *> live;
+
+    void SetUp() override
+    {
+        suspend_calls = 0;
+    }
+
+    void TearDown() override
+    {
+        for (void *p : live)
+        {
+            vPortFreeIn(p);
+        }
+        EXPECT_EQ(0, suspend_depth);
+        EXPECT_EQ(0, suspend_unpair);
+    }
+
+    void *keep(void *p)
+    {
+        if (p)
+        {
+            live.push_back(p);
+        }
+        return p;
+    }
+
+    // Fills `region` with blocks of `size` until it refuses one
+    void fill(const pyro_mem_region_t region, const size_t size)
+    {
+        while (keep(pvPortMallocIn(region, size)))
+        {
+        }
+    }
+};
+
+struct alignas(64) control_state_t
+{
+    float integral;
+    float last_error;
+    static int alive;
+
+    explicit control_state_t(const float i) : integral(i), last_error(0)
+    {
+        alive++;
+    }
+
+    ~control_state_t()
+    {
+        alive--;
+    }
+};
+
+int control_state_t::alive = 0;
+} // namespace
+
+extern "C" void vTaskSuspendAll(void)
+{
+    suspend_depth++;
+    suspend_calls++;
+}
+
+extern "C" BaseType_t xTaskResumeAll(void)
+{
+    if (0 == suspend_depth)
+    {
+        suspend_unpair++;
+    }
+    else
+    {
+        suspend_depth--;
+    }
+    return pdFALSE;
+}
+
+TEST_F(mem_region_fixture_t, AllocationsLandInTheirRegion)
+{
+    for (const pyro_mem_region_t region : {PYRO_MEM_DTCM, PYRO_MEM_D2,
+                                           PYRO_MEM_D3})
+    {
+        for (const size_t size : {1, 8, 100, 512})
+        {
+            void *p = keep(pvPortMallocIn(region, size));
+            ASSERT_NE(nullptr, p) << pcPortMemRegionName(region);
+            EXPECT_EQ(region, xPortMemRegionOf(p));
+            EXPECT_EQ(region, xPortMemRegionOf(static_cast<uint8_t *>(p) +
+                                               size - 1));
+            EXPECT_TRUE(aligned(p, portBYTE_ALIGNMENT));
+        }
+    }
+    EXPECT_GT(suspend_calls, 0);
+}
+
+TEST_F(mem_region_fixture_t, AlignedAllocationsHonourTheAlignment)
+{
+    for (const size_t alignment : {1, 4, 16, 32, 64, 256})
+    {
+        void *p = keep(pvPortMallocInAligned(PYRO_MEM_D2, 40, alignment));
+        ASSERT_NE(nullptr, p) << alignment;
+        EXPECT_TRUE(aligned(p, std::max<size_t>(alignment,
+                                                portBYTE_ALIGNMENT)));
+        EXPECT_EQ(PYRO_MEM_D2, xPortMemRegionOf(p));
+    }
+}
+
+TEST_F(mem_region_fixture_t, DisabledRegionReturnsNull)
+{
+    EXPECT_EQ(nullptr, pvPortMallocIn(PYRO_MEM_AXI, 16));
+    EXPECT_EQ(nullptr, pvPortMallocInAligned(PYRO_MEM_AXI, 16, 64));
+
+    const HeapStats_t stats = stats_of(PYRO_MEM_AXI);
+    EXPECT_EQ(0u, stats.xAvailableHeapSpaceInBytes);
+    EXPECT_EQ(0u, stats.xNumberOfSuccessfulAllocations);
+}
+
+TEST_F(mem_region_fixture_t, OversizedRequestFails)
+{
+    EXPECT_EQ(nullptr, pvPortMallocIn(PYRO_MEM_D3, PYRO_MEM_D3_HEAP_SIZE));
+    EXPECT_EQ(nullptr, pvPortMallocIn(PYRO_MEM_DTCM, SIZE_MAX / 2));
+}
+
+TEST_F(mem_region_fixture_t, AttributesPickTheFirstMatchingRegion)
+{
+    // Registration order is DTCM, AXI, D2, D3; AXI is skipped as disabled
+    const struct
+    {
+        uint32_t attr;
+        pyro_mem_region_t region;
+    } cases[] = {
+        {0, PYRO_MEM_DTCM},
+        {PYRO_MEM_ATTR_FAST, PYRO_MEM_DTCM},
+        {PYRO_MEM_ATTR_DMA, PYRO_MEM_D2},
+        {PYRO_MEM_ATTR_DMA | PYRO_MEM_ATTR_CACHEABLE, PYRO_MEM_D2},
+        {PYRO_MEM_ATTR_BDMA, PYRO_MEM_D3},
+        {PYRO_MEM_ATTR_DMA | PYRO_MEM_ATTR_BDMA, PYRO_MEM_D3},
+    };
+    for (const auto &c : cases)
+    {
+        void *p = keep(pvPortMallocWithAttr(c.attr, 32));
+        ASSERT_NE(nullptr, p) << c.attr;
+        EXPECT_EQ(c.region, xPortMemRegionOf(p)) << c.attr;
+        EXPECT_EQ(c.attr, ulPortMemRegionAttr(c.region) & c.attr);
+    }
+
+    // No region is both zero-wait and DMA-reachable
+    EXPECT_EQ(nullptr,
+              pvPortMallocWithAttr(PYRO_MEM_ATTR_FAST | PYRO_MEM_ATTR_DMA, 32));
+}
+
+TEST_F(mem_region_fixture_t, AttributesFallBackWhenARegionIsFull)
+{
+    fill(PYRO_MEM_D2, 256);
+    fill(PYRO_MEM_D2, 8);
+    ASSERT_EQ(nullptr, pvPortMallocIn(PYRO_MEM_D2, 8));
+
+    void *p = keep(pvPortMallocWithAttr(PYRO_MEM_ATTR_DMA, 64));
+    ASSERT_NE(nullptr, p);
+    EXPECT_EQ(PYRO_MEM_D3, xPortMemRegionOf(p));
+
+    // FAST has nowhere else to go
+    fill(PYRO_MEM_DTCM, 8);
+    EXPECT_EQ(nullptr, pvPortMallocWithAttr(PYRO_MEM_ATTR_FAST, 8));
+}
+
+TEST_F(mem_region_fixture_t, FreeFindsTheRegionByAddress)
+{
+    void *dtcm = pvPortMallocIn(PYRO_MEM_DTCM, 64);
+    void *d2   = pvPortMallocIn(PYRO_MEM_D2, 64);
+    void *d3   = pvPortMallocWithAttr(PYRO_MEM_ATTR_BDMA, 64);
+    ASSERT_TRUE(dtcm && d2 && d3);
+
+    const HeapStats_t before[] = {stats_of(PYRO_MEM_DTCM),
+                                  stats_of(PYRO_MEM_D2), stats_of(PYRO_MEM_D3)};
+    vPortFreeIn(d2);
+    EXPECT_EQ(before[0].xNumberOfSuccessfulFrees,
+              stats_of(PYRO_MEM_DTCM).xNumberOfSuccessfulFrees);
+    EXPECT_EQ(before[1].xNumberOfSuccessfulFrees + 1,
+              stats_of(PYRO_MEM_D2).xNumberOfSuccessfulFrees);
+    EXPECT_GT(stats_of(PYRO_MEM_D2).xAvailableHeapSpaceInBytes,
+              before[1].xAvailableHeapSpaceInBytes);
+    EXPECT_EQ(before[2].xNumberOfSuccessfulFrees,
+              stats_of(PYRO_MEM_D3).xNumberOfSuccessfulFrees);
+
+    vPortFreeIn(d3);
+    vPortFreeIn(dtcm);
+    EXPECT_EQ(before[0].xNumberOfSuccessfulFrees + 1,
+              stats_of(PYRO_MEM_DTCM).xNumberOfSuccessfulFrees);
+    EXPECT_EQ(before[2].xNumberOfSuccessfulFrees + 1,
+              stats_of(PYRO_MEM_D3).xNumberOfSuccessfulFrees);
+
+    vPortFreeIn(nullptr);
+}
+
+TEST_F(mem_region_fixture_t, ForeignAddressesBelongToNoRegion)
+{
+    int on_stack = 0;
+    std::vector<uint8_t> on_heap(16);
+    EXPECT_EQ(PYRO_MEM_REGION_NONE, xPortMemRegionOf(&on_stack));
+    EXPECT_EQ(PYRO_MEM_REGION_NONE, xPortMemRegionOf(on_heap.data()));
+    EXPECT_EQ(PYRO_MEM_REGION_NONE, xPortMemRegionOf(nullptr));
+
+    EXPECT_STREQ("NONE", pcPortMemRegionName(PYRO_MEM_REGION_NONE));
+    EXPECT_EQ(0u, ulPortMemRegionAttr(PYRO_MEM_REGION_NONE));
+    EXPECT_EQ(0u, stats_of(PYRO_MEM_REGION_NONE).xAvailableHeapSpaceInBytes);
+}
+
+TEST_F(mem_region_fixture_t, NewInConstructsAlignedAndDeleteInReleases)
+{
+    const size_t frees = stats_of(PYRO_MEM_DTCM).xNumberOfSuccessfulFrees;
+
+    control_state_t *state = pyro::new_in<control_state_t>(PYRO_MEM_DTCM, 2.5f);
+    ASSERT_NE(nullptr, state);
+    EXPECT_TRUE(aligned(state, alignof(control_state_t)));
+    EXPECT_EQ(PYRO_MEM_DTCM, xPortMemRegionOf(state));
+    EXPECT_EQ(2.5f, state->integral);
+    EXPECT_EQ(1, control_state_t::alive);
+
+    pyro::delete_in(state);
+    EXPECT_EQ(0, control_state_t::alive);
+    EXPECT_EQ(frees + 1, stats_of(PYRO_MEM_DTCM).xNumberOfSuccessfulFrees);
+
+    EXPECT_EQ(nullptr, pyro::new_in<control_state_t>(PYRO_MEM_AXI, 0.0f));
+    EXPECT_EQ(0, control_state_t::alive);
+    pyro::delete_in<control_state_t>(nullptr);
+}
+
+TEST_F(mem_region_fixture_t, RandomTrafficStaysInsideItsRegion)
+{
+    struct block_t
+    {
+        uint8_t *ptr;
+        size_t size;
+        pyro_mem_region_t region;
+        uint8_t tag;
+    };
+
+    const pyro_mem_region_t regions[] = {PYRO_MEM_DTCM, PYRO_MEM_D2,
+                                         PYRO_MEM_D3};
+    size_t initial[PYRO_MEM_REGION_NUM] = {};
+    for (const pyro_mem_region_t region : regions)
+    {
+        // A region is set up by its first allocation
+        vPortFreeIn(pvPortMallocIn(region, 1));
+        initial[region] = stats_of(region).xAvailableHeapSpaceInBytes;
+    }
+
+    std::mt19937 rng(0x3E6);
+    std::vector<block_t> blocks;
+    for (int step = 0; step < 20000; step++)
+    {
+        if (!blocks.empty() && rng() % 2)
+        {
+            const size_t i      = rng() % blocks.size();
+            const block_t block = blocks[i];
+            for (size_t b = 0; b < block.size; b++)
+            {
+                ASSERT_EQ(block.tag, block.ptr[b]) << "step " << step;
+            }
+            vPortFreeIn(block.ptr);
+            blocks[i] = blocks.back();
+            blocks.pop_back();
+            continue;
+        }
+
+        const pyro_mem_region_t region = regions[rng() % 3];
+        const size_t size              = 1 + rng() % 200;
+        const size_t alignment         = size_t(1) << (rng() % 7);
+        auto *p = static_cast<uint8_t *>(
+            pvPortMallocInAligned(region, size, alignment));
+        if (!p)
+        {
+            continue;
+        }
+        ASSERT_EQ(region, xPortMemRegionOf(p));
+        ASSERT_EQ(region, xPortMemRegionOf(p + size - 1));
+        ASSERT_TRUE(aligned(p, std::max<size_t>(alignment,
+                                                portBYTE_ALIGNMENT)));
+        const uint8_t tag = static_cast<uint8_t>(rng());
+        std::fill(p, p + size, tag);
+        blocks.push_back({p, size, region, tag});
+    }
+    for (const block_t &block : blocks)
+    {
+        vPortFreeIn(block.ptr);
+    }
+
+    for (const pyro_mem_region_t region : regions)
+    {
+        const HeapStats_t stats = stats_of(region);
+        EXPECT_EQ(initial[region], stats.xAvailableHeapSpaceInBytes)
+            << pcPortMemRegionName(region);
+        EXPECT_EQ(1u, stats.xNumberOfFreeBlocks) << pcPortMemRegionName(region);
+        EXPECT_LE(stats.xAvailableHeapSpaceInBytes, REGION_SIZE[region]);
+    }
+}
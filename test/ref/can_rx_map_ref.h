@@ -0,0 +1,56 @@
+#ifndef __CAN_RX_MAP_REF_H__
+#define __CAN_RX_MAP_REF_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * The CAN RX lookup as it was before id_table_t (pyro_can_drv.cpp up to
+ * ce74b98^): registered buffers in a map_t, handle_rx_msg doing exist() and
+ * then operator[], i.e. two linear scans per frame. map_t was capped at 10
+ * entries; the capacity is a parameter here so it can hold 32 IDs.
+ */
+template <typename V, size_t N> class can_rx_map_ref_t
+{
+  public:
+    bool insert(const uint32_t key, const V value)
+    {
+        if (_size >= N || find(key) >= 0)
+        {
+            return false;
+        }
+        _keys[_size]   = key;
+        _values[_size] = value;
+        _size++;
+        return true;
+    }
+
+    V lookup(const uint32_t key) const
+    {
+        if (find(key) < 0)
+        {
+            return V();
+        }
+        return _values[find(key)];
+    }
+
+  private:
+    int find(const uint32_t key) const
+    {
+        for (size_t i = 0; i < _size; i++)
+        {
+            if (key == _keys[i])
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    size_t _size = 0;
+    std::array<uint32_t, N> _keys{};
+    std::array<V, N> _values{};
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef __CRC8_CRC16_REF_H__
+#define __CRC8_CRC16_REF_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The referee CRC-8/CRC-16 as they were before Component/CRC (CRC8_CRC16.c
+ * up to e186b9c^): bytewise loops over the hand-written DJI tables. Kept to
+ * cross-check and benchmark the slice-by-N kernels.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint8_t crc8_ref(const uint8_t *pch_message, uint32_t dw_length, uint8_t ucCRC8);
+uint16_t crc16_ref(const uint8_t *pchMessage, uint32_t dwLength, uint16_t wCRC);
+uint32_t verify_crc8_ref(const uint8_t *pch_message, uint32_t dw_length);
+uint32_t verify_crc16_ref(const uint8_t *pchMessage, uint32_t dwLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+#include "heap_4_ref.h"
+
+/* portBYTE_ALIGNMENT of the CM7 port */
+#define BYTE_ALIGNMENT      8
+#define BYTE_ALIGNMENT_MASK (BYTE_ALIGNMENT - 1)
+#define STRUCT_SIZE                                                            \
+    ((sizeof(heap_4_ref_link_t) + BYTE_ALIGNMENT_MASK) & ~(size_t)BYTE_ALIGNMENT_MASK)
+#define MINIMUM_BLOCK_SIZE  (STRUCT_SIZE << 1)
+#define ALLOCATED_BIT       ((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+static void insert_free(heap_4_ref_t *heap, heap_4_ref_link_t *block)
+{
+    heap_4_ref_link_t *it;
+    for (it = &heap->start; it->next_free < block && it->next_free != NULL;
+         it = it->next_free)
+    {
+    }
+
+    if ((uint8_t *)it + it->size == (uint8_t *)block)
+    {
+        it->size += block->size;
+        block = it;
+    }
+
+    if ((uint8_t *)block + block->size == (uint8_t *)it->next_free)
+    {
+        if (it->next_free != heap->end)
+        {
+            block->size += it->next_free->size;
+            block->next_free = it->next_free->next_free;
+        }
+        else
+        {
+            block->next_free = heap->end;
+        }
+    }
+    else
+    {
+        block->next_free = it->next_free;
+    }
+
+    if (it != block)
+    {
+        it->next_free = block;
+    }
+}
+
+void heap_4_ref_init(heap_4_ref_t *heap, void *mem, size_t size)
+{
+    size_t addr = (size_t)mem;
+    if (addr & BYTE_ALIGNMENT_MASK)
+    {
+        addr += BYTE_ALIGNMENT - 1;
+        addr &= ~(size_t)BYTE_ALIGNMENT_MASK;
+        size -= addr - (size_t)mem;
+    }
+    uint8_t *aligned = (uint8_t *)addr;
+
+    heap->start.next_free = (heap_4_ref_link_t *)aligned;
+    heap->start.size      = 0;
+
+    addr = (size_t)aligned + size - STRUCT_SIZE;
+    addr &= ~(size_t)BYTE_ALIGNMENT_MASK;
+    heap->end            = (heap_4_ref_link_t *)addr;
+    heap->end->size      = 0;
+    heap->end->next_free = NULL;
+
+    heap_4_ref_link_t *first = (heap_4_ref_link_t *)aligned;
+    first->size              = addr - (size_t)first;
+    first->next_free         = heap->end;
+    heap->free_bytes         = first->size;
+}
+
+void *heap_4_ref_malloc(heap_4_ref_t *heap, size_t size)
+{
+    if (0 == size || (size & ALLOCATED_BIT))
+    {
+        return NULL;
+    }
+    size += STRUCT_SIZE;
+    if (size & BYTE_ALIGNMENT_MASK)
+    {
+        size += BYTE_ALIGNMENT - (size & BYTE_ALIGNMENT_MASK);
+    }
+    if (size > heap->free_bytes)
+    {
+        return NULL;
+    }
+
+    heap_4_ref_link_t *prev  = &heap->start;
+    heap_4_ref_link_t *block = heap->start.next_free;
+    while (block->size < size && block->next_free != NULL)
+    {
+        prev  = block;
+        block = block->next_free;
+    }
+    if (block == heap->end)
+    {
+        return NULL;
+    }
+
+    void *ret       = (uint8_t *)block + STRUCT_SIZE;
+    prev->next_free = block->next_free;
+    if (block->size - size > MINIMUM_BLOCK_SIZE)
+    {
+        heap_4_ref_link_t *rest = (heap_4_ref_link_t *)((uint8_t *)block + size);
+        rest->size              = block->size - size;
+        block->size             = size;
+        insert_free(heap, rest);
+    }
+    heap->free_bytes -= block->size;
+    block->size |= ALLOCATED_BIT;
+    block->next_free = NULL;
+    return ret;
+}
+
+void heap_4_ref_free(heap_4_ref_t *heap, void *ptr)
+{
+    if (NULL == ptr)
+    {
+        return;
+    }
+    heap_4_ref_link_t *link = (heap_4_ref_link_t *)((uint8_t *)ptr - STRUCT_SIZE);
+    if (!(link->size & ALLOCATED_BIT) || link->next_free != NULL)
+    {
+        return;
+    }
+    link->size &= ~ALLOCATED_BIT;
+    heap->free_bytes += link->size;
+    insert_free(heap, link);
+}
+
+size_t heap_4_ref_largest_free(const heap_4_ref_t *heap)
+{
+    size_t largest = 0;
+    for (const heap_4_ref_link_t *b = heap->start.next_free; b != heap->end;
+         b = b->next_free)
+    {
+        largest = b->size > largest ? b->size : largest;
+    }
+    return largest;
+}
@@ -0,0 +1,40 @@
+#ifndef __HEAP_4_REF_H__
+#define __HEAP_4_REF_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The DMA heap as it was before pyro_tlsf (pyro_core_dma_heap.c up to
+ * 48e0ca7^): heap_4 first fit over an address-ordered free list, merging on
+ * insert. Made instance-based and stripped of locking/trace so the
+ * benchmarks can run it next to pyro_tlsf on the same pool size.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct heap_4_ref_link
+{
+    struct heap_4_ref_link *next_free;
+    size_t size;
+} heap_4_ref_link_t;
+
+typedef struct
+{
+    heap_4_ref_link_t start;
+    heap_4_ref_link_t *end;
+    size_t free_bytes;
+} heap_4_ref_t;
+
+void heap_4_ref_init(heap_4_ref_t *heap, void *mem, size_t size);
+void *heap_4_ref_malloc(heap_4_ref_t *heap, size_t size);
+void heap_4_ref_free(heap_4_ref_t *heap, void *ptr);
+size_t heap_4_ref_largest_free(const heap_4_ref_t *heap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef __UART_DISPATCH_REF_H__
+#define __UART_DISPATCH_REF_H__
+
+#include "FreeRTOS.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+/*
+ * The UART RX dispatch as it was before delegate_t (pyro_uart_drv.cpp up to
+ * 1e5e6e0^): drivers found through a std::map keyed by HAL handle, RX
+ * callbacks kept as std::function in a std::vector, the woken flag passed
+ * by value. HAL calls (DMA restart, yield) are left out.
+ */
+struct uart_dispatch_ref_t
+{
+    using rx_event_func = std::function<bool(
+        uint8_t *p, uint16_t size, BaseType_t xHigherPriorityTaskWoken)>;
+
+    struct rx_event_callback_t
+    {
+        uint32_t owner;
+        rx_event_func func;
+    };
+
+    struct drv_t
+    {
+        std::vector<rx_event_callback_t> rx_event_callbacks;
+        uint8_t *rx_buf[2];
+        uint8_t rx_buf_switch{};
+
+        void add_rx_event_callback(const rx_event_func &func,
+                                   const uint32_t owner)
+        {
+            rx_event_callback_t callback;
+            callback.owner = owner;
+            callback.func  = func;
+            rx_event_callbacks.push_back(callback);
+        }
+
+        bool remove_rx_event_callback(const uint32_t owner)
+        {
+            for (auto it = rx_event_callbacks.begin();
+                 it != rx_event_callbacks.end(); ++it)
+            {
+                if (it->owner == owner)
+                {
+                    rx_event_callbacks.erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    std::map<const void *, drv_t *> uart_map;
+
+    void rx_event(const void *huart, const uint16_t Size)
+    {
+        const auto it = uart_map.find(huart);
+        static BaseType_t xHigherPriorityTaskWoken;
+        if (it != uart_map.end() && it->second)
+        {
+            const auto drv = it->second;
+            for (auto &cb : drv->rx_event_callbacks)
+            {
+                if (cb.func(drv->rx_buf[drv->rx_buf_switch], Size,
+                            xHigherPriorityTaskWoken))
+                {
+                    drv->rx_buf_switch ^= 0x01U;
+                    break;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,199 @@
+// Referee RX drain: the in-place fifo_s_peek_block/fifo_s_discard consumer
+// against the fifo_s_gets copy-out loop it replaced.
+//
+// A stream of valid referee frames is cut into UART IDLE spans and queued
+// with fifo_s_puts, as referee_rx_handler does. After every span the task
+// drains the FIFO through the referee frame parser, as after each
+// notification. Reports throughput over the whole stream, and the latency
+// from the start of a drain to each frame's callback.
+//
+//   referee_rx_bench [frames]
+
+#include "fifo.h"
+#include "frame_parser.h"
+#include "pyro_crc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+// REFEREE_FIFO_BUF_LENGTH and REF_PROTOCOL_FRAME_MAX_SIZE
+constexpr int FIFO_LEN            = 1024;
+constexpr uint16_t REF_MAX_FRAME  = 128;
+constexpr uint8_t REF_SOF         = 0xA5;
+constexpr uint16_t REF_HEADER     = 5;
+constexpr uint16_t REF_OVERHEAD   = 9;
+constexpr uint32_t MAX_SPAN       = 64;
+
+bool crc8_check(const uint8_t *p, const uint16_t len)
+{
+    return pyro::crc8_verify(p, len);
+}
+
+bool crc16_check(const uint8_t *p, const uint16_t len)
+{
+    return pyro::crc16_verify(p, len);
+}
+
+// As in referee_drv.cpp
+constexpr pyro::frame_format_t referee_format = {
+    {REF_SOF, 0x00}, 1,           REF_HEADER,   1,          2,
+    REF_OVERHEAD,    0,           REF_OVERHEAD, crc8_check, crc16_check,
+};
+
+using clock_t_ = std::chrono::steady_clock;
+
+std::vector<uint8_t> make_stream(std::mt19937 &rng, const size_t frames)
+{
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i < frames; i++)
+    {
+        const uint16_t data_len = rng() % (REF_MAX_FRAME - REF_OVERHEAD + 1);
+        std::vector<uint8_t> f(data_len + REF_OVERHEAD);
+        f[0] = REF_SOF;
+        f[1] = static_cast<uint8_t>(data_len);
+        f[2] = static_cast<uint8_t>(data_len >> 8);
+        f[3] = static_cast<uint8_t>(i);
+        pyro::crc8_append(f.data(), REF_HEADER);
+        for (size_t k = REF_HEADER; k < f.size() - 2; k++)
+        {
+            f[k] = static_cast<uint8_t>(rng());
+        }
+        pyro::crc16_append(f.data(), f.size());
+        out.insert(out.end(), f.begin(), f.end());
+    }
+    return out;
+}
+
+struct result_t
+{
+    double bytes_per_us;
+    std::vector<uint32_t> latency_ns;
+    size_t frames;
+};
+
+template <typename drain_t>
+result_t run(const std::vector<uint8_t> &stream,
+             const std::vector<uint32_t> &spans, drain_t &&drain)
+{
+    std::vector<char> storage(FIFO_LEN);
+    fifo_s_t fifo;
+    fifo_s_init(&fifo, storage.data(), FIFO_LEN);
+    pyro::frame_parser_t<REF_MAX_FRAME> parser(referee_format);
+    result_t res{};
+    res.latency_ns.reserve(stream.size() / REF_OVERHEAD);
+    uint32_t checksum = 0;
+
+    size_t pos                 = 0;
+    clock_t_::duration drained = clock_t_::duration::zero();
+    for (const uint32_t span : spans)
+    {
+        fifo_s_puts(&fifo, reinterpret_cast<char *>(
+                               const_cast<uint8_t *>(stream.data() + pos)),
+                    static_cast<int>(span));
+        pos += span;
+
+        const auto t0 = clock_t_::now();
+        drain(fifo, parser, [&](const uint8_t *frame, uint16_t len) {
+            checksum += frame[3] + len;
+            res.latency_ns.push_back(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_t_::now() - t0)
+                    .count()));
+        });
+        drained += clock_t_::now() - t0;
+    }
+    res.frames       = parser.stats().frames;
+    res.bytes_per_us = static_cast<double>(pos) /
+                       std::chrono::duration<double, std::micro>(drained).count();
+    if (checksum == 1)
+    {
+        std::printf("?\n");
+    }
+    return res;
+}
+
+// referee_unpack_fifo_data as it was before 3d18f54
+template <typename F>
+void drain_gets(fifo_s_t &fifo, pyro::frame_parser_t<REF_MAX_FRAME> &parser,
+                F &&on_frame)
+{
+    uint8_t chunk[REF_MAX_FRAME];
+    int len;
+    while ((len = fifo_s_gets(&fifo, reinterpret_cast<char *>(chunk),
+                              sizeof(chunk))) > 0)
+    {
+        parser.feed(chunk, static_cast<size_t>(len), on_frame);
+    }
+}
+
+// referee_unpack_fifo_data now
+template <typename F>
+void drain_peek(fifo_s_t &fifo, pyro::frame_parser_t<REF_MAX_FRAME> &parser,
+                F &&on_frame)
+{
+    char *block;
+    int len;
+    while ((len = fifo_s_peek_block(&fifo, &block)) > 0)
+    {
+        parser.feed(reinterpret_cast<const uint8_t *>(block),
+                    static_cast<size_t>(len), on_frame);
+        fifo_s_discard(&fifo, len);
+    }
+}
+
+uint32_t percentile(std::vector<uint32_t> &v, const double p)
+{
+    if (v.empty())
+    {
+        return 0;
+    }
+    const size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+void report(const char *name, result_t &r)
+{
+    std::printf("  %-5s %7.1f B/us | frame latency p50 %5u p99 %6u max %7u "
+                "ns | %zu frames\n",
+                name, r.bytes_per_us, percentile(r.latency_ns, 0.5),
+                percentile(r.latency_ns, 0.99), percentile(r.latency_ns, 1.0),
+                r.frames);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t frames =
+        argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 2000000;
+    std::mt19937 rng(1);
+    const std::vector<uint8_t> stream = make_stream(rng, frames);
+
+    std::vector<uint32_t> spans;
+    for (size_t left = stream.size(); left;)
+    {
+        const uint32_t span =
+            std::min<uint32_t>(1 + rng() % MAX_SPAN, static_cast<uint32_t>(left));
+        spans.push_back(span);
+        left -= span;
+    }
+
+    std::printf("%zu frames, %zu bytes in spans of 1-%u B\n", frames,
+                stream.size(), MAX_SPAN);
+    auto gets = [](fifo_s_t &f, pyro::frame_parser_t<REF_MAX_FRAME> &p,
+                   auto &&cb) { drain_gets(f, p, cb); };
+    auto peek = [](fifo_s_t &f, pyro::frame_parser_t<REF_MAX_FRAME> &p,
+                   auto &&cb) { drain_peek(f, p, cb); };
+    result_t old_res = run(stream, spans, gets);
+    result_t new_res = run(stream, spans, peek);
+    report("gets", old_res);
+    report("peek", new_res);
+    return old_res.frames == frames && new_res.frames == frames ? 0 : 1;
+}
@@ -0,0 +1,426 @@
+#include "referee_tx_sched.h"
+
+#include "crc8_crc16_ref.h"
+#include "protocol.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace
+{
+using sched_t = pyro::referee_tx_sched_t;
+
+// pyro_core_config.h: REFEREE_TX_RATE, _BURST and _MIN_INTERVAL_MS
+constexpr sched_t::config_t CONFIG = {3000, 256, 34};
+constexpr uint16_t ROBOT_ID        = 3;
+constexpr uint16_t CLIENT_ID       = 0x0100 + ROBOT_ID;
+
+constexpr uint8_t OP_ADD    = 1;
+constexpr uint8_t OP_MODIFY = 2;
+constexpr uint8_t OP_DELETE = 3;
+
+constexpr uint16_t FIGURE_SIZE = sizeof(pyro::ui_figure_t);
+constexpr uint16_t TEXT_FRAME  = sched_t::FRAME_OVERHEAD + FIGURE_SIZE +
+                                sched_t::MAX_TEXT_LEN;
+
+pyro::ui_figure_t figure(const uint8_t id, const uint16_t x = 100)
+{
+    pyro::ui_figure_t f{};
+    f.name[0]      = 'f';
+    f.name[1]      = id;
+    f.name[2]      = 0;
+    f.operate_type = 7; // ignored, the scheduler fills it in
+    f.figure_type  = 1;
+    f.layer        = 2;
+    f.color        = 3;
+    f.width        = 4;
+    f.start_x      = x;
+    f.start_y      = 200;
+    return f;
+}
+
+uint16_t get_u16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// One emitted 0x0301 frame, checked against the reference CRC code
+struct frame_t
+{
+    uint8_t seq;
+    uint16_t data_cmd_id;
+    uint16_t sender;
+    uint16_t receiver;
+    std::vector<uint8_t> content;
+
+    pyro::ui_figure_t figure(const size_t i) const
+    {
+        pyro::ui_figure_t f;
+        memcpy(&f, content.data() + i * FIGURE_SIZE, FIGURE_SIZE);
+        return f;
+    }
+};
+
+struct referee_tx_sched_fixture_t : ::testing::Test
+{
+    sched_t sched{CONFIG};
+    uint32_t now = 1000;
+    std::array<uint8_t, sched_t::FRAME_MAX_SIZE + 8> buf{};
+    uint16_t len = 0;
+
+    void SetUp() override
+    {
+        sched.set_robot_id(ROBOT_ID);
+    }
+
+    // Polls at the current time; a frame must come out and be well-formed
+    frame_t poll_frame(sched_t &s)
+    {
+        buf.fill(0xEE);
+        len = s.poll(now, buf.data());
+        frame_t f{};
+        [&] {
+            ASSERT_GE(len, sched_t::FRAME_OVERHEAD);
+            ASSERT_LE(len, sched_t::FRAME_MAX_SIZE);
+            ASSERT_EQ(0xEE, buf[len]) << "wrote past the frame";
+            ASSERT_EQ(HEADER_SOF, buf[0]);
+            ASSERT_EQ(len - 9u, get_u16(buf.data() + 1));
+            ASSERT_TRUE(verify_crc8_ref(buf.data(), 5));
+            ASSERT_TRUE(verify_crc16_ref(buf.data(), len));
+            ASSERT_EQ(STUDENT_INTERACTIVE_DATA_CMD_ID, get_u16(buf.data() + 5));
+        }();
+        f.seq         = buf[3];
+        f.data_cmd_id = get_u16(buf.data() + 7);
+        f.sender      = get_u16(buf.data() + 9);
+        f.receiver    = get_u16(buf.data() + 11);
+        f.content.assign(buf.begin() + 13, buf.begin() + len - 2);
+        return f;
+    }
+
+    frame_t poll_frame()
+    {
+        return poll_frame(sched);
+    }
+
+    uint16_t poll()
+    {
+        return sched.poll(now, buf.data());
+    }
+
+    // Waits out the minimum interval and any token debt
+    void later(const uint32_t ms = 1000)
+    {
+        now += ms;
+    }
+};
+} // namespace
+
+TEST_F(referee_tx_sched_fixture_t, NothingIsSentWithoutARobotId)
+{
+    sched_t fresh(CONFIG);
+    ASSERT_EQ(pyro::PYRO_OK, fresh.set_figure(figure(1), 0));
+    EXPECT_EQ(0u, fresh.poll(now, buf.data()));
+    EXPECT_TRUE(fresh.pending());
+    fresh.set_robot_id(ROBOT_ID);
+    EXPECT_NE(0u, fresh.poll(now, buf.data()));
+    EXPECT_FALSE(fresh.pending());
+}
+
+TEST_F(referee_tx_sched_fixture_t, FiguresAreBatchedIn1257WithPadding)
+{
+    const struct
+    {
+        uint8_t num;
+        uint8_t group;
+        uint16_t cmd;
+    } cases[] = {
+        {1, 1, pyro::REFEREE_UI_FIGURE1_CMD},
+        {2, 2, pyro::REFEREE_UI_FIGURE2_CMD},
+        {3, 5, pyro::REFEREE_UI_FIGURE5_CMD},
+        {5, 5, pyro::REFEREE_UI_FIGURE5_CMD},
+        {6, 7, pyro::REFEREE_UI_FIGURE7_CMD},
+        {7, 7, pyro::REFEREE_UI_FIGURE7_CMD},
+    };
+    for (const auto &c : cases)
+    {
+        sched_t s(CONFIG);
+        s.set_robot_id(ROBOT_ID);
+        for (uint8_t i = 0; i < c.num; i++)
+        {
+            ASSERT_EQ(pyro::PYRO_OK, s.set_figure(figure(i, 10 + i), 0));
+        }
+        const frame_t f = poll_frame(s);
+        ASSERT_EQ(c.cmd, f.data_cmd_id) << int(c.num);
+        EXPECT_EQ(ROBOT_ID, f.sender);
+        EXPECT_EQ(CLIENT_ID, f.receiver);
+        ASSERT_EQ(c.group * FIGURE_SIZE, f.content.size());
+        for (uint8_t i = 0; i < c.num; i++)
+        {
+            const pyro::ui_figure_t got = f.figure(i);
+            EXPECT_EQ(i, got.name[1]);
+            EXPECT_EQ(OP_ADD, got.operate_type);
+            EXPECT_EQ(10u + i, got.start_x);
+        }
+        // No-op padding: all zero, so operate_type 0
+        for (size_t i = c.num * FIGURE_SIZE; i < f.content.size(); i++)
+        {
+            ASSERT_EQ(0, f.content[i]) << int(c.num);
+        }
+    }
+}
+
+TEST_F(referee_tx_sched_fixture_t, MoreThanSevenFiguresTakeSeveralFrames)
+{
+    for (uint8_t i = 0; i < 9; i++)
+    {
+        sched.set_figure(figure(i), 0);
+    }
+    EXPECT_EQ(pyro::REFEREE_UI_FIGURE7_CMD, poll_frame().data_cmd_id);
+    later();
+    const frame_t second = poll_frame();
+    EXPECT_EQ(pyro::REFEREE_UI_FIGURE2_CMD, second.data_cmd_id);
+    EXPECT_EQ(7, second.figure(0).name[1]);
+    EXPECT_EQ(8, second.figure(1).name[1]);
+    EXPECT_EQ(9u, sched.get_stats().figures);
+}
+
+TEST_F(referee_tx_sched_fixture_t, UnchangedFiguresAreDropped)
+{
+    sched.set_figure(figure(1, 100), 0);
+    poll_frame();
+    later();
+
+    ASSERT_EQ(pyro::PYRO_OK, sched.set_figure(figure(1, 100), 0));
+    EXPECT_EQ(1u, sched.get_stats().unchanged);
+    EXPECT_FALSE(sched.pending());
+    EXPECT_EQ(0u, poll());
+
+    // operate_type is not part of the comparison
+    pyro::ui_figure_t same = figure(1, 100);
+    same.operate_type      = OP_DELETE;
+    sched.set_figure(same, 0);
+    EXPECT_EQ(2u, sched.get_stats().unchanged);
+
+    sched.set_figure(figure(1, 101), 0);
+    const frame_t f = poll_frame();
+    EXPECT_EQ(OP_MODIFY, f.figure(0).operate_type);
+    EXPECT_EQ(101u, f.figure(0).start_x);
+}
+
+TEST_F(referee_tx_sched_fixture_t, TextsGoOutOnePerFrame)
+{
+    const char hello[] = "hello";
+    ASSERT_EQ(pyro::PYRO_OK, sched.set_text(figure(1), hello, 5, 0));
+    ASSERT_EQ(pyro::PYRO_OK, sched.set_text(figure(2), hello, 5, 0));
+    const frame_t f = poll_frame();
+    EXPECT_EQ(pyro::REFEREE_UI_CHAR_CMD, f.data_cmd_id);
+    ASSERT_EQ(TEXT_FRAME, len);
+    EXPECT_EQ(5u, f.figure(0).details_b);
+    EXPECT_EQ(0, memcmp(f.content.data() + FIGURE_SIZE, "hello\0", 6));
+    EXPECT_TRUE(sched.pending());
+
+    EXPECT_EQ(pyro::PYRO_PARAM_ERROR,
+              sched.set_text(figure(3), hello, sched_t::MAX_TEXT_LEN + 1, 0));
+}
+
+TEST_F(referee_tx_sched_fixture_t, PriorityPicksTheFrameAndMessagesWinTies)
+{
+    const uint8_t data[4] = {1, 2, 3, 4};
+    sched.set_figure(figure(1), 2);
+    sched.post(0x0200, 7, data, sizeof(data), 1);
+    sched.set_text(figure(2), "t", 1, 0);
+    sched.set_figure(figure(3), 1);
+
+    EXPECT_EQ(pyro::REFEREE_UI_CHAR_CMD, poll_frame().data_cmd_id);
+    later();
+    const frame_t msg = poll_frame();
+    EXPECT_EQ(0x0200, msg.data_cmd_id);
+    EXPECT_EQ(7, msg.receiver);
+    EXPECT_EQ(std::vector<uint8_t>(data, data + 4), msg.content);
+    later();
+    // Both figures fit one batch, the better priority first
+    const frame_t figures = poll_frame();
+    EXPECT_EQ(pyro::REFEREE_UI_FIGURE2_CMD, figures.data_cmd_id);
+    EXPECT_EQ(3, figures.figure(0).name[1]);
+    EXPECT_EQ(1, figures.figure(1).name[1]);
+}
+
+TEST_F(referee_tx_sched_fixture_t, EqualMessagesLeaveInFifoOrder)
+{
+    for (uint8_t i = 0; i < sched_t::MAX_MSG_NUM; i++)
+    {
+        ASSERT_EQ(pyro::PYRO_OK, sched.post(0x0200 + i, 7, &i, 1, 1));
+    }
+    const uint8_t extra = 0xFF;
+    EXPECT_EQ(pyro::PYRO_NO_MEMORY, sched.post(0x0300, 7, &extra, 1, 0));
+    EXPECT_EQ(1u, sched.get_stats().msg_dropped);
+
+    // A better priority jumps the queue, the rest keep their order
+    for (uint8_t i = 0; i < sched_t::MAX_MSG_NUM; i++)
+    {
+        const frame_t f = poll_frame();
+        EXPECT_EQ(0x0200 + i, f.data_cmd_id);
+        if (0 == i)
+        {
+            sched.post(0x0301, 7, &extra, 1, 0);
+            later();
+            EXPECT_EQ(0x0301, poll_frame().data_cmd_id);
+        }
+        later();
+    }
+    EXPECT_FALSE(sched.pending());
+}
+
+TEST_F(referee_tx_sched_fixture_t, RemoveDeletesAndResyncAddsAgain)
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        sched.set_figure(figure(i), 0);
+    }
+    poll_frame();
+    later();
+
+    const uint8_t name[3] = {'f', 1, 0};
+    ASSERT_EQ(pyro::PYRO_OK, sched.remove(name));
+    const frame_t del = poll_frame();
+    EXPECT_EQ(pyro::REFEREE_UI_FIGURE1_CMD, del.data_cmd_id);
+    EXPECT_EQ(OP_DELETE, del.figure(0).operate_type);
+    EXPECT_EQ(pyro::PYRO_NOT_FOUND, sched.remove(name));
+    later();
+
+    sched.resync();
+    const frame_t again = poll_frame();
+    EXPECT_EQ(pyro::REFEREE_UI_FIGURE2_CMD, again.data_cmd_id);
+    EXPECT_EQ(0, again.figure(0).name[1]);
+    EXPECT_EQ(2, again.figure(1).name[1]);
+    EXPECT_EQ(OP_ADD, again.figure(0).operate_type);
+    EXPECT_EQ(OP_ADD, again.figure(1).operate_type);
+}
+
+TEST_F(referee_tx_sched_fixture_t, ResyncDropsAPendingDelete)
+{
+    sched.set_figure(figure(1), 0);
+    poll_frame();
+    later();
+    const uint8_t name[3] = {'f', 1, 0};
+    sched.remove(name);
+    sched.resync();
+    EXPECT_FALSE(sched.pending());
+}
+
+TEST_F(referee_tx_sched_fixture_t, NewRobotIdResyncs)
+{
+    sched.set_figure(figure(1), 0);
+    poll_frame();
+    later();
+    sched.set_robot_id(ROBOT_ID + 100);
+    const frame_t f = poll_frame();
+    EXPECT_EQ(ROBOT_ID + 100, f.sender);
+    EXPECT_EQ(0x0100 + ROBOT_ID + 100, f.receiver);
+    EXPECT_EQ(OP_ADD, f.figure(0).operate_type);
+}
+
+TEST_F(referee_tx_sched_fixture_t, MinIntervalSpacesFrames)
+{
+    const uint8_t data = 0;
+    sched.post(0x0200, 7, &data, 1, 0);
+    sched.post(0x0201, 7, &data, 1, 0);
+    poll_frame();
+    now += CONFIG.min_interval - 1;
+    EXPECT_EQ(0u, poll());
+    now += 1;
+    EXPECT_EQ(0x0201, poll_frame().data_cmd_id);
+}
+
+TEST_F(referee_tx_sched_fixture_t, SequenceNumbersIncrementAndWrap)
+{
+    const uint8_t data = 0;
+    for (int i = 0; i < 300; i++)
+    {
+        sched.post(0x0200, 7, &data, 1, 0);
+        ASSERT_EQ(static_cast<uint8_t>(i), poll_frame().seq);
+        later();
+    }
+}
+
+TEST_F(referee_tx_sched_fixture_t, ByteRateStaysUnderTheCap)
+{
+    // Keep the queue full of the largest messages and poll every tick for a
+    // minute across a clock wrap; every window must fit burst + rate * t
+    std::array<uint8_t, sched_t::MAX_MSG_LEN> data{};
+    std::deque<std::pair<uint32_t, uint16_t>> sent;
+    uint32_t total         = 0;
+    uint32_t last_frame_at = 0;
+    bool first             = true;
+    now                    = 0xFFFFFFFF - 30000;
+    const uint32_t start   = now;
+    for (uint32_t t = 0; t < 60000; t++, now++)
+    {
+        while (pyro::PYRO_OK ==
+               sched.post(0x0200, 7, data.data(), data.size(), 0))
+        {
+        }
+        const uint16_t n = poll();
+        if (0 == n)
+        {
+            continue;
+        }
+        ASSERT_EQ(sched_t::FRAME_MAX_SIZE, n);
+        if (!first)
+        {
+            ASSERT_GE(now - last_frame_at, CONFIG.min_interval);
+        }
+        first         = false;
+        last_frame_at = now;
+        total += n;
+        sent.emplace_back(now, n);
+
+        uint32_t window = 0;
+        for (auto it = sent.rbegin(); it != sent.rend(); ++it)
+        {
+            window += it->second;
+            const uint32_t span = now - it->first;
+            ASSERT_LE(window * 1000, CONFIG.burst * 1000 + CONFIG.rate * span)
+                << "window of " << span << " ms";
+        }
+        while (sent.size() > 64)
+        {
+            sent.pop_front();
+        }
+    }
+    const uint32_t elapsed = now - start;
+    EXPECT_LE(total, CONFIG.burst + CONFIG.rate * elapsed / 1000);
+    // and the budget is actually used
+    EXPECT_GE(total, CONFIG.rate * elapsed / 1000 * 9 / 10);
+    EXPECT_GT(sched.get_stats().deferred, 0u);
+    EXPECT_EQ(total, sched.get_stats().bytes);
+}
+
+TEST_F(referee_tx_sched_fixture_t, LongIdleRefillsOnlyToTheBurst)
+{
+    // No minimum interval, so only the bucket holds frames back
+    sched_t s({CONFIG.rate, CONFIG.burst, 0});
+    s.set_robot_id(ROBOT_ID);
+    std::array<uint8_t, sched_t::MAX_MSG_LEN> data{};
+    EXPECT_EQ(0u, s.poll(now, buf.data()));
+    now += 3600 * 1000;
+    for (int i = 0; i < 3; i++)
+    {
+        s.post(0x0200, 7, data.data(), data.size(), 0);
+    }
+    // 256 bytes of burst hold two 127-byte frames, the third waits for
+    // 127 - 2 bytes at 3 bytes/ms
+    poll_frame(s);
+    poll_frame(s);
+    EXPECT_EQ(0u, s.poll(now, buf.data()));
+    EXPECT_EQ(1u, s.get_stats().deferred);
+    now += 41;
+    EXPECT_EQ(0u, s.poll(now, buf.data()));
+    now += 1;
+    poll_frame(s);
+}
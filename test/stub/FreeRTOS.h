@@ -0,0 +1,38 @@
+#ifndef __PYRO_TEST_STUB_FREERTOS_H__
+#define __PYRO_TEST_STUB_FREERTOS_H__
+
+/*
+ * Host stand-in for FreeRTOS.h: the types the Core/Memory headers name in
+ * their declarations, and the port/config macros the region heap uses.
+ * Nothing here schedules or locks; see task.h for the scheduler lock.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE  ((BaseType_t)1)
+
+/* CM7 port and Core/Inc/FreeRTOSConfig.h, without the heap trace hooks */
+#define portBYTE_ALIGNMENT 8
+#define configUSE_MALLOC_FAILED_HOOK 0
+#define configASSERT(x) assert(x)
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC(pvAddress, uiSize)
+#define traceFREE(pvAddress, uiSize)
+
+typedef struct xHeapStats
+{
+    size_t xAvailableHeapSpaceInBytes;
+    size_t xSizeOfLargestFreeBlockInBytes;
+    size_t xSizeOfSmallestFreeBlockInBytes;
+    size_t xNumberOfFreeBlocks;
+    size_t xMinimumEverFreeBytesRemaining;
+    size_t xNumberOfSuccessfulAllocations;
+    size_t xNumberOfSuccessfulFrees;
+} HeapStats_t;
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef __PYRO_TEST_STUB_STM32H7XX_H__
+#define __PYRO_TEST_STUB_STM32H7XX_H__
+
+/*
+ * Host stand-in for the device header: a D-cache that is present, an SCB
+ * with only CCR, and the CMSIS maintenance calls by address. The test that
+ * includes this defines the SCB instance and the calls, and records them.
+ */
+#include <stdint.h>
+
+#define __DCACHE_PRESENT 1U
+
+typedef struct
+{
+    volatile uint32_t CCR;
+} SCB_Type;
+
+#define SCB_CCR_DC_Pos 16U
+#define SCB_CCR_DC_Msk (1UL << SCB_CCR_DC_Pos)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern SCB_Type pyro_stub_scb;
+#define SCB (&pyro_stub_scb)
+
+void SCB_CleanDCache_by_Addr(uint32_t *addr, int32_t dsize);
+void SCB_InvalidateDCache_by_Addr(void *addr, int32_t dsize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
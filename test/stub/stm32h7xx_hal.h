@@ -0,0 +1,28 @@
+#ifndef __PYRO_TEST_STUB_STM32H7XX_HAL_H__
+#define __PYRO_TEST_STUB_STM32H7XX_HAL_H__
+
+/*
+ * Host stand-in for the HAL header: the device stub plus PRIMASK intrinsics
+ * that do nothing, for code that only masks interrupts around its own state.
+ */
+#include "stm32h7xx.h"
+
+static inline void __disable_irq(void)
+{
+}
+
+static inline void __enable_irq(void)
+{
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    (void)primask;
+}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef __PYRO_TEST_STUB_TASK_H__
+#define __PYRO_TEST_STUB_TASK_H__
+
+/*
+ * Host stand-in for task.h: the scheduler lock the heaps take. The test that
+ * links heap code defines both, usually to count nesting.
+ */
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+// pyro_tlsf against the heap_4 DMA heap it replaced, on the same workload.
+//
+// Each run replays one random malloc/free sequence on both allocators. A third
+// of the requests want 32-byte (cache line) alignment, as dma_buffer_t does:
+// TLSF serves them with memalign, heap_4 by over-allocating a line, which is
+// what dma_buffer_t did before. Reports per-op latency percentiles, failed
+// requests and the largest free block left at the end.
+//
+//   tlsf_bench [ops]
+
+#include "heap_4_ref.h"
+#include "pyro_tlsf.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr size_t LINE = 32;
+
+struct result_t
+{
+    std::vector<uint32_t> alloc_ns;
+    std::vector<uint32_t> free_ns;
+    size_t failed  = 0;
+    size_t largest = 0;
+};
+
+struct tlsf_heap_t
+{
+    pyro_tlsf_t tlsf;
+    explicit tlsf_heap_t(std::vector<uint8_t> &pool)
+    {
+        pyro_tlsf_init(&tlsf, pool.data(), pool.size());
+    }
+    void *alloc(const size_t size, const bool aligned, void *&raw)
+    {
+        raw = aligned ? pyro_tlsf_memalign(&tlsf, LINE, size)
+                      : pyro_tlsf_malloc(&tlsf, size);
+        return raw;
+    }
+    void release(void *raw)
+    {
+        pyro_tlsf_free(&tlsf, raw);
+    }
+    size_t largest()
+    {
+        return pyro_tlsf_largest_free(&tlsf);
+    }
+};
+
+struct heap_4_t
+{
+    heap_4_ref_t heap;
+    explicit heap_4_t(std::vector<uint8_t> &pool)
+    {
+        heap_4_ref_init(&heap, pool.data(), pool.size());
+    }
+    void *alloc(const size_t size, const bool aligned, void *&raw)
+    {
+        raw = heap_4_ref_malloc(&heap, aligned ? size + LINE - 1 : size);
+        if (!aligned || nullptr == raw)
+        {
+            return raw;
+        }
+        return reinterpret_cast<void *>(
+            (reinterpret_cast<uintptr_t>(raw) + LINE - 1) & ~uintptr_t{LINE - 1});
+    }
+    void release(void *raw)
+    {
+        heap_4_ref_free(&heap, raw);
+    }
+    size_t largest()
+    {
+        return heap_4_ref_largest_free(&heap);
+    }
+};
+
+size_t random_size(std::mt19937 &rng, const size_t pool)
+{
+    const uint32_t r = rng() % 100;
+    if (r < 75)
+    {
+        return 8 + rng() % 120;
+    }
+    if (r < 97)
+    {
+        return 128 + rng() % 896;
+    }
+    return 1024 + rng() % (pool / 8);
+}
+
+uint32_t elapsed_ns(const std::chrono::steady_clock::time_point t0)
+{
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0)
+            .count());
+}
+
+template <typename heap_t>
+result_t run(const size_t pool_size, const int ops, const uint32_t seed)
+{
+    std::vector<uint8_t> pool(pool_size);
+    heap_t heap(pool);
+    std::mt19937 rng(seed);
+    std::vector<void *> live;
+    result_t res;
+    res.alloc_ns.reserve(ops);
+    res.free_ns.reserve(ops);
+
+    for (int op = 0; op < ops; op++)
+    {
+        // Alternate fill and drain phases so the free list fragments
+        const uint32_t alloc_pct = (op / 4096) % 2 ? 45 : 60;
+        if (live.empty() || rng() % 100 < alloc_pct)
+        {
+            const size_t size  = random_size(rng, pool_size);
+            const bool aligned = rng() % 3 == 0;
+            void *raw          = nullptr;
+            const auto t0      = std::chrono::steady_clock::now();
+            void *p            = heap.alloc(size, aligned, raw);
+            res.alloc_ns.push_back(elapsed_ns(t0));
+            if (nullptr == p)
+            {
+                res.failed++;
+                continue;
+            }
+            live.push_back(raw);
+        }
+        else
+        {
+            const size_t i = rng() % live.size();
+            const auto t0  = std::chrono::steady_clock::now();
+            heap.release(live[i]);
+            res.free_ns.push_back(elapsed_ns(t0));
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+    res.largest = heap.largest();
+    return res;
+}
+
+uint32_t percentile(std::vector<uint32_t> &v, const double p)
+{
+    if (v.empty())
+    {
+        return 0;
+    }
+    const size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+void report(const char *name, result_t &r, const int ops)
+{
+    std::printf("  %-7s malloc p50 %4u p99 %5u max %6u | free p50 %4u p99 %5u "
+                "max %6u | failed %5.2f%% | largest free %zu\n",
+                name, percentile(r.alloc_ns, 0.5), percentile(r.alloc_ns, 0.99),
+                percentile(r.alloc_ns, 1.0), percentile(r.free_ns, 0.5),
+                percentile(r.free_ns, 0.99), percentile(r.free_ns, 1.0),
+                100.0 * r.failed / ops, r.largest);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int ops = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    // 16 KiB is PYRO_MEM_D2_HEAP_SIZE; the larger pool holds more blocks and
+    // shows how the first-fit walk scales
+    for (const size_t pool : {size_t{16 * 1024}, size_t{256 * 1024}})
+    {
+        std::printf("pool %zu B, %d ops (ns per op)\n", pool, ops);
+        result_t h4 = run<heap_4_t>(pool, ops, 1);
+        result_t tl = run<tlsf_heap_t>(pool, ops, 1);
+        report("heap_4", h4, ops);
+        report("tlsf", tl, ops);
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "pyro_tlsf.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr size_t POOL_SIZE = 256 * 1024;
+
+struct live_t
+{
+    uint8_t *ptr;
+    size_t size;
+    uint8_t tag;
+};
+
+class tlsf_fixture_t : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        _pool.resize(POOL_SIZE + 64);
+        ASSERT_EQ(0, pyro_tlsf_init(&_tlsf, _pool.data() + 3, POOL_SIZE));
+        _initial = _tlsf.stats.free_bytes;
+    }
+
+    bool in_pool(const uint8_t *p, const size_t size) const
+    {
+        return p >= _tlsf.pool_start && p + size <= _tlsf.pool_end;
+    }
+
+    std::vector<uint8_t> _pool;
+    pyro_tlsf_t _tlsf;
+    size_t _initial = 0;
+};
+
+class tlsf_fuzz_t : public tlsf_fixture_t,
+                    public ::testing::WithParamInterface<uint32_t>
+{
+};
+
+// Mostly small blocks with a tail of large ones, like the DMA heap sees
+size_t random_size(std::mt19937 &rng)
+{
+    const uint32_t r = rng() % 100;
+    if (r < 70)
+    {
+        return 1 + rng() % 64;
+    }
+    if (r < 95)
+    {
+        return 65 + rng() % 2048;
+    }
+    return 2049 + rng() % 30000;
+}
+
+bool pattern_intact(const live_t &b)
+{
+    for (size_t i = 0; i < b.size; i++)
+    {
+        if (b.ptr[i] != static_cast<uint8_t>(b.tag + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_F(tlsf_fixture_t, InitRejectsTinyPool)
+{
+    pyro_tlsf_t t;
+    uint8_t small[16];
+    EXPECT_EQ(-1, pyro_tlsf_init(&t, small, sizeof(small)));
+    EXPECT_EQ(-1, pyro_tlsf_init(&t, _pool.data(), 0));
+}
+
+TEST_F(tlsf_fixture_t, RejectsBadRequests)
+{
+    EXPECT_EQ(nullptr, pyro_tlsf_malloc(&_tlsf, 0));
+    EXPECT_EQ(nullptr, pyro_tlsf_malloc(&_tlsf, POOL_SIZE));
+    EXPECT_EQ(nullptr, pyro_tlsf_memalign(&_tlsf, 48, 16));
+    EXPECT_EQ(0u, pyro_tlsf_usable_size(nullptr));
+    pyro_tlsf_free(&_tlsf, nullptr);
+    EXPECT_EQ(0, pyro_tlsf_check(&_tlsf));
+    EXPECT_EQ(_initial, _tlsf.stats.free_bytes);
+}
+
+TEST_F(tlsf_fixture_t, DoubleFreeIsIgnored)
+{
+    void *a = pyro_tlsf_malloc(&_tlsf, 100);
+    void *b = pyro_tlsf_malloc(&_tlsf, 100);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    pyro_tlsf_free(&_tlsf, a);
+    pyro_tlsf_free(&_tlsf, a);
+    EXPECT_EQ(0, pyro_tlsf_check(&_tlsf));
+    EXPECT_EQ(1u, _tlsf.stats.frees);
+    pyro_tlsf_free(&_tlsf, b);
+    EXPECT_EQ(0, pyro_tlsf_check(&_tlsf));
+    EXPECT_EQ(1u, _tlsf.stats.free_blocks);
+}
+
+// Fill the pool with one size until it runs dry, then free in random order:
+// every block must merge back into the single initial one
+TEST_F(tlsf_fixture_t, ExhaustAndMergeBack)
+{
+    std::mt19937 rng(7);
+    std::vector<void *> blocks;
+    while (void *p = pyro_tlsf_malloc(&_tlsf, 200))
+    {
+        blocks.push_back(p);
+    }
+    ASSERT_GT(blocks.size(), POOL_SIZE / 256);
+    EXPECT_LT(_tlsf.stats.free_bytes, 256u);
+    EXPECT_EQ(0, pyro_tlsf_check(&_tlsf));
+
+    std::shuffle(blocks.begin(), blocks.end(), rng);
+    for (void *p : blocks)
+    {
+        pyro_tlsf_free(&_tlsf, p);
+        ASSERT_EQ(0, pyro_tlsf_check(&_tlsf));
+    }
+    EXPECT_EQ(1u, _tlsf.stats.free_blocks);
+    EXPECT_EQ(_initial, pyro_tlsf_largest_free(&_tlsf));
+}
+
+// Random malloc / memalign / free with a full pool walk after every op. Each
+// block is filled with its own pattern, checked again before it is freed, so
+// overlapping blocks or a header written into user data show up too
+TEST_P(tlsf_fuzz_t, CheckAfterEveryOp)
+{
+    constexpr int OPS = 60000;
+    std::mt19937 rng(GetParam());
+    std::vector<live_t> live;
+    size_t failed = 0;
+
+    for (int op = 0; op < OPS; op++)
+    {
+        // Drift between filling the pool and draining it
+        const uint32_t alloc_pct = (op / 5000) % 2 ? 40 : 65;
+        if (live.empty() || rng() % 100 < alloc_pct)
+        {
+            const size_t size = random_size(rng);
+            size_t align      = 0;
+            uint8_t *p;
+            if (rng() % 3 == 0)
+            {
+                align = size_t{8} << (rng() % 10);
+                p     = static_cast<uint8_t *>(pyro_tlsf_memalign(&_tlsf, align, size));
+            }
+            else
+            {
+                p = static_cast<uint8_t *>(pyro_tlsf_malloc(&_tlsf, size));
+            }
+
+            if (nullptr == p)
+            {
+                failed++;
+            }
+            else
+            {
+                ASSERT_TRUE(in_pool(p, size)) << "op " << op;
+                ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(p) % PYRO_TLSF_ALIGN);
+                if (align)
+                {
+                    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(p) % align) << "op " << op;
+                }
+                ASSERT_GE(pyro_tlsf_usable_size(p), size);
+                live_t b = {p, size, static_cast<uint8_t>(rng())};
+                for (size_t i = 0; i < size; i++)
+                {
+                    p[i] = static_cast<uint8_t>(b.tag + i);
+                }
+                live.push_back(b);
+            }
+        }
+        else
+        {
+            const size_t i = rng() % live.size();
+            ASSERT_TRUE(pattern_intact(live[i])) << "op " << op;
+            pyro_tlsf_free(&_tlsf, live[i].ptr);
+            live[i] = live.back();
+            live.pop_back();
+        }
+
+        ASSERT_EQ(0, pyro_tlsf_check(&_tlsf)) << "op " << op;
+        ASSERT_EQ(live.size(), _tlsf.stats.allocations - _tlsf.stats.frees);
+    }
+
+    // The workload must actually have hit a full heap
+    EXPECT_GT(failed, 0u);
+    EXPECT_LE(_tlsf.stats.min_ever_free_bytes, _tlsf.stats.free_bytes);
+
+    for (const live_t &b : live)
+    {
+        ASSERT_TRUE(pattern_intact(b));
+        pyro_tlsf_free(&_tlsf, b.ptr);
+        ASSERT_EQ(0, pyro_tlsf_check(&_tlsf));
+    }
+    EXPECT_EQ(1u, _tlsf.stats.free_blocks);
+    EXPECT_EQ(_initial, _tlsf.stats.free_bytes);
+    EXPECT_EQ(_initial, pyro_tlsf_largest_free(&_tlsf));
+    EXPECT_EQ(_initial, pyro_tlsf_smallest_free(&_tlsf));
+}
+
+INSTANTIATE_TEST_SUITE_P(seeds, tlsf_fuzz_t, ::testing::Range(1u, 7u));
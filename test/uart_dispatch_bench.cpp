@@ -0,0 +1,277 @@
+// UART RX dispatch: the delegate_t instance/callback tables against the
+// std::map/std::function dispatch they replaced.
+//
+// Four UARTs as on the board (uart1, uart5, uart7, uart10). uart1 carries
+// the referee and VT03 handlers, the others one RC/debug handler each; a
+// handler only consumes a buffer that starts with its own header byte. A
+// trace of RX events picks a UART and a header at random. Also times one
+// add/remove of a callback, which used to allocate.
+//
+//   uart_dispatch_bench [events]
+
+#include "FreeRTOS.h"
+#include "delegate.h"
+#include "uart_dispatch_ref.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr uint8_t UART_NUM = 4;
+constexpr uint16_t BUF_LEN = 64;
+
+// A protocol handler: consumes buffers that start with its header byte
+struct handler_t
+{
+    uint8_t header;
+    uint32_t frames = 0;
+
+    bool on_rx(uint8_t *p, uint16_t size, BaseType_t &woken)
+    {
+        if (size == 0 || p[0] != header)
+        {
+            return false;
+        }
+        frames++;
+        woken |= static_cast<BaseType_t>(frames & 1);
+        return true;
+    }
+
+    bool on_rx_by_value(uint8_t *p, uint16_t size, BaseType_t woken)
+    {
+        return on_rx(p, size, woken);
+    }
+};
+
+/* The current dispatch, as in pyro_uart_drv.cpp */
+struct table_dispatch_t
+{
+    using rx_event_func =
+        pyro::delegate_t<bool(uint8_t *p, uint16_t size, BaseType_t &woken)>;
+    static constexpr uint8_t MAX_RX_CALLBACK_NUM = 4;
+
+    struct rx_event_callback_t
+    {
+        uint32_t owner;
+        rx_event_func func;
+    };
+
+    struct drv_t
+    {
+        std::array<rx_event_callback_t, MAX_RX_CALLBACK_NUM> _rx_callbacks{};
+        uint8_t _rx_callback_num{};
+        uint8_t *rx_buf[2];
+        uint8_t rx_buf_switch{};
+
+        bool add_rx_event_callback(const rx_event_func &func,
+                                   const uint32_t owner)
+        {
+            if (_rx_callback_num >= MAX_RX_CALLBACK_NUM)
+            {
+                return false;
+            }
+            _rx_callbacks[_rx_callback_num].owner = owner;
+            _rx_callbacks[_rx_callback_num].func  = func;
+            _rx_callback_num++;
+            return true;
+        }
+
+        bool remove_rx_event_callback(const uint32_t owner)
+        {
+            for (uint8_t i = 0; i < _rx_callback_num; i++)
+            {
+                if (_rx_callbacks[i].owner == owner)
+                {
+                    for (uint8_t j = i; j + 1 < _rx_callback_num; j++)
+                    {
+                        _rx_callbacks[j] = _rx_callbacks[j + 1];
+                    }
+                    _rx_callback_num--;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void handle_rx_event(const uint16_t size, BaseType_t &woken)
+        {
+            for (uint8_t i = 0; i < _rx_callback_num; i++)
+            {
+                if (_rx_callbacks[i].func(rx_buf[rx_buf_switch], size, woken))
+                {
+                    rx_buf_switch ^= 0x01U;
+                    break;
+                }
+            }
+        }
+    };
+
+    const void *handles[UART_NUM];
+    std::array<drv_t *, UART_NUM> _instances{};
+
+    int8_t which_of(const void *huart) const
+    {
+        if (huart == handles[0])
+            return 0;
+        if (huart == handles[1])
+            return 1;
+        if (huart == handles[2])
+            return 2;
+        if (huart == handles[3])
+            return 3;
+        return -1;
+    }
+
+    void rx_event(const void *huart, const uint16_t Size)
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        const int8_t which                  = which_of(huart);
+        if (which >= 0 && _instances[which])
+        {
+            _instances[which]->handle_rx_event(Size,
+                                               xHigherPriorityTaskWoken);
+        }
+    }
+};
+
+struct event_t
+{
+    uint8_t uart;
+    uint8_t header;
+};
+
+// Handlers per UART; uart1 offers the buffer to the referee first
+constexpr uint8_t HEADERS[UART_NUM][2] = {
+    {0xA5, 0xA9}, // referee, VT03
+    {0x0F, 0x00}, // DR16
+    {0x55, 0x00}, // JCOM
+    {0x5A, 0x00}, // VOFA
+};
+constexpr uint8_t HANDLER_NUM[UART_NUM] = {2, 1, 1, 1};
+
+double ns_since(const std::chrono::steady_clock::time_point t0,
+                const size_t n)
+{
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - t0)
+               .count() /
+           static_cast<double>(n);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t events =
+        argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 20000000;
+    std::mt19937 rng(1);
+
+    // Fake HAL handles and one pair of RX buffers per UART, both dispatchers
+    // read the same memory
+    int hal_handles[UART_NUM];
+    std::array<std::array<std::array<uint8_t, BUF_LEN>, 2>, UART_NUM> bufs{};
+    std::vector<handler_t> handlers;
+    for (uint8_t u = 0; u < UART_NUM; u++)
+    {
+        for (uint8_t h = 0; h < HANDLER_NUM[u]; h++)
+        {
+            handlers.push_back(handler_t{HEADERS[u][h]});
+        }
+    }
+
+    uart_dispatch_ref_t ref;
+    std::array<uart_dispatch_ref_t::drv_t, UART_NUM> ref_drv{};
+    table_dispatch_t table;
+    std::array<table_dispatch_t::drv_t, UART_NUM> table_drv{};
+    for (uint8_t u = 0, k = 0; u < UART_NUM; u++)
+    {
+        ref_drv[u].rx_buf[0]   = bufs[u][0].data();
+        ref_drv[u].rx_buf[1]   = bufs[u][1].data();
+        table_drv[u].rx_buf[0] = bufs[u][0].data();
+        table_drv[u].rx_buf[1] = bufs[u][1].data();
+        ref.uart_map[&hal_handles[u]] = &ref_drv[u];
+        table.handles[u]              = &hal_handles[u];
+        table._instances[u]           = &table_drv[u];
+        for (uint8_t h = 0; h < HANDLER_NUM[u]; h++, k++)
+        {
+            handler_t *obj = &handlers[k];
+            ref_drv[u].add_rx_event_callback(
+                [obj](uint8_t *p, uint16_t size, BaseType_t woken) {
+                    return obj->on_rx_by_value(p, size, woken);
+                },
+                k);
+            table_drv[u].add_rx_event_callback(
+                table_dispatch_t::rx_event_func::bind<handler_t,
+                                                      &handler_t::on_rx>(obj),
+                k);
+        }
+    }
+
+    std::vector<event_t> trace(events);
+    for (event_t &e : trace)
+    {
+        e.uart   = static_cast<uint8_t>(rng() % UART_NUM);
+        e.header = HEADERS[e.uart][rng() % HANDLER_NUM[e.uart]];
+    }
+
+    auto replay = [&](auto &dispatch, auto &drvs) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (const event_t &e : trace)
+        {
+            auto &drv                        = drvs[e.uart];
+            drv.rx_buf[drv.rx_buf_switch][0] = e.header;
+            dispatch.rx_event(&hal_handles[e.uart], BUF_LEN);
+        }
+        return ns_since(t0, trace.size());
+    };
+
+    std::printf("%zu RX events over %u UARTs (ns per event)\n", events,
+                UART_NUM);
+    const double ref_ns   = replay(ref, ref_drv);
+    const double table_ns = replay(table, table_drv);
+    std::printf("  dispatch     map+std::function %6.2f | table+delegate_t "
+                "%6.2f\n",
+                ref_ns, table_ns);
+
+    // Register and unregister a third handler on uart1, as a module that
+    // comes and goes would
+    const size_t churn = events / 10;
+    handler_t extra{0x77};
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < churn; i++)
+    {
+        ref_drv[0].add_rx_event_callback(
+            [&extra](uint8_t *p, uint16_t size, BaseType_t woken) {
+                return extra.on_rx_by_value(p, size, woken);
+            },
+            0xFF);
+        ref_drv[0].remove_rx_event_callback(0xFF);
+    }
+    const double ref_reg = ns_since(t0, churn);
+    t0                   = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < churn; i++)
+    {
+        table_drv[0].add_rx_event_callback(
+            table_dispatch_t::rx_event_func::bind<handler_t,
+                                                  &handler_t::on_rx>(&extra),
+            0xFF);
+        table_drv[0].remove_rx_event_callback(0xFF);
+    }
+    const double table_reg = ns_since(t0, churn);
+    std::printf("  add+remove   map+std::function %6.2f | table+delegate_t "
+                "%6.2f\n",
+                ref_reg, table_reg);
+
+    uint64_t frames = 0;
+    for (const handler_t &h : handlers)
+    {
+        frames += h.frames;
+    }
+    // Every event is consumed once by each dispatcher
+    return frames == 2 * events ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+#include "pyro_uart_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr uint16_t RING_SIZE = 64;
+
+// Circular DMA into a ring: the head follows NDTR, and the HAL reports HT at
+// half the ring, TC at its end (position == size) and IDLE at the head
+struct dma_sim_t
+{
+    std::vector<uint8_t> ring = std::vector<uint8_t>(RING_SIZE);
+    uint16_t head             = 0;
+    uint8_t next              = 0;
+    std::vector<uint8_t> stream;
+
+    // Writes `n` bytes and returns the HT/TC positions crossed on the way
+    std::vector<uint16_t> write(const size_t n)
+    {
+        std::vector<uint16_t> events;
+        for (size_t i = 0; i < n; i++)
+        {
+            ring[head] = next;
+            stream.push_back(next++);
+            head++;
+            if (RING_SIZE / 2 == head)
+            {
+                events.push_back(head);
+            }
+            if (RING_SIZE == head)
+            {
+                events.push_back(head);
+                head = 0;
+            }
+        }
+        return events;
+    }
+};
+
+struct uart_ring_fixture_t : ::testing::Test
+{
+    dma_sim_t dma;
+    pyro::uart_rx_ring_t ring;
+    std::vector<uint8_t> received;
+
+    void SetUp() override
+    {
+        ring.attach(dma.ring.data(), RING_SIZE);
+    }
+
+    pyro::uart_rx_span_t publish(const uint16_t head)
+    {
+        const pyro::uart_rx_span_t fresh = ring.publish(head);
+        for (uint16_t i = 0; i < fresh.total(); i++)
+        {
+            received.push_back(fresh[i]);
+        }
+        return fresh;
+    }
+
+    // Writes `n` bytes, publishing each HT/TC as the DMA crosses it, then
+    // an IDLE
+    void burst(const size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            for (const uint16_t pos : dma.write(1))
+            {
+                publish(pos);
+            }
+        }
+        publish(dma.head);
+    }
+};
+} // namespace
+
+TEST_F(uart_ring_fixture_t, ContiguousEventReturnsOnePiece)
+{
+    dma.write(10);
+    const pyro::uart_rx_span_t fresh = publish(dma.head);
+    EXPECT_EQ(dma.ring.data(), fresh.data[0]);
+    EXPECT_EQ(10u, fresh.size[0]);
+    EXPECT_EQ(0u, fresh.size[1]);
+    EXPECT_EQ(10u, ring.tail());
+    EXPECT_EQ(dma.stream, received);
+}
+
+TEST_F(uart_ring_fixture_t, RepeatedHeadIsEmpty)
+{
+    burst(10);
+    EXPECT_EQ(0u, publish(dma.head).total());
+    EXPECT_EQ(10u, ring.total());
+}
+
+TEST_F(uart_ring_fixture_t, WrapGivesTwoPieces)
+{
+    dma.write(RING_SIZE - 3);
+    publish(dma.head);
+    dma.write(8);
+    const pyro::uart_rx_span_t fresh = publish(dma.head);
+    ASSERT_EQ(8u, fresh.total());
+    EXPECT_EQ(dma.ring.data() + RING_SIZE - 3, fresh.data[0]);
+    EXPECT_EQ(3u, fresh.size[0]);
+    EXPECT_EQ(dma.ring.data(), fresh.data[1]);
+    EXPECT_EQ(5u, fresh.size[1]);
+    EXPECT_EQ(dma.stream, received);
+}
+
+TEST_F(uart_ring_fixture_t, TcPublishesUpToTheRingEnd)
+{
+    burst(40);
+    dma.write(RING_SIZE - 40);
+    const pyro::uart_rx_span_t fresh = publish(RING_SIZE);
+    EXPECT_EQ(RING_SIZE - 40u, fresh.size[0]);
+    EXPECT_EQ(0u, fresh.size[1]);
+    EXPECT_EQ(0u, ring.tail());
+
+    // The IDLE that follows at the same position adds nothing
+    EXPECT_EQ(0u, publish(dma.head).total());
+    EXPECT_EQ(dma.stream, received);
+}
+
+TEST_F(uart_ring_fixture_t, ExactlyFullRingIsPublishedWhole)
+{
+    // HT missed: the TC at the end is the first event since position 0
+    dma.write(RING_SIZE);
+    const pyro::uart_rx_span_t fresh = publish(RING_SIZE);
+    EXPECT_EQ(dma.ring.data(), fresh.data[0]);
+    EXPECT_EQ(RING_SIZE, fresh.size[0]);
+    EXPECT_EQ(0u, fresh.size[1]);
+    EXPECT_EQ(0u, ring.tail());
+    EXPECT_EQ(dma.stream, received);
+}
+
+TEST_F(uart_ring_fixture_t, FullLapBetweenEventsIsLost)
+{
+    // Without HT/TC a lap lands on the old tail and cannot be seen; the
+    // stream continues from the new head and total() falls short by a ring
+    burst(10);
+    dma.write(RING_SIZE);
+    EXPECT_EQ(0u, publish(dma.head).total());
+    burst(5);
+    EXPECT_EQ(15u, ring.total());
+    EXPECT_EQ(dma.stream.size() - RING_SIZE, received.size());
+    EXPECT_TRUE(std::equal(received.end() - 5, received.end(),
+                           dma.stream.end() - 5));
+}
+
+TEST_F(uart_ring_fixture_t, OverrunPastTheTailKeepsTheNewestBytes)
+{
+    // A lap and a bit: only head - tail is seen, and it holds the newest data
+    burst(10);
+    dma.write(RING_SIZE + 6);
+    const pyro::uart_rx_span_t fresh = publish(dma.head);
+    ASSERT_EQ(6u, fresh.total());
+    for (uint16_t i = 0; i < 6; i++)
+    {
+        EXPECT_EQ(dma.stream[dma.stream.size() - 6 + i], fresh[i]);
+    }
+}
+
+TEST_F(uart_ring_fixture_t, RandomBurstsWithHtTcIdleKeepTheStream)
+{
+    std::mt19937 rng(0xD3A);
+    for (int i = 0; i < 5000; i++)
+    {
+        // HT/TC fire at least every half ring, whatever the burst length
+        burst(1 + rng() % (3 * RING_SIZE));
+    }
+    EXPECT_EQ(dma.stream.size(), ring.total());
+    EXPECT_EQ(dma.stream, received);
+}
+
+TEST_F(uart_ring_fixture_t, SpanCopyAndIndexCrossTheWrap)
+{
+    burst(RING_SIZE - 4);
+    dma.write(10);
+    const pyro::uart_rx_span_t fresh = publish(dma.head);
+    ASSERT_EQ(4u, fresh.size[0]);
+    ASSERT_EQ(6u, fresh.size[1]);
+
+    uint8_t out[16] = {};
+    EXPECT_EQ(6u, fresh.copy(out, 2, 6));
+    for (uint16_t i = 0; i < 6; i++)
+    {
+        EXPECT_EQ(fresh[2 + i], out[i]);
+    }
+    EXPECT_EQ(2u, fresh.copy(out, 8, 16));
+    EXPECT_EQ(0u, fresh.copy(out, 10, 16));
+}
+
+TEST_F(uart_ring_fixture_t, OversizedIdleChunkIsSplit)
+{
+    // An IDLE frame of 3.5 RX buffers that wraps the ring end: every piece
+    // is at most one buffer, in place unless it straddles the wrap
+    constexpr uint16_t RX_BUF = 14;
+    burst(RING_SIZE - 20);
+    const uint16_t frame_start = ring.tail();
+    dma.write(RX_BUF * 3 + RX_BUF / 2);
+    publish(dma.head);
+    const pyro::uart_rx_span_t frame = ring.span(frame_start, ring.tail());
+    ASSERT_EQ(RX_BUF * 3 + RX_BUF / 2, frame.total());
+
+    uint8_t scratch[RX_BUF] = {};
+    std::vector<uint8_t> joined;
+    std::vector<uint16_t> sizes;
+    int gathered = 0;
+    for (uint16_t offset = 0; offset < frame.total();)
+    {
+        const uint8_t *p = nullptr;
+        const uint16_t n = frame.chunk(offset, RX_BUF, scratch, p);
+        ASSERT_GT(n, 0u);
+        if (scratch == p)
+        {
+            gathered++;
+        }
+        else
+        {
+            EXPECT_TRUE(p >= dma.ring.data() &&
+                        p + n <= dma.ring.data() + RING_SIZE);
+        }
+        joined.insert(joined.end(), p, p + n);
+        sizes.push_back(n);
+        offset += n;
+    }
+    EXPECT_EQ(std::vector<uint16_t>({RX_BUF, RX_BUF, RX_BUF, RX_BUF / 2}),
+              sizes);
+    EXPECT_EQ(1, gathered);
+    EXPECT_TRUE(std::equal(joined.begin(), joined.end(),
+                           dma.stream.end() - frame.total()));
+
+    const uint8_t *p = nullptr;
+    EXPECT_EQ(0u, frame.chunk(frame.total(), RX_BUF, scratch, p));
+}
+
+TEST(uart_rx_ring_t, DetachedRingPublishesNothing)
+{
+    pyro::uart_rx_ring_t ring;
+    EXPECT_FALSE(ring.attached());
+    EXPECT_EQ(0u, ring.publish(10).total());
+    EXPECT_EQ(0u, ring.total());
+}